@@ -12,8 +12,39 @@ target_include_directories(usermod_ucrypto INTERFACE
     ${CMAKE_CURRENT_LIST_DIR}
 )
 
+# Pass -DUCRYPTO_STATS=1 to count operations per API, read with _crypto.stats().
+if(NOT DEFINED UCRYPTO_STATS)
+    set(UCRYPTO_STATS 0)
+endif()
+
+# Pass -DUCRYPTO_HW=mbedtls on the ESP32 port to run exptmod and the P-192 / P-256
+# scalar multiplications on the RSA and ECC peripherals through ESP-IDF's mbedtls,
+# or the path of a source implementing moducrypto_hw.h for other hardware.
+if(NOT DEFINED UCRYPTO_HW)
+    set(UCRYPTO_HW "")
+endif()
+
+if(UCRYPTO_HW STREQUAL "mbedtls")
+    target_sources(usermod_ucrypto INTERFACE
+        ${CMAKE_CURRENT_LIST_DIR}/moducrypto_hw_mbedtls.c
+    )
+    target_link_libraries(usermod_ucrypto INTERFACE idf::mbedtls)
+elseif(NOT UCRYPTO_HW STREQUAL "")
+    target_sources(usermod_ucrypto INTERFACE
+        ${UCRYPTO_HW}
+    )
+endif()
+
+if(UCRYPTO_HW STREQUAL "")
+    set(UCRYPTO_HW_ENABLED 0)
+else()
+    set(UCRYPTO_HW_ENABLED 1)
+endif()
+
 target_compile_definitions(usermod_ucrypto INTERFACE
     MICROPY_PY_UCRYPTO=1
+    MICROPY_PY_UCRYPTO_STATS=${UCRYPTO_STATS}
+    MICROPY_PY_UCRYPTO_HW=${UCRYPTO_HW_ENABLED}
 )
 
 # Link our INTERFACE library to the usermod target.
@@ -6,3 +6,14 @@ SRC_USERMOD += $(UCRYPTO_MOD_DIR)/tomsfastmath/tfm_mpi.c
 CFLAGS_USERMOD += -I$(UCRYPTO_MOD_DIR)
 
 CFLAGS_USERMOD += -DMICROPY_PY_UCRYPTO=1
+
+# Set UCRYPTO_STATS=1 to count operations per API, read with _crypto.stats().
+UCRYPTO_STATS ?= 0
+CFLAGS_USERMOD += -DMICROPY_PY_UCRYPTO_STATS=$(UCRYPTO_STATS)
+
+# Set UCRYPTO_HW to the source of a backend implementing moducrypto_hw.h, e.g. a PKA driver.
+UCRYPTO_HW ?=
+ifneq ($(UCRYPTO_HW),)
+SRC_USERMOD += $(UCRYPTO_HW)
+CFLAGS_USERMOD += -DMICROPY_PY_UCRYPTO_HW=1
+endif
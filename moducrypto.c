@@ -46,8 +46,12 @@
 #define ERROR_ODD_LEN MP_ERROR_TEXT("odd-length string")
 #define ERROR_NON_HEX MP_ERROR_TEXT("non-hex digit found")
 #define ERROR_ODD_MODULUS MP_ERROR_TEXT("'exptmod' need odd modulus, set 'safe' or use 'fast_pow'")
+#define ERROR_CRT_ODD_PRIMES MP_ERROR_TEXT("'exptmod_crt' need odd p and q")
+#define ERROR_EXPTMOD_VALUE MP_ERROR_TEXT("modulus must be positive, and the base invertible for a negative exponent")
 #define ERROR_NUM_BITS MP_ERROR_TEXT("number of bits to generate must be in range 16-4096, not %lu bits")
-#define ERROR_PRIME_LEN MP_ERROR_TEXT("Prime is %d, not %lu bits")
+#define ERROR_PRIME_TEST_ROUNDS MP_ERROR_TEXT("test rounds must not be negative, 0 picks the FIPS 186-4 count")
+#define ERROR_PRIME_SEARCH_START MP_ERROR_TEXT("start must be at least 4096 and at most half of FP_MAX_SIZE bits")
+#define ERROR_PRIME_SEARCH_SPAN MP_ERROR_TEXT("span must be in range 1-2^30")
 #define ERROR_EXPECTED_INT MP_ERROR_TEXT("expected a int, but %s found")
 #define ERROR_EXPECTED_SIGNATURES MP_ERROR_TEXT("expected two Signature's")
 #define ERROR_EXPECTED_CURVES MP_ERROR_TEXT("expected two Curve's")
@@ -56,6 +60,7 @@
 #define ERROR_EXPECTED_POINT_BUT MP_ERROR_TEXT("expected a Point, but %s found")
 #define ERROR_EXPECTED_STR_BYTES_BUT MP_ERROR_TEXT("expected a str/bytes, but %s found")
 #define ERROR_EXPECTED_POINT_AT_BUT MP_ERROR_TEXT("arg at index %d expected a Point, but %s found")
+#define ERROR_EXPECTED_PUBLIC_KEY_AT_BUT MP_ERROR_TEXT("arg at index %d expected a Point or PublicKey, but %s found")
 #define ERROR_EXPECTED_CURVE_AT_BUT MP_ERROR_TEXT("arg at index %d expected a Curve, but %s found")
 #define ERROR_EXPECTED_INT_AT_BUT MP_ERROR_TEXT("arg at index %d expected a int, but %s found")
 #define ERROR_EXPECTED_SIGNATURE_AT_BUT MP_ERROR_TEXT("arg at index %d expected a Signature, but %s found")
@@ -64,8 +69,271 @@
 #define ERROR_CURVE_OF_POINTS_NOT_EQUAL MP_ERROR_TEXT("curve of two Point's must be the same")
 #define ERROR_LEFT_EXPECTED_POINT MP_ERROR_TEXT("left must be a Point")
 #define ERROR_RIGHT_EXPECTED_INT MP_ERROR_TEXT("right must be a int")
+#define ERROR_EXPECTED_TERM_AT_BUT MP_ERROR_TEXT("term at index %d expected a (Point, int), but %s found")
+#define ERROR_BATCH_LENGTHS MP_ERROR_TEXT("sigs, digests and pubkeys must have the same length")
+#define ERROR_CURVE_ORDER_TOO_LARGE MP_ERROR_TEXT("curve order too large")
+#define ERROR_CURVE_FIELD_NOT_PRIME MP_ERROR_TEXT("square root needs p of the curve to be an odd prime")
+#define ERROR_RECOVERY_ID MP_ERROR_TEXT("no recovery id in v=%d")
+#define ERROR_RECOVER_FAILED MP_ERROR_TEXT("public key can not be recovered")
+#define ERROR_BUFFER_TOO_SMALL MP_ERROR_TEXT("buffer needs %u bytes, has %u")
+#define ERROR_INVALID_POINT_ENCODING MP_ERROR_TEXT("invalid point encoding")
+#define ERROR_INVALID_DER MP_ERROR_TEXT("invalid DER encoding")
+#define ERROR_DER_NOT_EC_KEY MP_ERROR_TEXT("not an EC key of a named curve")
+#define ERROR_DER_NO_CURVE MP_ERROR_TEXT("key names no curve, pass curve")
+#define ERROR_DER_CURVE MP_ERROR_TEXT("curve differs from the one the key names")
+#define ERROR_RSA_MODULUS MP_ERROR_TEXT("RSA modulus must be odd and at most half of FP_MAX_SIZE bits")
+#define ERROR_RSA_NOT_PRIVATE MP_ERROR_TEXT("not a private key")
+#define ERROR_RSA_MESSAGE_TOO_LONG MP_ERROR_TEXT("message too long")
+#define ERROR_RSA_INPUT_LENGTH MP_ERROR_TEXT("input must have the byte length of the modulus")
+#define ERROR_RSA_INPUT_RANGE MP_ERROR_TEXT("input out of range")
+#define ERROR_RSA_PADDING MP_ERROR_TEXT("invalid padding")
+#define ERROR_RSA_CRT_FAULT MP_ERROR_TEXT("RSA CRT result does not verify")
+#define ERROR_UNKNOWN_CURVE MP_ERROR_TEXT("unknown named curve")
+#define ERROR_JOB_ODD_MODULUS MP_ERROR_TEXT("'exptmod_start' need odd modulus")
+#define ERROR_JOB_STEPS MP_ERROR_TEXT("step needs at least 1 iteration")
+#define ERROR_JOB_NOT_DONE MP_ERROR_TEXT("job not done, call step until it returns True")
+#define ERROR_ECDH_PRIVATE_KEY MP_ERROR_TEXT("private key must be in range 1..q-1")
+#define ERROR_ECDH_PEER MP_ERROR_TEXT("peer public key is not a point of the curve, or of small order")
+#define ERROR_PUBLIC_KEY_INVALID MP_ERROR_TEXT("public key is not a point of the curve")
+#define ERROR_PUBLIC_KEY_CURVE MP_ERROR_TEXT("public key prepared on another curve")
+#define ERROR_PUBLIC_KEY_WINDOW MP_ERROR_TEXT("window must be in range %d..%d")
+#define ERROR_25519_LEN MP_ERROR_TEXT("%s must be 32 bytes, not %lu")
 #define ERROR_MEMORY MP_ERROR_TEXT("memory allocation failed, allocating %u bytes")
 
+#ifndef MICROPY_PY_UCRYPTO_STATS
+#define MICROPY_PY_UCRYPTO_STATS (0)
+#endif
+
+#if MICROPY_PY_UCRYPTO_STATS
+// Operation counters per top-level API, read with _crypto.stats().
+// A call that raises leaves its API current, the work until the next call is charged to it.
+enum
+{
+    UCRYPTO_STAT_CALLS,
+    UCRYPTO_STAT_CYCLES,
+    UCRYPTO_STAT_FP_MUL,
+    UCRYPTO_STAT_FP_SQR,
+    UCRYPTO_STAT_FP_MOD,
+    UCRYPTO_STAT_FP_REDUCE,
+    UCRYPTO_STAT_FP_INVMOD,
+    UCRYPTO_STAT_FP_EXPTMOD,
+    UCRYPTO_STAT_ALLOC_BYTES,
+    UCRYPTO_STAT_POINT_ADD,
+    UCRYPTO_STAT_POINT_DOUBLE,
+    UCRYPTO_STAT_HW_CALLS,
+    UCRYPTO_STAT_COUNT,
+};
+
+enum
+{
+    UCRYPTO_API_OTHER,
+    UCRYPTO_API_NUMBER,
+    UCRYPTO_API_PRIME,
+    UCRYPTO_API_RSA,
+    UCRYPTO_API_POINT,
+    UCRYPTO_API_SIGN,
+    UCRYPTO_API_VERIFY,
+    UCRYPTO_API_RECOVER,
+    UCRYPTO_API_COUNT,
+};
+
+static const qstr ucrypto_stat_names[UCRYPTO_STAT_COUNT] = {
+    MP_QSTR_calls,
+    MP_QSTR_cycles,
+    MP_QSTR_fp_mul,
+    MP_QSTR_fp_sqr,
+    MP_QSTR_fp_mod,
+    MP_QSTR_fp_reduce,
+    MP_QSTR_fp_invmod,
+    MP_QSTR_fp_exptmod,
+    MP_QSTR_alloc_bytes,
+    MP_QSTR_point_add,
+    MP_QSTR_point_double,
+    MP_QSTR_hw_calls,
+};
+
+static const qstr ucrypto_api_names[UCRYPTO_API_COUNT] = {
+    MP_QSTR_other,
+    MP_QSTR_number,
+    MP_QSTR_prime,
+    MP_QSTR_rsa,
+    MP_QSTR_point,
+    MP_QSTR_sign,
+    MP_QSTR_verify,
+    MP_QSTR_recover,
+};
+
+static uint64_t ucrypto_stats[UCRYPTO_API_COUNT][UCRYPTO_STAT_COUNT];
+static int ucrypto_stats_api = UCRYPTO_API_OTHER;
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define UCRYPTO_STATS_HAS_CYCLES (1)
+// DWT cycle counter of the Cortex-M, enabled on the first read
+static uint32_t ucrypto_cycles(void)
+{
+    volatile uint32_t *demcr = (volatile uint32_t *)0xE000EDFC;
+    volatile uint32_t *dwt_ctrl = (volatile uint32_t *)0xE0001000;
+    volatile uint32_t *dwt_cyccnt = (volatile uint32_t *)0xE0001004;
+    if ((*dwt_ctrl & 1) == 0)
+    {
+        *demcr |= 1UL << 24;
+        *dwt_cyccnt = 0;
+        *dwt_ctrl |= 1;
+    }
+    return *dwt_cyccnt;
+}
+#elif defined(__XTENSA__)
+#define UCRYPTO_STATS_HAS_CYCLES (1)
+static uint32_t ucrypto_cycles(void)
+{
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+}
+#elif defined(__x86_64__) || defined(__i386__)
+#define UCRYPTO_STATS_HAS_CYCLES (1)
+static uint32_t ucrypto_cycles(void)
+{
+    return (uint32_t)__builtin_ia32_rdtsc();
+}
+#else
+#define UCRYPTO_STATS_HAS_CYCLES (0)
+static uint32_t ucrypto_cycles(void)
+{
+    return 0;
+}
+#endif
+
+typedef struct _ucrypto_stats_scope_t
+{
+    int api;
+    uint32_t start;
+} ucrypto_stats_scope_t;
+
+static ucrypto_stats_scope_t ucrypto_stats_enter(int api)
+{
+    ucrypto_stats_scope_t scope = {ucrypto_stats_api, ucrypto_cycles()};
+    ucrypto_stats_api = api;
+    ucrypto_stats[api][UCRYPTO_STAT_CALLS]++;
+    return scope;
+}
+
+static void ucrypto_stats_leave(ucrypto_stats_scope_t *scope)
+{
+    // 32-bit counters wrap, a single call must stay below 2^32 cycles
+    ucrypto_stats[ucrypto_stats_api][UCRYPTO_STAT_CYCLES] += (uint32_t)(ucrypto_cycles() - scope->start);
+    ucrypto_stats_api = scope->api;
+}
+
+#define UCRYPTO_STATS_ADD(stat, n) (ucrypto_stats[ucrypto_stats_api][UCRYPTO_STAT_##stat] += (n))
+#define UCRYPTO_STATS_INC(stat) UCRYPTO_STATS_ADD(stat, 1)
+// charge the enclosing function to api, the previous API is restored on return
+#define UCRYPTO_STATS_API(api) \
+    ucrypto_stats_scope_t ucrypto_stats_scope __attribute__((cleanup(ucrypto_stats_leave))) = ucrypto_stats_enter(UCRYPTO_API_##api)
+
+// count the tfm calls made by this file, tfm_mpi.c itself is not instrumented
+#define fp_mul(a, b, c) (UCRYPTO_STATS_INC(FP_MUL), fp_mul(a, b, c))
+#define fp_sqr(a, b) (UCRYPTO_STATS_INC(FP_SQR), fp_sqr(a, b))
+#define fp_mod(a, b, c) (UCRYPTO_STATS_INC(FP_MOD), fp_mod(a, b, c))
+#define fp_montgomery_reduce(a, m, mp) (UCRYPTO_STATS_INC(FP_REDUCE), fp_montgomery_reduce(a, m, mp))
+#define fp_invmod(a, b, c) (UCRYPTO_STATS_INC(FP_INVMOD), fp_invmod(a, b, c))
+#define fp_exptmod(a, b, c, d) (UCRYPTO_STATS_INC(FP_EXPTMOD), fp_exptmod(a, b, c, d))
+#else
+#define UCRYPTO_STATS_ADD(stat, n) ((void)0)
+#define UCRYPTO_STATS_INC(stat) ((void)0)
+#define UCRYPTO_STATS_API(api)
+#endif
+
+/*
+    The long loops (exptmod, prime search, scalar multiplication) run with
+    the GIL released so that Python keeps running on the other core. Such a
+    loop allocates nothing but scratch blocks, which takes the GIL back (see
+    ec_scratch_get), and keeps the heap blocks it works on in a volatile
+    array with UCRYPTO_GIL_ROOTS, as a collection started from another thread
+    may see our stack but not our registers.
+*/
+#ifndef MICROPY_PY_UCRYPTO_RELEASE_GIL
+#define MICROPY_PY_UCRYPTO_RELEASE_GIL (1)
+#endif
+
+#if MICROPY_PY_THREAD && MICROPY_PY_THREAD_GIL && MICROPY_PY_UCRYPTO_RELEASE_GIL
+#define UCRYPTO_GIL_ROOTS(...) \
+    void *volatile ucrypto_gil_roots[] = {__VA_ARGS__}; \
+    (void)ucrypto_gil_roots
+#define UCRYPTO_GIL_EXIT() MP_THREAD_GIL_EXIT()
+#define UCRYPTO_GIL_ENTER() MP_THREAD_GIL_ENTER()
+#else
+#define UCRYPTO_GIL_ROOTS(...)
+#define UCRYPTO_GIL_EXIT()
+#define UCRYPTO_GIL_ENTER()
+#endif
+
+/*
+    Offloading to a hardware backend (moducrypto_hw.h), selected at build time
+    with UCRYPTO_HW. The backend gets the operands it was asked for only once
+    they are within the preconditions of moducrypto_hw.h, and whatever it
+    declines goes through tomsfastmath as before.
+*/
+#ifndef MICROPY_PY_UCRYPTO_HW
+#define MICROPY_PY_UCRYPTO_HW (0)
+#endif
+
+#if MICROPY_PY_UCRYPTO_HW
+#include "moducrypto_hw.h"
+
+// Y = G**X (mod P) on the hardware, false to compute it here
+static bool ucrypto_hw_exptmod_take(fp_int *G, fp_int *X, fp_int *P, fp_int *Y)
+{
+    if (G->sign != FP_ZPOS || X->sign != FP_ZPOS || P->sign != FP_ZPOS || fp_isodd(P) != FP_YES || fp_cmp(G, P) != FP_LT)
+    {
+        return false;
+    }
+    if (ucrypto_hw_exptmod(G, X, P, Y) != FP_OKAY)
+    {
+        return false;
+    }
+    UCRYPTO_STATS_INC(HW_CALLS);
+    return true;
+}
+
+// the same with the GIL released, for the callers that hold it
+static bool ucrypto_hw_exptmod_nogil(fp_int *G, fp_int *X, fp_int *P, fp_int *Y)
+{
+    UCRYPTO_GIL_ROOTS(G, X, P, Y);
+    UCRYPTO_GIL_EXIT();
+    bool done = ucrypto_hw_exptmod_take(G, X, P, Y);
+    UCRYPTO_GIL_ENTER();
+    return done;
+}
+
+static int ucrypto_fp_exptmod(fp_int *G, fp_int *X, fp_int *P, fp_int *Y)
+{
+    if (ucrypto_hw_exptmod_take(G, X, P, Y))
+    {
+        return FP_OKAY;
+    }
+    return fp_exptmod(G, X, P, Y);
+}
+
+static int ucrypto_fp_mulmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d)
+{
+    if (a->sign == FP_ZPOS && b->sign == FP_ZPOS && c->sign == FP_ZPOS && fp_cmp(a, c) == FP_LT && fp_cmp(b, c) == FP_LT &&
+        ucrypto_hw_mulmod(a, b, c, d) == FP_OKAY)
+    {
+        UCRYPTO_STATS_INC(HW_CALLS);
+        return FP_OKAY;
+    }
+    return fp_mulmod(a, b, c, d);
+}
+
+// every call of this file goes through the backend first
+#undef fp_exptmod
+#define fp_exptmod(a, b, c, d) ucrypto_fp_exptmod(a, b, c, d)
+#define fp_mulmod(a, b, c, d) ucrypto_fp_mulmod(a, b, c, d)
+#else
+#define ucrypto_hw_exptmod_nogil(G, X, P, Y) (false)
+#endif
+
 
 
 static vstr_t *vstr_unhexlify(vstr_t *vstr_out, const byte *in, size_t in_len)
@@ -132,6 +400,7 @@ static vstr_t *vstr_hexlify(vstr_t *vstr_out, const byte *in, size_t in_len)
 static fp_int *fp_alloc(void)
 {
     fp_int *a = m_new_obj(fp_int);
+    UCRYPTO_STATS_ADD(ALLOC_BYTES, sizeof(fp_int));
     fp_init(a);
     return a;
 }
@@ -144,120 +413,162 @@ static void fp_free(fp_int *a)
     }
 }
 
-static mp_obj_t fp_int_as_int(fp_int *b)
+/*
+    An fp_int always takes FP_SIZE digits, sized for the largest RSA modulus.
+    The integers kept by long-lived objects (the coordinates of a Point, the
+    r and s of a Signature) are stored in only the digits they use instead,
+    and expanded to an fp_int to compute with. A compact integer is never
+    changed once made, so objects may share one.
+*/
+typedef struct _fp_compact_t
 {
-    mp_obj_int_t *o = mp_obj_int_new_mpz();
-    mpz_init_zero(&o->mpz);
+    int used;
+    int sign;
+    fp_digit dp[];
+} fp_compact_t;
 
-    if (fp_iszero(b))
-    {
-        return MP_OBJ_FROM_PTR(o);
-    }
+static fp_compact_t *fp_compact_new(fp_int *a)
+{
+    size_t size = sizeof(fp_compact_t) + a->used * sizeof(fp_digit);
+    fp_compact_t *c = (fp_compact_t *)m_new(byte, size);
+    UCRYPTO_STATS_ADD(ALLOC_BYTES, size);
+    c->used = a->used;
+    c->sign = a->sign;
+    memcpy(c->dp, a->dp, a->used * sizeof(fp_digit));
+    return c;
+}
+
+// a = c
+static void fp_compact_get(fp_compact_t *c, fp_int *a)
+{
+    fp_zero(a);
+    memcpy(a->dp, c->dp, c->used * sizeof(fp_digit));
+    a->used = c->used;
+    a->sign = c->sign;
+}
+
+// both are clamped, so equal integers have the same digits
+static bool fp_compact_equal(fp_compact_t *c1, fp_compact_t *c2)
+{
+    return c1->used == c2->used && c1->sign == c2->sign && memcmp(c1->dp, c2->dp, c1->used * sizeof(fp_digit)) == 0;
+}
 
-    size_t nbits = fp_count_bits(b);
-    size_t bsize = (nbits >> 3) + (nbits & 7 ? 1 : 0);
+// b = a as big-endian in exactly len bytes, a < 2^(8 * len)
+static void fp_to_unsigned_bin_len(fp_int *a, unsigned char *b, size_t len)
+{
+    size_t size = fp_unsigned_bin_size(a);
+    memset(b, 0, len - size);
+    fp_to_unsigned_bin(a, b + len - size);
+}
 
-    bool is_neg = false;
-    if (fp_cmp_d(b, 0) == FP_LT)
+/*
+    The conversions copy the digits directly, bit i of the integer sits at the
+    same position in the mpz_dig_t array and in the fp_digit array, so no
+    intermediate byte buffer is needed. Neither side is modified.
+*/
+static mp_obj_t fp_digits_as_int(const fp_digit *dp, int used, int sign)
+{
+    // small ints need no mpz at all
+    if (used == 0)
     {
-        is_neg = true;
+        return MP_OBJ_NEW_SMALL_INT(0);
     }
-
-    if (is_neg)
+    if (used == 1 && dp[0] <= (fp_digit)MP_SMALL_INT_MAX)
     {
-        fp_abs(b, b);
+        mp_int_t v = (mp_int_t)dp[0];
+        return MP_OBJ_NEW_SMALL_INT(sign == FP_NEG ? -v : v);
     }
 
-    byte *bb = m_new(byte, bsize);
-
-    fp_to_unsigned_bin(b, bb);
-
-    mpz_set_from_bytes(&o->mpz, true, bsize, bb);
-
-    m_del(byte, bb, bsize);
+    mp_obj_int_t *o = mp_obj_int_new_mpz();
 
-    if (!mpz_is_zero(&o->mpz))
+    size_t bits = (used - 1) * DIGIT_BIT;
+    for (fp_digit top = dp[used - 1]; top != 0; top >>= 1)
+    {
+        bits++;
+    }
+    size_t len = (bits + MPZ_DIG_SIZE - 1) / MPZ_DIG_SIZE;
+    o->mpz.dig = m_new(mpz_dig_t, len);
+    o->mpz.alloc = len;
+    o->mpz.len = len;
+    o->mpz.neg = (sign == FP_NEG);
+
+    size_t bit = 0;
+    for (size_t n = 0; n < len; n++, bit += MPZ_DIG_SIZE)
     {
-        if (is_neg)
+        int j = bit / DIGIT_BIT, r = bit % DIGIT_BIT;
+        fp_digit d = dp[j] >> r;
+        if (r + MPZ_DIG_SIZE > DIGIT_BIT && j + 1 < used)
         {
-            mpz_neg_inpl(&o->mpz, &o->mpz);
+            d |= dp[j + 1] << (DIGIT_BIT - r);
         }
+        o->mpz.dig[n] = d & DIG_MASK;
     }
 
     return MP_OBJ_FROM_PTR(o);
 }
 
-static size_t mpz_as_fp_int(mpz_t *i, fp_int *b)
+static mp_obj_t fp_int_as_int(fp_int *b)
+{
+    return fp_digits_as_int(b->dp, b->used, b->sign);
+}
+
+static size_t mpz_as_fp_int(const mpz_t *i, fp_int *b)
 {
     /* set the integer to the default of zero */
     fp_zero(b);
 
-    if (mpz_is_zero(i))
-    {
-        return FP_OKAY;
-    }
-
-    size_t nbits = mpz_max_num_bits(i);
-    size_t bsize = (nbits >> 3) + (nbits & 7 ? 1 : 0);
-
-    byte *ib = m_new(byte, bsize);
-
-    bool is_neg = mpz_is_neg(i);
-    if (is_neg)
-    {
-        mpz_abs_inpl(i, i);
-    }
-
-    mpz_as_bytes(i, true, is_neg, bsize, ib);
-
-    if (is_neg)
-    {
-        mpz_neg_inpl(i, i);
-    }
-
-    fp_read_unsigned_bin(b, ib, bsize);
-
-    m_del(byte, ib, bsize);
-
-    /* set the sign only if b != 0 */
-    if (fp_iszero(b) != FP_YES)
+    // digits above FP_SIZE are dropped, like fp_read_unsigned_bin does
+    size_t bit = 0;
+    for (size_t n = 0; n < i->len; n++, bit += MPZ_DIG_SIZE)
     {
-        if (is_neg)
+        int j = bit / DIGIT_BIT, r = bit % DIGIT_BIT;
+        if (j >= FP_SIZE)
         {
-            b->sign = FP_NEG;
+            break;
         }
-        else
+        fp_digit d = i->dig[n];
+        b->dp[j] |= d << r;
+        if (r + MPZ_DIG_SIZE > DIGIT_BIT && j + 1 < FP_SIZE)
         {
-            b->sign = FP_ZPOS;
+            b->dp[j + 1] |= d >> (DIGIT_BIT - r);
         }
     }
+    b->used = MIN(FP_SIZE, (int)((bit + DIGIT_BIT - 1) / DIGIT_BIT));
+    fp_clamp(b);
 
-    return FP_OKAY;
-}
-
-static mpz_t *mp_mpz_for_int(mp_obj_t arg, mpz_t *temp)
-{
-    if (MP_OBJ_IS_SMALL_INT(arg))
-    {
-        mpz_init_from_int(temp, MP_OBJ_SMALL_INT_VALUE(arg));
-        return temp;
-    }
-    else
+    /* set the sign only if b != 0 */
+    if (fp_iszero(b) != FP_YES && mpz_is_neg(i))
     {
-        mp_obj_int_t *arp_p = MP_OBJ_TO_PTR(arg);
-        return &(arp_p->mpz);
+        b->sign = FP_NEG;
     }
+
+    return FP_OKAY;
 }
 
 static bool mp_fp_for_int(mp_obj_t arg, fp_int *ft_tmp)
 {
-    mpz_t arp_temp;
-    mpz_t *arp_p = mp_mpz_for_int(arg, &arp_temp);
-    mpz_as_fp_int(arp_p, ft_tmp);
-    if (arp_p == &arp_temp)
+    if (MP_OBJ_IS_SMALL_INT(arg))
     {
-        mpz_deinit(arp_p);
+        mp_int_t v = MP_OBJ_SMALL_INT_VALUE(arg);
+        mp_uint_t u = v < 0 ? -(mp_uint_t)v : (mp_uint_t)v;
+
+        fp_zero(ft_tmp);
+        for (int j = 0; u != 0 && j < FP_SIZE; j++)
+        {
+            ft_tmp->dp[j] = (fp_digit)u;
+            ft_tmp->used = j + 1;
+            // two half shifts, one full shift is undefined when mp_uint_t is not wider than fp_digit
+            u = (u >> (DIGIT_BIT / 2)) >> (DIGIT_BIT / 2);
+        }
+        if (v < 0)
+        {
+            ft_tmp->sign = FP_NEG;
+        }
+        return true;
     }
+
+    mp_obj_int_t *arp_p = MP_OBJ_TO_PTR(arg);
+    mpz_as_fp_int(&arp_p->mpz, ft_tmp);
     return true;
 }
 
@@ -287,6 +598,30 @@ static mp_obj_t mp_obj_new_int_from_fp(fp_int *fp)
     return fp_int_as_int(fp);
 }
 
+static mp_obj_t mp_obj_new_int_from_compact(fp_compact_t *c)
+{
+    return fp_digits_as_int(c->dp, c->used, c->sign);
+}
+
+static vstr_t *vstr_new_from_compact(fp_compact_t *c)
+{
+    fp_int *a = fp_alloc();
+    fp_compact_get(c, a);
+    vstr_t *vstr = vstr_new_from_fp(a);
+    fp_free(a);
+    return vstr;
+}
+
+// compact copy of the int arg
+static fp_compact_t *fp_compact_for_int(mp_obj_t arg)
+{
+    fp_int *a = fp_alloc();
+    mp_fp_for_int(arg, a);
+    fp_compact_t *c = fp_compact_new(a);
+    fp_free(a);
+    return c;
+}
+
 /* returns a TFM ident string useful for debugging... */
 static mp_obj_t mod_ident(void)
 {
@@ -301,49 +636,144 @@ static mp_obj_t mod_ident(void)
 static MP_DEFINE_CONST_FUN_OBJ_0(mod_ident_obj, mod_ident);
 static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_ident_obj, MP_ROM_PTR(&mod_ident_obj));
 
-static int fp_pow3(fp_int *X, fp_int *E, fp_int *M, fp_int *Y)
+// bit 'bit' of |a|
+static int fp_get_bit(fp_int *a, int bit)
 {
-    fp_int *x = fp_alloc();
-    fp_int *e = fp_alloc();
-    fp_int *y = fp_alloc();
+    int digit = bit / DIGIT_BIT;
+    if (digit >= a->used)
+    {
+        return 0;
+    }
+    return (int)((a->dp[digit] >> (bit % DIGIT_BIT)) & 1);
+}
 
-    fp_copy(X, x);
-    fp_copy(E, e);
-    fp_set(y, 1);
+// Y = X**E (mod 2^k), E >= 0, left to right sliding window over the odd powers X, X^3, ..., X^15
+static void fp_exptmod_2d(fp_int *X, fp_int *E, int k, fp_int *Y)
+{
+    fp_int *g[8];
+    fp_int *x2 = fp_alloc();
+    for (int i = 0; i < 8; i++)
+    {
+        g[i] = fp_alloc();
+    }
+
+    // g[i] = X^(2 * i + 1)
+    fp_mod_2d(X, k, g[0]);
+    fp_sqr(g[0], x2);
+    fp_mod_2d(x2, k, x2);
+    for (int i = 1; i < 8; i++)
+    {
+        fp_mul(g[i - 1], x2, g[i]);
+        fp_mod_2d(g[i], k, g[i]);
+    }
 
-    // while E > 0:
-    while (fp_cmp_d(e, 0) == FP_GT)
+    fp_set(Y, 1);
+    int i = fp_count_bits(E) - 1;
+    while (i >= 0)
     {
-        // if E % 2 == 0:
-        fp_digit Emod2;
-        fp_mod_d(e, 2, &Emod2);
-        if (Emod2 == 0)
+        if (!fp_get_bit(E, i))
         {
-            // X = (X * X) % m
-            fp_sqrmod(x, M, x);
-            // E = E / 2
-            fp_div_2(e, e);
+            fp_sqr(Y, Y);
+            fp_mod_2d(Y, k, Y);
+            i--;
+            continue;
         }
-        else
+
+        // window of at most 4 bits E[i..j], E[j] = 1
+        int j = MAX(i - 3, 0);
+        while (!fp_get_bit(E, j))
+        {
+            j++;
+        }
+        int w = 0;
+        for (int l = i; l >= j; l--)
         {
-            // Y = (X * Y) % m
-            fp_mulmod(x, y, M, y);
-            // E = E - 1
-            fp_sub_d(e, 1, e);
+            w = (w << 1) | fp_get_bit(E, l);
+            fp_sqr(Y, Y);
+            fp_mod_2d(Y, k, Y);
         }
+        fp_mul(Y, g[w >> 1], Y);
+        fp_mod_2d(Y, k, Y);
+        i = j - 1;
+    }
+    fp_mod_2d(Y, k, Y);
+
+    fp_free(x2);
+    for (int i = 0; i < 8; i++)
+    {
+        fp_free(g[i]);
+    }
+}
+
+/*
+    Y = X**E (mod M) for any M > 0, a negative E inverts X first.
+    M = m * 2^k with m odd, X**E (mod m) by fp_exptmod and X**E (mod 2^k)
+    by fp_exptmod_2d, joined with Y = a2 + 2^k * ((a1 - a2) / 2^k mod m).
+*/
+static int fp_exptmod_any(fp_int *X, fp_int *E, fp_int *M, fp_int *Y)
+{
+    if (fp_cmp_d(M, 0) != FP_GT)
+    {
+        return FP_VAL;
+    }
+    if (fp_cmp_d(M, 1) == FP_EQ)
+    {
+        fp_zero(Y);
+        return FP_OKAY;
+    }
+
+    fp_int *x = fp_alloc();
+    fp_int *e = fp_alloc();
+    fp_int *m = fp_alloc();
+    fp_int *a1 = fp_alloc();
+    fp_int *a2 = fp_alloc();
+    int err = FP_OKAY;
+
+    fp_mod(X, M, x);
+    fp_abs(E, e);
+    if (fp_cmp_d(E, 0) == FP_LT)
+    {
+        // fp_invmod does not return for 0
+        err = fp_iszero(x) ? FP_VAL : fp_invmod(x, M, x);
+    }
+
+    int k = fp_cnt_lsb(M);
+    fp_div_2d(M, k, m, NULL);
+    if (err == FP_OKAY && k == 0)
+    {
+        fp_exptmod(x, e, m, Y);
+    }
+    else if (err == FP_OKAY && fp_cmp_d(m, 1) == FP_EQ)
+    {
+        fp_exptmod_2d(x, e, k, Y);
     }
+    else if (err == FP_OKAY)
+    {
+        fp_exptmod(x, e, m, a1);
+        fp_exptmod_2d(x, e, k, a2);
 
-    fp_copy(y, Y);
+        // x = 2^-k (mod m)
+        fp_2expt(x, k);
+        fp_invmod(x, m, x);
+
+        fp_submod(a1, a2, m, a1);
+        fp_mulmod(a1, x, m, a1);
+        fp_mul_2d(a1, k, a1);
+        fp_add(a1, a2, Y);
+    }
 
     fp_free(x);
     fp_free(e);
-    fp_free(y);
+    fp_free(m);
+    fp_free(a1);
+    fp_free(a2);
 
-    return FP_OKAY;
+    return err;
 }
 
 static mp_obj_t mod_fast_pow(mp_obj_t A_in, mp_obj_t B_in, mp_obj_t C_in)
 {
+    UCRYPTO_STATS_API(NUMBER);
     fp_int *a_fp_int = fp_alloc();
     fp_int *b_fp_int = fp_alloc();
     fp_int *c_fp_int = fp_alloc();
@@ -353,7 +783,10 @@ static mp_obj_t mod_fast_pow(mp_obj_t A_in, mp_obj_t B_in, mp_obj_t C_in)
     mp_fp_for_int(B_in, b_fp_int);
     mp_fp_for_int(C_in, c_fp_int);
 
-    fp_pow3(a_fp_int, b_fp_int, c_fp_int, d_fp_int);
+    if (fp_exptmod_any(a_fp_int, b_fp_int, c_fp_int, d_fp_int) != FP_OKAY)
+    {
+        mp_raise_ValueError(ERROR_EXPTMOD_VALUE);
+    }
 
     mp_obj_t res = mp_obj_new_int_from_fp(d_fp_int);
 
@@ -371,6 +804,7 @@ static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_fast_pow_obj, MP_ROM_PTR(&mod
 /* d = a**b (mod c) */
 static mp_obj_t mod_exptmod(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 {
+    UCRYPTO_STATS_API(NUMBER);
     static const mp_arg_t allowed_args[] = {
         {MP_QSTR_a, MP_ARG_OBJ, {.u_obj = mp_const_none}},
         {MP_QSTR_b, MP_ARG_OBJ, {.u_obj = mp_const_none}},
@@ -396,13 +830,19 @@ static mp_obj_t mod_exptmod(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     // the montgomery reduce need odd modulus
     if (fp_isodd(c_fp_int) == FP_YES)
     {
+        UCRYPTO_GIL_ROOTS(a_fp_int, b_fp_int, c_fp_int, d_fp_int);
+        UCRYPTO_GIL_EXIT();
         fp_exptmod(a_fp_int, b_fp_int, c_fp_int, d_fp_int);
+        UCRYPTO_GIL_ENTER();
     }
     else
     {
         if (args.safe.u_bool)
         {
-            fp_pow3(a_fp_int, b_fp_int, c_fp_int, d_fp_int);
+            if (fp_exptmod_any(a_fp_int, b_fp_int, c_fp_int, d_fp_int) != FP_OKAY)
+            {
+                mp_raise_ValueError(ERROR_EXPTMOD_VALUE);
+            }
         }
         else
         {
@@ -423,9 +863,88 @@ static mp_obj_t mod_exptmod(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
 static MP_DEFINE_CONST_FUN_OBJ_KW(mod_exptmod_obj, 3, mod_exptmod);
 static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_exptmod_obj, MP_ROM_PTR(&mod_exptmod_obj));
 
+/*
+    m = c**d (mod p * q) from the CRT components of d,
+    m1 = c**dp (mod p), m2 = c**dq (mod q), m = m2 + q * (qinv * (m1 - m2) mod p)
+*/
+static void fp_exptmod_crt(fp_int *c, fp_int *p, fp_int *q, fp_int *dp, fp_int *dq, fp_int *qinv, fp_int *m)
+{
+    fp_int *m1 = fp_alloc();
+    fp_int *m2 = fp_alloc();
+    fp_int *t = fp_alloc();
+
+    fp_int *t2 = fp_alloc();
+
+    fp_mod(c, p, t);
+    fp_mod(c, q, t2);
+    UCRYPTO_GIL_ROOTS(p, q, dp, dq, m1, m2, t, t2);
+    UCRYPTO_GIL_EXIT();
+    fp_exptmod(t, dp, p, m1);
+    fp_exptmod(t2, dq, q, m2);
+    UCRYPTO_GIL_ENTER();
+
+    fp_submod(m1, m2, p, t);
+    fp_mulmod(t, qinv, p, t);
+    fp_mul(t, q, t);
+    fp_add(t, m2, m);
+
+    fp_free(m1);
+    fp_free(m2);
+    fp_free(t);
+    fp_free(t2);
+}
+
+/* m = c**d (mod p * q), d given by dp = d mod (p - 1), dq = d mod (q - 1), qinv = 1/q (mod p) */
+static mp_obj_t mod_exptmod_crt(size_t n_args, const mp_obj_t *args)
+{
+    UCRYPTO_STATS_API(NUMBER);
+    (void)n_args;
+    fp_int *v[6];
+    for (int i = 0; i < 6; i++)
+    {
+        if (!MP_OBJ_IS_INT(args[i]))
+        {
+            for (int j = 0; j < i; j++)
+            {
+                fp_free(v[j]);
+            }
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, i + 1, mp_obj_get_type_str(args[i]));
+        }
+        v[i] = fp_alloc();
+        mp_fp_for_int(args[i], v[i]);
+    }
+
+    // the montgomery reduce need odd modulus
+    if (fp_isodd(v[1]) != FP_YES || fp_isodd(v[2]) != FP_YES)
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            fp_free(v[i]);
+        }
+        mp_raise_ValueError(ERROR_CRT_ODD_PRIMES);
+    }
+
+    fp_int *m_fp_int = fp_alloc();
+    fp_exptmod_crt(v[0], v[1], v[2], v[3], v[4], v[5], m_fp_int);
+
+    mp_obj_t res = mp_obj_new_int_from_fp(m_fp_int);
+
+    fp_free(m_fp_int);
+    for (int i = 0; i < 6; i++)
+    {
+        fp_free(v[i]);
+    }
+
+    return res;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_exptmod_crt_obj, 6, 6, mod_exptmod_crt);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_exptmod_crt_obj, MP_ROM_PTR(&mod_exptmod_crt_obj));
+
 /* c = 1/a (mod b) */
 static mp_obj_t mod_invmod(mp_obj_t A_in, mp_obj_t B_in)
 {
+    UCRYPTO_STATS_API(NUMBER);
     fp_int *a_fp_int = fp_alloc();
     fp_int *b_fp_int = fp_alloc();
     fp_int *c_fp_int = fp_alloc();
@@ -449,6 +968,7 @@ static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_invmod_obj, MP_ROM_PTR(&mod_i
 /* c = (a, b) */
 static mp_obj_t mod_gcd(mp_obj_t A_in, mp_obj_t B_in)
 {
+    UCRYPTO_STATS_API(NUMBER);
     fp_int *a_fp_int = fp_alloc();
     fp_int *b_fp_int = fp_alloc();
     fp_int *c_fp_int = fp_alloc();
@@ -480,6 +1000,14 @@ static int ucrypto_rng(unsigned char *dst, int len, void *dat)
     return len;
 }
 
+// ucrypto_rng for the prime search, which runs with the GIL released: the RNG state is shared, so it takes the GIL back
+static void ucrypto_rng_gil(unsigned char *dst, int len)
+{
+    UCRYPTO_GIL_ENTER();
+    ucrypto_rng(dst, len, NULL);
+    UCRYPTO_GIL_EXIT();
+}
+
 /* generate prime number */
 
 #if defined(__thumb2__) || defined(__thumb__) || defined(__arm__)
@@ -497,51 +1025,247 @@ void free(void *ptr)
 #endif
 #endif
 
-static mp_obj_t mod_generate_prime(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
-{
-    static const mp_arg_t allowed_args[] = {
-        {MP_QSTR_num, MP_ARG_INT, {.u_int = 1024}},
-        {MP_QSTR_test, MP_ARG_INT, {.u_int = 25}},
-        {MP_QSTR_safe, MP_ARG_BOOL, {.u_bool = false}}};
+// odd primes up to 1619, the residue table of the candidate sieve
+#define PRIME_SIEVE_SIZE 255
+static const uint16_t prime_sieve_table[PRIME_SIEVE_SIZE] = {
+    3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59,
+    61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131, 137,
+    139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223, 227,
+    229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311, 313,
+    317, 331, 337, 347, 349, 353, 359, 367, 373, 379, 383, 389, 397, 401, 409, 419,
+    421, 431, 433, 439, 443, 449, 457, 461, 463, 467, 479, 487, 491, 499, 503, 509,
+    521, 523, 541, 547, 557, 563, 569, 571, 577, 587, 593, 599, 601, 607, 613, 617,
+    619, 631, 641, 643, 647, 653, 659, 661, 673, 677, 683, 691, 701, 709, 719, 727,
+    733, 739, 743, 751, 757, 761, 769, 773, 787, 797, 809, 811, 821, 823, 827, 829,
+    839, 853, 857, 859, 863, 877, 881, 883, 887, 907, 911, 919, 929, 937, 941, 947,
+    953, 967, 971, 977, 983, 991, 997, 1009, 1013, 1019, 1021, 1031, 1033, 1039, 1049, 1051,
+    1061, 1063, 1069, 1087, 1091, 1093, 1097, 1103, 1109, 1117, 1123, 1129, 1151, 1153, 1163, 1171,
+    1181, 1187, 1193, 1201, 1213, 1217, 1223, 1229, 1231, 1237, 1249, 1259, 1277, 1279, 1283, 1289,
+    1291, 1297, 1301, 1303, 1307, 1319, 1321, 1327, 1361, 1367, 1373, 1381, 1399, 1409, 1423, 1427,
+    1429, 1433, 1439, 1447, 1451, 1453, 1459, 1471, 1481, 1483, 1487, 1489, 1493, 1499, 1511, 1523,
+    1531, 1543, 1549, 1553, 1559, 1567, 1571, 1579, 1583, 1597, 1601, 1607, 1609, 1613, 1619,
+};
 
-    struct
-    {
-        mp_arg_val_t num, test, safe;
-    } args;
-    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+// above 2 * 1619 + 1, so neither p nor (p - 1) / 2 can be one of the sieve primes
+#define PRIME_SEARCH_MIN 4096
+#define PRIME_SEARCH_MAX_SPAN (1UL << 30)
 
-    if (args.num.u_int < 16 || args.num.u_int > 4096)
+// Miller-Rabin rounds for an error probability below 2^-100, FIPS 186-4 table C.3,
+// and the 40 rounds of table C.1 for the smaller sizes
+static int prime_mr_rounds(int bits)
+{
+    if (bits >= 1536)
     {
-        mp_raise_msg_varg(&mp_type_ValueError, ERROR_NUM_BITS, args.num.u_int);
+        return 3;
     }
-    int flags = ((FP_GEN_RANDOM() & 1) ? TFM_PRIME_2MSB_OFF : TFM_PRIME_2MSB_ON);
-    if (args.safe.u_bool)
+    if (bits >= 1024)
     {
-        flags |= TFM_PRIME_SAFE;
+        return 4;
     }
-    fp_int a_fp_int;
-    int ret = FP_OKAY;
-    if ((ret = fp_prime_random_ex(&a_fp_int, args.test.u_int, args.num.u_int, flags, ucrypto_rng, NULL)) == FP_OKAY)
+    if (bits >= 512)
     {
-        if (fp_count_bits(&a_fp_int) != args.num.u_int)
-        {
-            mp_raise_msg_varg(&mp_type_ValueError, ERROR_PRIME_LEN, fp_count_bits(&a_fp_int), args.num.u_int);
-        }
+        return 7;
     }
-    else
+    return 40;
+}
+
+// t rounds of Miller-Rabin with random bases in [2, a - 2], a odd and above 4, called with the GIL released
+static int fp_prime_mr_random(fp_int *a, int t)
+{
+    unsigned char buf[FP_MAX_SIZE / 8];
+    int size = fp_unsigned_bin_size(a);
+    int res = FP_NO;
+    fp_int a3, b;
+    fp_init(&a3);
+    fp_init(&b);
+    fp_sub_d(a, 3, &a3);
+    for (; t > 0; t--)
     {
-        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("%d"), ret);
+        ucrypto_rng_gil(buf, size);
+        fp_read_unsigned_bin(&b, buf, size);
+        fp_mod(&b, &a3, &b);
+        fp_add_d(&b, 2, &b);
+        fp_prime_miller_rabin(a, &b, &res);
+        if (res == FP_NO)
+        {
+            return FP_NO;
+        }
     }
-    return mp_obj_new_int_from_fp(&a_fp_int);
+    return FP_YES;
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_KW(mod_generate_prime_obj, 1, mod_generate_prime);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_generate_prime_obj, MP_ROM_PTR(&mod_generate_prime_obj));
-
-static mp_obj_t mod_is_prime(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+// First probable prime p in [start, start + span), with (p - 1) / 2 prime too if safe, start at least
+// PRIME_SEARCH_MIN. The residues of the first candidate are computed once and stepped along the window,
+// so only candidates without a small factor cost a Miller-Rabin test; t = 0 picks prime_mr_rounds
+static int fp_prime_search(fp_int *start, fp_digit span, int t, bool safe, fp_int *p)
 {
-    static const mp_arg_t allowed_args[] = {
-        {MP_QSTR_a, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    uint16_t mods[PRIME_SIEVE_SIZE];
+    fp_digit step = (safe ? 4 : 2), delta, r;
+    fp_int q;
+    fp_init(&q);
+
+    // odd, and 3 (mod 4) for a safe prime so that (p - 1) / 2 is odd
+    fp_mod_d(start, 4, &r);
+    delta = (safe ? ((3 - r) & 3) : ((r & 1) ^ 1));
+    fp_add_d(start, delta, p);
+    for (int i = 0; i < PRIME_SIEVE_SIZE; i++)
+    {
+        fp_mod_d(p, prime_sieve_table[i], &r);
+        mods[i] = (uint16_t)r;
+    }
+
+    for (; delta < span; delta += step)
+    {
+        bool sieved = true;
+        for (int i = 0; i < PRIME_SIEVE_SIZE; i++)
+        {
+            // p = 1 (mod s) makes s divide (p - 1) / 2
+            if (mods[i] == 0 || (safe && mods[i] == 1))
+            {
+                sieved = false;
+            }
+            mods[i] += step;
+            while (mods[i] >= prime_sieve_table[i])
+            {
+                mods[i] -= prime_sieve_table[i];
+            }
+        }
+        if (!sieved)
+        {
+            continue;
+        }
+
+        fp_add_d(start, delta, p);
+        int bits = fp_count_bits(p);
+        if (safe)
+        {
+            // the smaller q first, p only when q passed
+            fp_div_2(p, &q);
+            if (fp_prime_mr_random(&q, (t ? t : prime_mr_rounds(bits - 1))) == FP_NO)
+            {
+                continue;
+            }
+        }
+        if (fp_prime_mr_random(p, (t ? t : prime_mr_rounds(bits))) == FP_YES)
+        {
+            return FP_YES;
+        }
+    }
+    return FP_NO;
+}
+
+// Random probable prime of exactly bits bits, a fresh random start only when a window runs out
+static void fp_prime_generate(fp_int *p, int bits, int t, bool safe)
+{
+    unsigned char buf[FP_MAX_SIZE / 8];
+    int size = (bits + 7) / 8;
+    fp_int start;
+    do
+    {
+        ucrypto_rng_gil(buf, size);
+        buf[0] &= (unsigned char)((2 << ((bits - 1) & 7)) - 1);
+        buf[0] |= (unsigned char)(1 << ((bits - 1) & 7));
+        fp_read_unsigned_bin(&start, buf, size);
+    } while (fp_prime_search(&start, 64 * (fp_digit)bits, t, safe, p) == FP_NO || fp_count_bits(p) != bits);
+}
+
+static mp_obj_t mod_generate_prime(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    UCRYPTO_STATS_API(PRIME);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_num, MP_ARG_INT, {.u_int = 1024}},
+        {MP_QSTR_test, MP_ARG_INT, {.u_int = 0}},
+        {MP_QSTR_safe, MP_ARG_BOOL, {.u_bool = false}}};
+
+    struct
+    {
+        mp_arg_val_t num, test, safe;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    if (args.num.u_int < 16 || args.num.u_int > 4096)
+    {
+        mp_raise_msg_varg(&mp_type_ValueError, ERROR_NUM_BITS, args.num.u_int);
+    }
+    if (args.test.u_int < 0)
+    {
+        mp_raise_ValueError(ERROR_PRIME_TEST_ROUNDS);
+    }
+    fp_int a_fp_int;
+    // on the stack only, nothing to root
+    UCRYPTO_GIL_EXIT();
+    fp_prime_generate(&a_fp_int, args.num.u_int, args.test.u_int, args.safe.u_bool);
+    UCRYPTO_GIL_ENTER();
+    return mp_obj_new_int_from_fp(&a_fp_int);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(mod_generate_prime_obj, 1, mod_generate_prime);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_generate_prime_obj, MP_ROM_PTR(&mod_generate_prime_obj));
+
+/* first probable prime in [start, start + span), None if there is none */
+static mp_obj_t mod_prime_search(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    UCRYPTO_STATS_API(PRIME);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_start, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_span, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0}},
+        {MP_QSTR_test, MP_ARG_INT, {.u_int = 0}},
+        {MP_QSTR_safe, MP_ARG_BOOL, {.u_bool = false}}};
+
+    struct
+    {
+        mp_arg_val_t start, span, test, safe;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+    if (!MP_OBJ_IS_INT(args.start.u_obj))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT, mp_obj_get_type_str(args.start.u_obj));
+    }
+    if (args.span.u_int < 1 || (mp_uint_t)args.span.u_int > PRIME_SEARCH_MAX_SPAN)
+    {
+        mp_raise_ValueError(ERROR_PRIME_SEARCH_SPAN);
+    }
+    if (args.test.u_int < 0)
+    {
+        mp_raise_ValueError(ERROR_PRIME_TEST_ROUNDS);
+    }
+
+    fp_int *start_fp_int = fp_alloc();
+    fp_int *p_fp_int = fp_alloc();
+    mp_fp_for_int(args.start.u_obj, start_fp_int);
+    // the small end keeps every sieve prime a proper factor, the big end the search inside FP_MAX_SIZE
+    if (fp_cmp_d(start_fp_int, PRIME_SEARCH_MIN) == FP_LT || fp_count_bits(start_fp_int) > FP_MAX_SIZE / 2)
+    {
+        fp_free(start_fp_int);
+        fp_free(p_fp_int);
+        mp_raise_ValueError(ERROR_PRIME_SEARCH_START);
+    }
+
+    UCRYPTO_GIL_ROOTS(start_fp_int, p_fp_int);
+    UCRYPTO_GIL_EXIT();
+    int found = fp_prime_search(start_fp_int, (fp_digit)args.span.u_int, args.test.u_int, args.safe.u_bool, p_fp_int);
+    UCRYPTO_GIL_ENTER();
+
+    mp_obj_t res = mp_const_none;
+    if (found == FP_YES)
+    {
+        res = mp_obj_new_int_from_fp(p_fp_int);
+    }
+
+    fp_free(start_fp_int);
+    fp_free(p_fp_int);
+
+    return res;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(mod_prime_search_obj, 2, mod_prime_search);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_prime_search_obj, MP_ROM_PTR(&mod_prime_search_obj));
+
+static mp_obj_t mod_is_prime(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    UCRYPTO_STATS_API(PRIME);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_a, MP_ARG_OBJ, {.u_obj = mp_const_none}},
         {MP_QSTR_test, MP_ARG_INT, {.u_int = 25}},
     };
 
@@ -569,484 +1293,576 @@ static mp_obj_t mod_is_prime(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
 static MP_DEFINE_CONST_FUN_OBJ_KW(mod_is_prime_obj, 1, mod_is_prime);
 static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_is_prime_obj, MP_ROM_PTR(&mod_is_prime_obj));
 
-static void number_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
-{
-    (void)kind;
-    mp_printf(print, mp_obj_get_type_str(self_in));
-}
-
-static const mp_rom_map_elem_t number_locals_dict_table[] = {
-    {MP_ROM_QSTR(MP_QSTR_ident), MP_ROM_PTR(&mod_static_ident_obj)},
-    {MP_ROM_QSTR(MP_QSTR_exptmod), MP_ROM_PTR(&mod_static_exptmod_obj)},
-    {MP_ROM_QSTR(MP_QSTR_fast_pow), MP_ROM_PTR(&mod_static_fast_pow_obj)},
-    {MP_ROM_QSTR(MP_QSTR_invmod), MP_ROM_PTR(&mod_static_invmod_obj)},
-    {MP_ROM_QSTR(MP_QSTR_gcd), MP_ROM_PTR(&mod_static_gcd_obj)},
-    {MP_ROM_QSTR(MP_QSTR_generate_prime), MP_ROM_PTR(&mod_static_generate_prime_obj)},
-    {MP_ROM_QSTR(MP_QSTR_is_prime), MP_ROM_PTR(&mod_static_is_prime_obj)},
-};
-
-static MP_DEFINE_CONST_DICT(number_locals_dict, number_locals_dict_table);
-
-MP_DEFINE_CONST_OBJ_TYPE(
-    number_type,
-    MP_QSTR_NUMBER,
-    MP_TYPE_FLAG_NONE,
-    print, number_print,
-    locals_dict, &number_locals_dict);
-
-// point in a prime field
-typedef struct _ecc_point_t
+// Montgomery constants of an odd modulus, computed once for every exponentiation
+typedef struct _fp_mont_t
 {
-    fp_int *x;
-    fp_int *y;
-} ecc_point_t;
-
-// curve over a prime field
-typedef struct _ecc_curve_t
+    fp_int *n;
+    fp_digit mp;
+    // R mod n and R^2 mod n
+    fp_int *one;
+    fp_int *r2;
+} fp_mont_t;
+
+static void fp_mont_init(fp_mont_t *mont, fp_int *n)
 {
-    fp_int *p;
-    fp_int *a;
-    fp_int *b;
-    fp_int *q;
-    ecc_point_t *g;
-    vstr_t name;
-    vstr_t oid;
-} ecc_curve_t;
+    mont->n = n;
+    fp_montgomery_setup(n, &mont->mp);
+    mont->one = fp_alloc();
+    mont->r2 = fp_alloc();
+    fp_montgomery_calc_normalization(mont->one, n);
+    fp_mulmod(mont->one, mont->one, n, mont->r2);
+}
 
-typedef struct _ecdsa_signature_t
+static void fp_mont_deinit(fp_mont_t *mont)
 {
-    fp_int *r;
-    fp_int *s;
-} ecdsa_signature_t;
-
-typedef struct _ecdsa_signature_teth {
-    fp_int *r;
-    fp_int *s;
-    int v; // Adiciona o parâmetro de recuperação
-    int chainId;
-} ecdsa_signature_teth;
+    fp_free(mont->one);
+    fp_free(mont->r2);
+    mont->one = NULL;
+    mont->r2 = NULL;
+}
 
-typedef struct _mp_curve_t
+// R = {1, G} in the Montgomery domain, the registers of the ladder of fp_exptmod_mont
+static void fp_exptmod_mont_start(fp_int *G, fp_mont_t *mont, fp_int **R)
 {
-    mp_obj_base_t base;
-    ecc_curve_t *ecc_curve;
-} mp_curve_t;
+    fp_copy(mont->one, R[0]);
+    fp_mod(G, mont->n, R[1]);
+    fp_mul(R[1], mont->r2, R[1]);
+    fp_montgomery_reduce(R[1], mont->n, mont->mp);
+}
 
-typedef struct _mp_point_t
+// one step of the ladder for the exponent bit y, R[1] / R[0] stays G
+static void fp_exptmod_mont_bit(fp_int **R, int y, fp_mont_t *mont)
 {
-    mp_obj_base_t base;
-    ecc_point_t *ecc_point;
-    ecc_curve_t *ecc_curve;
-} mp_point_t;
+    fp_mul(R[0], R[1], R[y ^ 1]);
+    fp_montgomery_reduce(R[y ^ 1], mont->n, mont->mp);
+    fp_sqr(R[y], R[y]);
+    fp_montgomery_reduce(R[y], mont->n, mont->mp);
+}
 
-typedef struct _mp_ecdsa_signature_t
+/*
+    Y = G**X (mod n), X >= 0, the Montgomery ladder of fp_exptmod over all
+    the bits of the used digits of X, without its per call setup
+*/
+static void fp_exptmod_mont(fp_int *G, fp_int *X, fp_mont_t *mont, fp_int *Y)
 {
-    mp_obj_base_t base;
-    ecdsa_signature_t *ecdsa_signature;
-} mp_ecdsa_signature_t;
-
-
-typedef struct _mp_ecdsa_signature_eth_t {
-    mp_obj_base_t base;
-    ecdsa_signature_teth *ecdsa_signature_eth;
-} mp_ecdsa_signature_eth_t;
-
-const mp_obj_type_t signature_type;
-const mp_obj_type_t signature_eth_type;
-const mp_obj_type_t curve_type;
-const mp_obj_type_t point_type;
-const mp_obj_type_t ecc_type;
-
+    if (ucrypto_hw_exptmod_nogil(G, X, mont->n, Y))
+    {
+        return;
+    }
 
-// Prototipagem das funções
-static void signature_eth_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind);
-static mp_obj_t signature_eth_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs);
-static mp_obj_t signature_eth_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest);
-//static void signature_eth_deinit(mp_obj_t self_in);
+    fp_int *R[2] = {fp_alloc(), fp_alloc()};
 
+    fp_exptmod_mont_start(G, mont, R);
+    UCRYPTO_GIL_ROOTS(R[0], R[1], X, mont->n);
+    UCRYPTO_GIL_EXIT();
+    for (int i = X->used * DIGIT_BIT - 1; i >= 0; i--)
+    {
+        fp_exptmod_mont_bit(R, fp_get_bit(X, i), mont);
+    }
+    UCRYPTO_GIL_ENTER();
 
+    fp_montgomery_reduce(R[0], mont->n, mont->mp);
+    fp_copy(R[0], Y);
 
-/**
- * Impressão do objeto SignatureETH.
- */
-static void signature_eth_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
-    (void)kind;
-    mp_ecdsa_signature_eth_t *self = MP_OBJ_TO_PTR(self_in);
-    vstr_t *vstr_r = vstr_new_from_fp(self->ecdsa_signature_eth->r);
-    vstr_t *vstr_s = vstr_new_from_fp(self->ecdsa_signature_eth->s);
-    mp_printf(print, "<SignatureETH r=%s s=%s v_eth=%d chainId=%d>", vstr_str(vstr_r), vstr_str(vstr_s), self->ecdsa_signature_eth->v, self->ecdsa_signature_eth->chainId);
-    vstr_free(vstr_r);
-    vstr_free(vstr_s);
+    fp_free(R[0]);
+    fp_free(R[1]);
 }
 
+////////////////////////////////////// Jobs ////////////////////////////////////
 
-static mp_curve_t *new_curve_init_copy(mp_point_t *point)
+/*
+    A job runs the loop of a long operation a few iterations per call of
+    Job.step(n), so an asyncio task can yield between steps instead of
+    blocking the VM for the whole operation. The loop state is kept in the
+    fp_int's of the job, nothing goes through Python ints until the result.
+*/
+typedef struct _mp_job_t mp_job_t;
+
+struct _mp_job_t
 {
-    mp_curve_t *c = m_new_obj(mp_curve_t);
-    c->base.type = &curve_type;
-    c->ecc_curve = m_new_obj(ecc_curve_t);
-    c->ecc_curve->p = fp_alloc();
-    c->ecc_curve->a = fp_alloc();
-    c->ecc_curve->b = fp_alloc();
-    c->ecc_curve->q = fp_alloc();
-    c->ecc_curve->g = m_new_obj(ecc_point_t);
-    c->ecc_curve->g->x = fp_alloc();
-    c->ecc_curve->g->y = fp_alloc();
-
-    vstr_init(&c->ecc_curve->name, vstr_len(&point->ecc_curve->oid));
-    vstr_add_strn(&c->ecc_curve->name, vstr_str(&point->ecc_curve->name), vstr_len(&point->ecc_curve->name));
-    vstr_init(&c->ecc_curve->oid, vstr_len(&point->ecc_curve->oid));
-    vstr_add_strn(&c->ecc_curve->oid, vstr_str(&point->ecc_curve->oid), vstr_len(&point->ecc_curve->oid));
-
-    fp_copy(point->ecc_curve->p, c->ecc_curve->p);
-    fp_copy(point->ecc_curve->a, c->ecc_curve->a);
-    fp_copy(point->ecc_curve->b, c->ecc_curve->b);
-    fp_copy(point->ecc_curve->q, c->ecc_curve->q);
-    fp_copy(point->ecc_curve->g->x, c->ecc_curve->g->x);
-    fp_copy(point->ecc_curve->g->y, c->ecc_curve->g->y);
+    mp_obj_base_t base;
+    // runs at most n iterations, sets result after the last one
+    void (*step)(mp_job_t *job, mp_int_t n);
+    mp_obj_t result;
+    // next bit of k, the loop is over below 0
+    int bit;
+    fp_int *k;
+    // registers of the ladder: R[0], R[1] of exptmod or the jacobian R0, R1 of point_mul
+    fp_int *r[6];
+    fp_mont_t mont;
+    // Curve of point_mul
+    mp_obj_t curve;
+};
 
-    return c;
-}
+const mp_obj_type_t job_type;
 
-static mp_point_t *new_point_init_copy(mp_curve_t *curve)
+static mp_job_t *new_job(void (*step)(mp_job_t *job, mp_int_t n), int nregs)
 {
-    mp_point_t *pr = m_new_obj(mp_point_t);
-    pr->base.type = &point_type;
-
-    pr->ecc_curve = m_new_obj(ecc_curve_t);
-    pr->ecc_curve->p = fp_alloc();
-    pr->ecc_curve->a = fp_alloc();
-    pr->ecc_curve->b = fp_alloc();
-    pr->ecc_curve->q = fp_alloc();
-    pr->ecc_curve->g = m_new_obj(ecc_point_t);
-    pr->ecc_curve->g->x = fp_alloc();
-    pr->ecc_curve->g->y = fp_alloc();
-    pr->ecc_point = m_new_obj(ecc_point_t);
-    pr->ecc_point->x = fp_alloc();
-    pr->ecc_point->y = fp_alloc();
-
-    vstr_init(&pr->ecc_curve->name, vstr_len(&curve->ecc_curve->oid));
-    vstr_add_strn(&pr->ecc_curve->name, vstr_str(&curve->ecc_curve->name), vstr_len(&curve->ecc_curve->name));
-    vstr_init(&pr->ecc_curve->oid, vstr_len(&curve->ecc_curve->oid));
-    vstr_add_strn(&pr->ecc_curve->oid, vstr_str(&curve->ecc_curve->oid), vstr_len(&curve->ecc_curve->oid));
-
-    fp_copy(curve->ecc_curve->p, pr->ecc_curve->p);
-    fp_copy(curve->ecc_curve->a, pr->ecc_curve->a);
-    fp_copy(curve->ecc_curve->b, pr->ecc_curve->b);
-    fp_copy(curve->ecc_curve->q, pr->ecc_curve->q);
-    fp_copy(curve->ecc_curve->g->x, pr->ecc_curve->g->x);
-    fp_copy(curve->ecc_curve->g->y, pr->ecc_curve->g->y);
-    fp_copy(curve->ecc_curve->g->x, pr->ecc_point->x);
-    fp_copy(curve->ecc_curve->g->y, pr->ecc_point->y);
-    return pr;
+    mp_job_t *job = m_new0(mp_job_t, 1);
+    job->base.type = &job_type;
+    job->step = step;
+    job->result = MP_OBJ_NULL;
+    job->curve = MP_OBJ_NULL;
+    job->k = fp_alloc();
+    for (int i = 0; i < nregs; i++)
+    {
+        job->r[i] = fp_alloc();
+    }
+    return job;
 }
 
-static bool ec_signature_equal(ecdsa_signature_t *s1, ecdsa_signature_t *s2)
+// gives back the loop state once the result is set
+static void job_release(mp_job_t *job)
 {
-    if (fp_cmp(s1->r, s2->r) != FP_EQ)
+    for (int i = 0; i < (int)MP_ARRAY_SIZE(job->r); i++)
     {
-        return false;
+        fp_free(job->r[i]);
+        job->r[i] = NULL;
     }
-    if (fp_cmp(s1->s, s2->s) != FP_EQ)
+    fp_free(job->k);
+    job->k = NULL;
+    if (job->mont.n != NULL)
     {
-        return false;
+        fp_free(job->mont.n);
+        fp_mont_deinit(&job->mont);
+        job->mont.n = NULL;
     }
-    return true;
 }
 
-static void signature_print(mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+static void job_exptmod_step(mp_job_t *job, mp_int_t n)
 {
-    (void)kind;
-    mp_ecdsa_signature_t *self = MP_OBJ_TO_PTR(self_in);
-    vstr_t *vstr_r = vstr_new_from_fp(self->ecdsa_signature->r);
-    vstr_t *vstr_s = vstr_new_from_fp(self->ecdsa_signature->s);
-    mp_printf(print, "<Signature r=%s s=%s>", vstr_str(vstr_r), vstr_str(vstr_s));
-    vstr_free(vstr_r);
-    vstr_free(vstr_s);
+    UCRYPTO_STATS_API(NUMBER);
+    for (; n > 0 && job->bit >= 0; n--, job->bit--)
+    {
+        fp_exptmod_mont_bit(job->r, fp_get_bit(job->k, job->bit), &job->mont);
+    }
+
+    if (job->bit < 0)
+    {
+        fp_montgomery_reduce(job->r[0], job->mont.n, job->mont.mp);
+        job->result = mp_obj_new_int_from_fp(job->r[0]);
+        job_release(job);
+    }
 }
 
-static mp_obj_t signature_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs)
+/* returns a Job for a**b (mod c), c odd, whose result is the int */
+static mp_obj_t mod_exptmod_start(mp_obj_t A_in, mp_obj_t B_in, mp_obj_t C_in)
 {
-    switch (op)
-    {
-    case MP_BINARY_OP_EQUAL:
+    UCRYPTO_STATS_API(NUMBER);
+    mp_job_t *job = new_job(job_exptmod_step, 2);
+    fp_int *a_fp_int = fp_alloc();
+    fp_int *c_fp_int = fp_alloc();
+
+    mp_fp_for_int(A_in, a_fp_int);
+    mp_fp_for_int(B_in, job->k);
+    mp_fp_for_int(C_in, c_fp_int);
+
+    if (fp_cmp_d(c_fp_int, 0) != FP_GT)
     {
-        if (!MP_OBJ_IS_TYPE(lhs, &signature_type) && !MP_OBJ_IS_TYPE(rhs, &signature_type))
-        {
-            mp_raise_TypeError(ERROR_EXPECTED_SIGNATURES);
-        }
-        mp_ecdsa_signature_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_ecdsa_signature_t *r = MP_OBJ_TO_PTR(rhs);
-        return mp_obj_new_bool(ec_signature_equal(l->ecdsa_signature, r->ecdsa_signature));
+        mp_raise_ValueError(ERROR_EXPTMOD_VALUE);
     }
-    default:
-        return MP_OBJ_NULL; // op not supported
+    // the montgomery reduce need odd modulus
+    if (fp_isodd(c_fp_int) != FP_YES)
+    {
+        mp_raise_ValueError(ERROR_JOB_ODD_MODULUS);
     }
-}
 
-static void signature_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
-{
-    mp_ecdsa_signature_t *self = MP_OBJ_TO_PTR(obj);
-    if (dest[0] == MP_OBJ_NULL)
+    fp_mod(a_fp_int, c_fp_int, a_fp_int);
+    if (fp_cmp_d(job->k, 0) == FP_LT)
     {
-        const mp_obj_type_t *type = mp_obj_get_type(obj);
-        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
-        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
-        if (elem != NULL)
+        // fp_invmod does not return for 0
+        if (fp_iszero(a_fp_int) || fp_invmod(a_fp_int, c_fp_int, a_fp_int) != FP_OKAY)
         {
-            if (attr == MP_QSTR_r)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecdsa_signature->r);
-                return;
-            }
-            else if (attr == MP_QSTR_s)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecdsa_signature->s);
-                return;
-            }
-            mp_convert_member_lookup(obj, type, elem->value, dest);
+            mp_raise_ValueError(ERROR_EXPTMOD_VALUE);
         }
+        fp_abs(job->k, job->k);
+    }
+
+    if (fp_cmp_d(c_fp_int, 1) == FP_EQ)
+    {
+        job->result = MP_OBJ_NEW_SMALL_INT(0);
+        job_release(job);
+        fp_free(c_fp_int);
+    }
+    else
+    {
+        // the modulus is owned by the job until job_release
+        fp_mont_init(&job->mont, c_fp_int);
+        fp_exptmod_mont_start(a_fp_int, &job->mont, job->r);
+        job->bit = job->k->used * DIGIT_BIT - 1;
     }
+
+    fp_free(a_fp_int);
+
+    return MP_OBJ_FROM_PTR(job);
 }
 
+static MP_DEFINE_CONST_FUN_OBJ_3(mod_exptmod_start_obj, mod_exptmod_start);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(mod_static_exptmod_start_obj, MP_ROM_PTR(&mod_exptmod_start_obj));
 
-/**
- * Calcula o parâmetro de recuperação `v` para assinaturas ECDSA compatíveis com Ethereum.
- *
- * @param R      Ponto R resultante de k * G na curva elíptica.
- * @param curve  Curva elíptica utilizada.
- * @param chainId Identificador da cadeia Ethereum (genérico).
- * @return       Valor de `v` calculado (27 + rec_id + chainId * 2).
- */
-static int calculate_recovery_id(ecc_point_t *R, ecc_curve_t *curve, int chainId) {
-    // Verifica se o ponto R está no ponto de identidade
-    if (fp_iszero(R->x) && fp_iszero(R->y)) {
-        // Não é possível recuperar a chave pública a partir do ponto de identidade
-        return -1;
+static mp_obj_t job_step(size_t n_args, const mp_obj_t *args)
+{
+    /*
+        n (int): iterations to run, one bit of the exponent or scalar each, returns True once the result is ready
+    */
+    mp_job_t *job = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t n = n_args > 1 ? mp_obj_get_int(args[1]) : 1;
+    if (n < 1)
+    {
+        mp_raise_ValueError(ERROR_JOB_STEPS);
+    }
+    if (job->result == MP_OBJ_NULL)
+    {
+        job->step(job, n);
     }
+    return mp_obj_new_bool(job->result != MP_OBJ_NULL);
+}
 
-    // Determina a paridade de y(R)
-    int rec_id = fp_tstbit(*R->y, 0) ? 1 : 0; // 1 se y(R) é ímpar, 0 se par
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(job_step_obj, 1, 2, job_step);
 
-    // Calcula v conforme EIP-155: v = rec_id + (chainId * 2 + 35)
-    // Onde rec_id é 0 ou 1
-    int v = rec_id + (chainId * 2) + 35;
+static mp_obj_t job_result(mp_obj_t self_in)
+{
+    mp_job_t *job = MP_OBJ_TO_PTR(self_in);
+    if (job->result == MP_OBJ_NULL)
+    {
+        mp_raise_ValueError(ERROR_JOB_NOT_DONE);
+    }
+    return job->result;
+}
 
-    return v;
+static MP_DEFINE_CONST_FUN_OBJ_1(job_result_obj, job_result);
+
+static void job_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_job_t *job = MP_OBJ_TO_PTR(self_in);
+    if (job->result == MP_OBJ_NULL)
+    {
+        mp_printf(print, "<Job %d bits left>", job->bit + 1);
+    }
+    else
+    {
+        mp_printf(print, "<Job done>");
+    }
 }
 
-static const mp_rom_map_elem_t signature_locals_dict_table[] = {
-    {MP_ROM_QSTR(MP_QSTR_s), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_r), MP_ROM_INT(0)},
+static const mp_rom_map_elem_t job_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_step), MP_ROM_PTR(&job_step_obj)},
+    {MP_ROM_QSTR(MP_QSTR_result), MP_ROM_PTR(&job_result_obj)},
 };
 
-static MP_DEFINE_CONST_DICT(signature_locals_dict, signature_locals_dict_table);
+static MP_DEFINE_CONST_DICT(job_locals_dict, job_locals_dict_table);
 
 MP_DEFINE_CONST_OBJ_TYPE(
-    signature_type,
-    MP_QSTR_Signature,
+    job_type,
+    MP_QSTR_Job,
     MP_TYPE_FLAG_NONE,
-    print, signature_print,
-    binary_op, signature_binary_op,
-    attr, signature_attr,
-    locals_dict, &signature_locals_dict);
+    print, job_print,
+    locals_dict, &job_locals_dict);
 
+static void number_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_printf(print, mp_obj_get_type_str(self_in));
+}
 
-/**
- * Definição do tipo SignatureETH.
- */
-
-static const mp_rom_map_elem_t signature_eth_locals_dict_table[] = {
-    {MP_ROM_QSTR(MP_QSTR_r), MP_ROM_PTR(&mp_type_int)},
-    {MP_ROM_QSTR(MP_QSTR_s), MP_ROM_PTR(&mp_type_int)},
-    {MP_ROM_QSTR(MP_QSTR_v_eth), MP_ROM_PTR(&mp_type_int)},
-    {MP_ROM_QSTR(MP_QSTR_chainId), MP_ROM_PTR(&mp_type_int)},
+static const mp_rom_map_elem_t number_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_ident), MP_ROM_PTR(&mod_static_ident_obj)},
+    {MP_ROM_QSTR(MP_QSTR_exptmod), MP_ROM_PTR(&mod_static_exptmod_obj)},
+    {MP_ROM_QSTR(MP_QSTR_exptmod_crt), MP_ROM_PTR(&mod_static_exptmod_crt_obj)},
+    {MP_ROM_QSTR(MP_QSTR_exptmod_start), MP_ROM_PTR(&mod_static_exptmod_start_obj)},
+    {MP_ROM_QSTR(MP_QSTR_fast_pow), MP_ROM_PTR(&mod_static_fast_pow_obj)},
+    {MP_ROM_QSTR(MP_QSTR_invmod), MP_ROM_PTR(&mod_static_invmod_obj)},
+    {MP_ROM_QSTR(MP_QSTR_gcd), MP_ROM_PTR(&mod_static_gcd_obj)},
+    {MP_ROM_QSTR(MP_QSTR_generate_prime), MP_ROM_PTR(&mod_static_generate_prime_obj)},
+    {MP_ROM_QSTR(MP_QSTR_is_prime), MP_ROM_PTR(&mod_static_is_prime_obj)},
+    {MP_ROM_QSTR(MP_QSTR_prime_search), MP_ROM_PTR(&mod_static_prime_search_obj)},
 };
-static MP_DEFINE_CONST_DICT(signature_eth_locals_dict, signature_eth_locals_dict_table);
 
- 
+static MP_DEFINE_CONST_DICT(number_locals_dict, number_locals_dict_table);
+
 MP_DEFINE_CONST_OBJ_TYPE(
-    signature_eth_type,
-    MP_QSTR_SignatureETH,
+    number_type,
+    MP_QSTR_NUMBER,
     MP_TYPE_FLAG_NONE,
-    print, signature_eth_print,
-    binary_op, signature_eth_binary_op,
-    attr, signature_eth_attr,
-    locals_dict, &signature_eth_locals_dict);
+    print, number_print,
+    locals_dict, &number_locals_dict);
 
-static bool ec_point_in_curve(ecc_point_t *point, ecc_curve_t *curve)
+////////////////////////////////////// RSA /////////////////////////////////////
+
+typedef struct _rsa_key_t
 {
-    int is_point_in_curve = 0;
-    fp_int *x = fp_alloc();
-    fp_int *y = fp_alloc();
-    fp_int *left = fp_alloc();
-    fp_int *right = fp_alloc();
-    fp_int *x_mul_x_mul_x = fp_alloc();
-    fp_int *curvea_mul_x = fp_alloc();
-    fp_int *left_minus_right_mod_curvep = fp_alloc();
+    int bits;
+    size_t bytes;
+    fp_int *n;
+    fp_int *e;
+    // NULL for a public key
+    fp_int *d;
+    // NULL without the CRT components
+    fp_int *p;
+    fp_int *q;
+    fp_int *dp;
+    fp_int *dq;
+    fp_int *qinv;
+    fp_mont_t mont_n;
+    fp_mont_t mont_p;
+    fp_mont_t mont_q;
+} rsa_key_t;
+
+typedef struct _mp_rsa_key_t
+{
+    mp_obj_base_t base;
+    rsa_key_t *rsa_key;
+} mp_rsa_key_t;
 
-    fp_copy(point->x, x);
-    fp_copy(point->y, y);
+const mp_obj_type_t rsa_key_type;
 
-    /*
-    left = y * y
-    right = (x * x * x) + (self.a * x) + self.b
-    return (left - right) % self.p == 0
-    */
+// m = c**d (mod n), through the CRT when the key has it
+static void rsa_private(rsa_key_t *key, fp_int *c, fp_int *m)
+{
+    if (key->qinv == NULL)
+    {
+        fp_exptmod_mont(c, key->d, &key->mont_n, m);
+        return;
+    }
 
-    // left = (y * y)
-    fp_sqr(y, left);
+    fp_int *m1 = fp_alloc();
+    fp_int *m2 = fp_alloc();
+    fp_int *t = fp_alloc();
 
-    //(x * x * x)
-    fp_mul(x, x, x_mul_x_mul_x);
-    fp_mul(x_mul_x_mul_x, x, x_mul_x_mul_x);
+    fp_exptmod_mont(c, key->dp, &key->mont_p, m1);
+    fp_exptmod_mont(c, key->dq, &key->mont_q, m2);
 
-    //(curve.a * x)
-    fp_mul(curve->a, x, curvea_mul_x);
+    // m = m2 + q * (qinv * (m1 - m2) mod p)
+    fp_submod(m1, m2, key->p, t);
+    fp_mulmod(t, key->qinv, key->p, t);
+    fp_mul(t, key->q, t);
+    fp_add(t, m2, m);
 
-    // right = (x * x * x) + (curve.a * x) + curve.b
-    fp_add(x_mul_x_mul_x, curvea_mul_x, right);
-    fp_add(right, curve->b, right);
+    // a fault in one half would leak a factor of n, check m**e = c
+    fp_exptmod_mont(m, key->e, &key->mont_n, t);
+    fp_mod(c, key->n, m1);
+    bool fault = fp_cmp(t, m1) != FP_EQ;
 
-    // return (left - right) % curve.p == 0
-    fp_submod(left, right, curve->p, left_minus_right_mod_curvep);
-    is_point_in_curve = (fp_iszero(left_minus_right_mod_curvep) == FP_YES);
-
-    fp_free(left);
-    fp_free(x_mul_x_mul_x);
-    fp_free(curvea_mul_x);
-    fp_free(right);
-    fp_free(left_minus_right_mod_curvep);
-    fp_free(x);
-    fp_free(y);
+    fp_free(m1);
+    fp_free(m2);
+    fp_free(t);
 
-    return is_point_in_curve;
+    if (fault)
+    {
+        mp_raise_ValueError(ERROR_RSA_CRT_FAULT);
+    }
 }
 
-static bool ec_curve_equal(ecc_curve_t *c1, ecc_curve_t *c2)
+// out = (in ** e or d) mod n, in and out of key->bytes bytes
+static void rsa_exptmod(rsa_key_t *key, const unsigned char *in, unsigned char *out, bool private)
 {
-    if (fp_cmp(c1->p, c2->p) != FP_EQ)
+    fp_int *x = fp_alloc();
+    fp_int *y = fp_alloc();
+
+    fp_read_unsigned_bin(x, (unsigned char *)in, key->bytes);
+    if (fp_cmp(x, key->n) != FP_LT)
     {
-        return false;
+        fp_free(x);
+        fp_free(y);
+        mp_raise_ValueError(ERROR_RSA_INPUT_RANGE);
     }
-    if (fp_cmp(c1->a, c2->a) != FP_EQ)
+    if (private)
     {
-        return false;
+        rsa_private(key, x, y);
     }
-    if (fp_cmp(c1->b, c2->b) != FP_EQ)
+    else
     {
-        return false;
+        fp_exptmod_mont(x, key->e, &key->mont_n, y);
     }
-    if (fp_cmp(c1->q, c2->q) != FP_EQ)
+    fp_to_unsigned_bin_len(y, out, key->bytes);
+
+    fp_zero(x);
+    fp_zero(y);
+    fp_free(x);
+    fp_free(y);
+}
+
+/*
+    PKCS#1 v1.5 unpadding of 0x00 || type || padding || 0x00 || value,
+    offset of value or -1, every byte is looked at whatever the result
+*/
+static int rsa_pkcs1_unpad(const unsigned char *em, size_t len, unsigned char type)
+{
+    int bad = (em[0] != 0x00) | (em[1] != type);
+    size_t zero = 0;
+    for (size_t i = 2; i < len; i++)
     {
-        return false;
+        // only the first 0x00 ends the padding
+        size_t is_end = (zero == 0) & (em[i] == 0x00);
+        zero |= is_end * i;
+        // padding of signatures is all 0xff
+        bad |= (type == 0x01) & (zero == 0) & (em[i] != 0xff);
     }
-    if (fp_cmp(c1->g->x, c2->g->x) != FP_EQ)
+    bad |= (zero == 0) | (zero < 10);
+    return bad ? -1 : (int)(zero + 1);
+}
+
+static rsa_key_t *rsa_key_get(mp_obj_t self_in)
+{
+    mp_rsa_key_t *self = MP_OBJ_TO_PTR(self_in);
+    return self->rsa_key;
+}
+
+static mp_obj_t rsa_key_sign(mp_obj_t self_in, mp_obj_t value)
+{
+    /*
+        value (buffer): returns 0x00 || 0x01 || 0xff... || 0x00 || value raised to d, as bytes
+    */
+    UCRYPTO_STATS_API(RSA);
+    rsa_key_t *key = rsa_key_get(self_in);
+    if (key->d == NULL && key->qinv == NULL)
     {
-        return false;
+        mp_raise_ValueError(ERROR_RSA_NOT_PRIVATE);
     }
-    if (fp_cmp(c1->g->y, c2->g->y) != FP_EQ)
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(value, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len + 11 > key->bytes)
     {
-        return false;
+        mp_raise_ValueError(ERROR_RSA_MESSAGE_TOO_LONG);
     }
-    return true;
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, key->bytes);
+    unsigned char *em = (unsigned char *)vstr.buf;
+    size_t len_padding = key->bytes - 3 - bufinfo.len;
+    em[0] = 0x00;
+    em[1] = 0x01;
+    memset(em + 2, 0xff, len_padding);
+    em[2 + len_padding] = 0x00;
+    memcpy(em + 3 + len_padding, bufinfo.buf, bufinfo.len);
+
+    rsa_exptmod(key, em, em, true);
+    return mp_obj_new_bytes_from_vstr(&vstr);
 }
 
-static mp_obj_t curve_equal(mp_obj_t curve1, mp_obj_t curve2)
+static MP_DEFINE_CONST_FUN_OBJ_2(rsa_key_sign_obj, rsa_key_sign);
+
+static mp_obj_t rsa_key_verify(mp_obj_t self_in, mp_obj_t signature)
 {
-    if (!MP_OBJ_IS_TYPE(curve1, &curve_type))
+    /*
+        signature (buffer): returns the signed value, raises ValueError if the padding is wrong
+    */
+    UCRYPTO_STATS_API(RSA);
+    rsa_key_t *key = rsa_key_get(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(signature, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len != key->bytes)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 1, mp_obj_get_type_str(curve1));
+        mp_raise_ValueError(ERROR_RSA_INPUT_LENGTH);
     }
-    if (!MP_OBJ_IS_TYPE(curve2, &curve_type))
+
+    unsigned char *em = m_new(unsigned char, key->bytes);
+    rsa_exptmod(key, bufinfo.buf, em, false);
+    int offset = rsa_pkcs1_unpad(em, key->bytes, 0x01);
+    mp_obj_t res = offset < 0 ? MP_OBJ_NULL : mp_obj_new_bytes(em + offset, key->bytes - offset);
+    m_del(unsigned char, em, key->bytes);
+
+    if (res == MP_OBJ_NULL)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve2));
+        mp_raise_ValueError(ERROR_RSA_PADDING);
     }
-
-    mp_curve_t *c1 = MP_OBJ_TO_PTR(curve1);
-    mp_curve_t *c2 = MP_OBJ_TO_PTR(curve2);
-    return mp_obj_new_bool(ec_curve_equal(c1->ecc_curve, c2->ecc_curve));
+    return res;
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_2(curve_equal_obj, curve_equal);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve_equal_obj, MP_ROM_PTR(&curve_equal_obj));
+static MP_DEFINE_CONST_FUN_OBJ_2(rsa_key_verify_obj, rsa_key_verify);
 
-static mp_obj_t point_in_curve(mp_obj_t point, mp_obj_t curve)
+static mp_obj_t rsa_key_encrypt(mp_obj_t self_in, mp_obj_t value)
 {
-    if (!MP_OBJ_IS_TYPE(point, &point_type))
+    /*
+        value (buffer): returns 0x00 || 0x02 || random non zero || 0x00 || value raised to e, as bytes
+    */
+    UCRYPTO_STATS_API(RSA);
+    rsa_key_t *key = rsa_key_get(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(value, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len + 11 > key->bytes)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
+        mp_raise_ValueError(ERROR_RSA_MESSAGE_TOO_LONG);
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+
+    // padding from os.urandom, zeros drawn again
+    size_t len_padding = key->bytes - 3 - bufinfo.len;
+    mp_obj_t os = mp_import_name(MP_QSTR_os, mp_const_none, MP_OBJ_NEW_SMALL_INT(0));
+    mp_obj_t urandom = mp_load_attr(os, MP_QSTR_urandom);
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, key->bytes);
+    unsigned char *em = (unsigned char *)vstr.buf;
+    em[0] = 0x00;
+    em[1] = 0x02;
+    size_t filled = 0;
+    while (filled < len_padding)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve));
+        mp_buffer_info_t rnd;
+        mp_get_buffer_raise(mp_call_function_1(urandom, MP_OBJ_NEW_SMALL_INT(len_padding - filled)), &rnd, MP_BUFFER_READ);
+        for (size_t i = 0; i < rnd.len && filled < len_padding; i++)
+        {
+            if (((unsigned char *)rnd.buf)[i] != 0x00)
+            {
+                em[2 + filled++] = ((unsigned char *)rnd.buf)[i];
+            }
+        }
     }
+    em[2 + len_padding] = 0x00;
+    memcpy(em + 3 + len_padding, bufinfo.buf, bufinfo.len);
 
-    mp_point_t *p = MP_OBJ_TO_PTR(point);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
-    return mp_obj_new_bool(ec_point_in_curve(p->ecc_point, c->ecc_curve));
+    rsa_exptmod(key, em, em, false);
+    return mp_obj_new_bytes_from_vstr(&vstr);
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_2(point_in_curve_obj, point_in_curve);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_in_curve_obj, MP_ROM_PTR(&point_in_curve_obj));
-
-static void curve_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
-{
-    (void)kind;
-    mp_curve_t *self = MP_OBJ_TO_PTR(self_in);
-    vstr_t vstr_oid;
-    vstr_hexlify(&vstr_oid, (const byte *)vstr_str(&self->ecc_curve->oid), vstr_len(&self->ecc_curve->oid));
-    vstr_t *ecc_curve_p = vstr_new_from_fp(self->ecc_curve->p);
-    vstr_t *ecc_curve_a = vstr_new_from_fp(self->ecc_curve->a);
-    vstr_t *ecc_curve_b = vstr_new_from_fp(self->ecc_curve->b);
-    vstr_t *ecc_curve_q = vstr_new_from_fp(self->ecc_curve->q);
-    vstr_t *ecc_curve_g_x = vstr_new_from_fp(self->ecc_curve->g->x);
-    vstr_t *ecc_curve_g_y = vstr_new_from_fp(self->ecc_curve->g->y);
-    mp_printf(print, "<Curve name=%s oid=%s p=%s a=%s b=%s q=%s gx=%s gy=%s>", vstr_str(&self->ecc_curve->name), vstr_str(&vstr_oid), vstr_str(ecc_curve_p), vstr_str(ecc_curve_a), vstr_str(ecc_curve_b), vstr_str(ecc_curve_q), vstr_str(ecc_curve_g_x), vstr_str(ecc_curve_g_y));
-    vstr_free(ecc_curve_p);
-    vstr_free(ecc_curve_a);
-    vstr_free(ecc_curve_b);
-    vstr_free(ecc_curve_q);
-    vstr_free(ecc_curve_g_x);
-    vstr_free(ecc_curve_g_y);
-}
+static MP_DEFINE_CONST_FUN_OBJ_2(rsa_key_encrypt_obj, rsa_key_encrypt);
 
-static mp_obj_t curve_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs)
+static mp_obj_t rsa_key_decrypt(mp_obj_t self_in, mp_obj_t ciphertext)
 {
-    switch (op)
-    {
-    case MP_BINARY_OP_EQUAL:
+    /*
+        ciphertext (buffer): returns the encrypted value, raises ValueError if the padding is wrong
+    */
+    UCRYPTO_STATS_API(RSA);
+    rsa_key_t *key = rsa_key_get(self_in);
+    if (key->d == NULL && key->qinv == NULL)
     {
-        if (!MP_OBJ_IS_TYPE(lhs, &curve_type) && !MP_OBJ_IS_TYPE(rhs, &curve_type))
-        {
-            mp_raise_TypeError(ERROR_EXPECTED_CURVES);
-        }
-        mp_curve_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_curve_t *r = MP_OBJ_TO_PTR(rhs);
-        return curve_equal(MP_OBJ_FROM_PTR(l), MP_OBJ_FROM_PTR(r));
+        mp_raise_ValueError(ERROR_RSA_NOT_PRIVATE);
     }
-    case MP_BINARY_OP_CONTAINS:
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(ciphertext, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len != key->bytes)
     {
-        if (!MP_OBJ_IS_TYPE(lhs, &curve_type))
-        {
-            mp_raise_TypeError(ERROR_LEFT_EXPECTED_CURVE);
-        }
-        if (!MP_OBJ_IS_TYPE(rhs, &point_type))
-        {
-            mp_raise_TypeError(ERROR_RIGHT_EXPECTED_POINT);
-        }
-        mp_curve_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
-        return point_in_curve(MP_OBJ_FROM_PTR(r), MP_OBJ_FROM_PTR(l));
+        mp_raise_ValueError(ERROR_RSA_INPUT_LENGTH);
     }
-    default:
-        return MP_OBJ_NULL; // op not supported
+
+    unsigned char *em = m_new(unsigned char, key->bytes);
+    rsa_exptmod(key, bufinfo.buf, em, true);
+    int offset = rsa_pkcs1_unpad(em, key->bytes, 0x02);
+    mp_obj_t res = offset < 0 ? MP_OBJ_NULL : mp_obj_new_bytes(em + offset, key->bytes - offset);
+    memset(em, 0, key->bytes);
+    m_del(unsigned char, em, key->bytes);
+
+    if (res == MP_OBJ_NULL)
+    {
+        mp_raise_ValueError(ERROR_RSA_PADDING);
     }
+    return res;
 }
 
-static void curve_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
+static MP_DEFINE_CONST_FUN_OBJ_2(rsa_key_decrypt_obj, rsa_key_decrypt);
+
+static void rsa_key_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
 {
-    mp_curve_t *self = MP_OBJ_TO_PTR(obj);
+    (void)kind;
+    rsa_key_t *key = rsa_key_get(self_in);
+    mp_printf(print, "<RSAKey bits=%d private=%s crt=%s>", key->bits,
+              (key->d != NULL || key->qinv != NULL) ? "True" : "False", key->qinv != NULL ? "True" : "False");
+}
+
+static void rsa_key_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
+{
+    rsa_key_t *key = rsa_key_get(obj);
     if (dest[0] == MP_OBJ_NULL)
     {
         const mp_obj_type_t *type = mp_obj_get_type(obj);
@@ -1054,1506 +1870,6940 @@ static void curve_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
         mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
         if (elem != NULL)
         {
-            if (attr == MP_QSTR_p)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->p);
-                return;
-            }
-            else if (attr == MP_QSTR_a)
+            if (attr == MP_QSTR_n)
             {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->a);
+                dest[0] = mp_obj_new_int_from_fp(key->n);
                 return;
             }
-            else if (attr == MP_QSTR_b)
+            else if (attr == MP_QSTR_e)
             {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->b);
+                dest[0] = mp_obj_new_int_from_fp(key->e);
                 return;
             }
-            else if (attr == MP_QSTR_q)
+            else if (attr == MP_QSTR_bits)
             {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->q);
-                return;
-            }
-            else if (attr == MP_QSTR_G)
-            {
-                mp_point_t *pr = new_point_init_copy(self);
-                dest[0] = pr;
-                return;
-            }
-            else if (attr == MP_QSTR_gx)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->g->x);
-                return;
-            }
-            else if (attr == MP_QSTR_gy)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->g->y);
-                return;
-            }
-            else if (attr == MP_QSTR_name)
-            {
-                dest[0] = mp_obj_new_str_of_type(&mp_type_str, (const byte *)vstr_str(&self->ecc_curve->name), vstr_len(&self->ecc_curve->name));
-                return;
-            }
-            else if (attr == MP_QSTR_oid)
-            {
-                dest[0] = mp_obj_new_str_of_type(&mp_type_bytes, (const byte *)vstr_str(&self->ecc_curve->oid), vstr_len(&self->ecc_curve->oid));
+                dest[0] = mp_obj_new_int(key->bits);
                 return;
             }
             mp_convert_member_lookup(obj, type, elem->value, dest);
         }
     }
-    else
-    {
-        if ((attr == MP_QSTR_p || attr == MP_QSTR_a || attr == MP_QSTR_b || attr == MP_QSTR_q || attr == MP_QSTR_gx || attr == MP_QSTR_gy) && !MP_OBJ_IS_INT(dest[1]))
-        {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT, mp_obj_get_type_str(dest[1]));
-        }
-        else if (attr == MP_QSTR_G && !MP_OBJ_IS_TYPE(dest[1], &point_type))
-        {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_BUT, mp_obj_get_type_str(dest[1]));
-        }
-        else if ((attr == MP_QSTR_name || attr == MP_QSTR_oid) && !MP_OBJ_IS_STR_OR_BYTES(dest[1]))
-        {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(dest[1]));
-        }
-
-        if (attr == MP_QSTR_p)
-        {
-            mp_fp_for_int(dest[1], self->ecc_curve->p);
-        }
-        else if (attr == MP_QSTR_a)
-        {
-            mp_fp_for_int(dest[1], self->ecc_curve->a);
-        }
-        else if (attr == MP_QSTR_b)
-        {
-            mp_fp_for_int(dest[1], self->ecc_curve->b);
-        }
-        else if (attr == MP_QSTR_q)
-        {
-            mp_fp_for_int(dest[1], self->ecc_curve->q);
-        }
-        else if (attr == MP_QSTR_G)
-        {
-            mp_point_t *other = MP_OBJ_TO_PTR(dest[1]);
-
-            self->ecc_curve = m_new_obj(ecc_curve_t);
-            self->ecc_curve->p = fp_alloc();
-            self->ecc_curve->a = fp_alloc();
-            self->ecc_curve->b = fp_alloc();
-            self->ecc_curve->q = fp_alloc();
-            self->ecc_curve->g = m_new_obj(ecc_point_t);
-            self->ecc_curve->g->x = fp_alloc();
-            self->ecc_curve->g->y = fp_alloc();
-
-            fp_copy(other->ecc_curve->p, self->ecc_curve->p);
-            fp_copy(other->ecc_curve->a, self->ecc_curve->a);
-            fp_copy(other->ecc_curve->b, self->ecc_curve->b);
-            fp_copy(other->ecc_curve->q, self->ecc_curve->q);
-            fp_copy(other->ecc_point->x, self->ecc_curve->g->x);
-            fp_copy(other->ecc_point->y, self->ecc_curve->g->y);
-        }
-        else if (attr == MP_QSTR_gx)
-        {
-            mp_fp_for_int(dest[1], self->ecc_curve->g->x);
-        }
-        else if (attr == MP_QSTR_gy)
-        {
-            mp_fp_for_int(dest[1], self->ecc_curve->g->y);
-        }
-        else if (attr == MP_QSTR_name)
-        {
-            mp_buffer_info_t bufinfo_name;
-            mp_get_buffer_raise(dest[1], &bufinfo_name, MP_BUFFER_READ);
-            vstr_init(&self->ecc_curve->name, bufinfo_name.len);
-            vstr_add_strn(&self->ecc_curve->name, bufinfo_name.buf, bufinfo_name.len);
-        }
-        else if (attr == MP_QSTR_oid)
-        {
-            mp_buffer_info_t bufinfo_oid;
-            mp_get_buffer_raise(dest[1], &bufinfo_oid, MP_BUFFER_READ);
+}
 
-            if (MP_OBJ_IS_TYPE(dest[1], &mp_type_bytes))
-            {
-                vstr_init(&self->ecc_curve->oid, bufinfo_oid.len);
-                vstr_add_strn(&self->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
-            }
-            else if (MP_OBJ_IS_STR(dest[1]))
-            {
-                vstr_unhexlify(&self->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
-            }
-        }
-        else
-        {
-            return;
-        }
-        dest[0] = MP_OBJ_NULL; // indicate success
+// None is taken only for the optional fields, the required n and e raise as any other non int
+static void rsa_key_fp_arg(mp_obj_t o, fp_int **a, int index, bool optional)
+{
+    if (optional && o == mp_const_none)
+    {
+        *a = NULL;
+        return;
+    }
+    if (!MP_OBJ_IS_INT(o))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, index, mp_obj_get_type_str(o));
     }
+    *a = fp_alloc();
+    mp_fp_for_int(o, *a);
 }
 
-static const mp_rom_map_elem_t curve_locals_dict_table[] = {
-    {MP_ROM_QSTR(MP_QSTR_p), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_a), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_b), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_q), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_G), MP_ROM_PTR(mp_const_none)},
-    {MP_ROM_QSTR(MP_QSTR_gx), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_gy), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_name), MP_ROM_PTR(mp_const_none)},
-    {MP_ROM_QSTR(MP_QSTR_oid), MP_ROM_PTR(mp_const_none)},
-};
-
-static MP_DEFINE_CONST_DICT(curve_locals_dict, curve_locals_dict_table);
-
-MP_DEFINE_CONST_OBJ_TYPE(
-    curve_type,
-    MP_QSTR_Curve,
-    MP_TYPE_FLAG_NONE,
-    print, curve_print,
-    binary_op, curve_binary_op,
-    attr, curve_attr,
-    locals_dict, &curve_locals_dict);
-
-static mp_obj_t curve(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+static mp_obj_t rsa_key_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
 {
-    /*
-        Currently only curves in Weierstrass form (y^2 = x^3 + ax + b (mod p))
-
-        p (int): The value of math p in the curve equation
-        a (int): The value of math a in the curve equation
-        b (int): The value of math b in the curve equation
-        q (int): The order of the base point of the curve
-        gx (int): The x coordinate of the base point of the curve
-        gy (int): The y coordinate of the base point of the curve
-        name (str): The name of the curve
-        oid (str/bytes): The object identifier of the curve
-    */
-
     static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_n, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_e, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_d, MP_ARG_OBJ, {.u_obj = mp_const_none}},
         {MP_QSTR_p, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_a, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_b, MP_ARG_OBJ, {.u_obj = mp_const_none}},
         {MP_QSTR_q, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_gx, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_gy, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_name, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_oid, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_dp, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_dq, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_qinv, MP_ARG_OBJ, {.u_obj = mp_const_none}},
     };
 
     struct
     {
-        mp_arg_val_t p, a, b, q, gx, gy, name, oid;
+        mp_arg_val_t n, e, d, p, q, dp, dq, qinv;
     } args;
-    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
-
-    mp_curve_t *curve = m_new_obj(mp_curve_t);
-    curve->base.type = &curve_type;
-    curve->ecc_curve = m_new_obj(ecc_curve_t);
-    curve->ecc_curve->p = fp_alloc();
-    curve->ecc_curve->a = fp_alloc();
-    curve->ecc_curve->b = fp_alloc();
-    curve->ecc_curve->q = fp_alloc();
-    curve->ecc_curve->g = m_new_obj(ecc_point_t);
-    curve->ecc_curve->g->x = fp_alloc();
-    curve->ecc_curve->g->y = fp_alloc();
+    mp_map_t kw_args;
+    mp_map_init_fixed_table(&kw_args, n_kw, all_args + n_args);
+    mp_arg_parse_all(n_args, all_args, &kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    rsa_key_t *key = m_new0(rsa_key_t, 1);
+    rsa_key_fp_arg(args.n.u_obj, &key->n, 1, false);
+    rsa_key_fp_arg(args.e.u_obj, &key->e, 2, false);
+    rsa_key_fp_arg(args.d.u_obj, &key->d, 3, true);
+    rsa_key_fp_arg(args.p.u_obj, &key->p, 4, true);
+    rsa_key_fp_arg(args.q.u_obj, &key->q, 5, true);
+    rsa_key_fp_arg(args.dp.u_obj, &key->dp, 6, true);
+    rsa_key_fp_arg(args.dq.u_obj, &key->dq, 7, true);
+    rsa_key_fp_arg(args.qinv.u_obj, &key->qinv, 8, true);
+
+    // the montgomery reduce need odd modulus, fp_mul needs room for n^2
+    if (fp_isodd(key->n) != FP_YES || key->n->used > FP_SIZE / 2)
+    {
+        mp_raise_ValueError(ERROR_RSA_MODULUS);
+    }
+    if (key->p == NULL || key->q == NULL || key->dp == NULL || key->dq == NULL || key->qinv == NULL)
+    {
+        fp_free(key->p);
+        fp_free(key->q);
+        fp_free(key->dp);
+        fp_free(key->dq);
+        fp_free(key->qinv);
+        key->p = key->q = key->dp = key->dq = key->qinv = NULL;
+    }
+    else if (fp_isodd(key->p) != FP_YES || fp_isodd(key->q) != FP_YES)
+    {
+        mp_raise_ValueError(ERROR_CRT_ODD_PRIMES);
+    }
 
-    vstr_init(&curve->ecc_curve->name, 0);
-    vstr_init(&curve->ecc_curve->oid, 0);
-    for (size_t i = 0; i < n_args; i++)
+    key->bits = fp_count_bits(key->n);
+    key->bytes = (key->bits + 7) / 8;
+    fp_mont_init(&key->mont_n, key->n);
+    if (key->qinv != NULL)
     {
-        if (!MP_OBJ_IS_INT(pos_args[i]))
-        {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(pos_args[i]), i);
-        }
+        fp_mont_init(&key->mont_p, key->p);
+        fp_mont_init(&key->mont_q, key->q);
     }
 
-    mp_fp_for_int(args.p.u_obj, curve->ecc_curve->p);
-    mp_fp_for_int(args.a.u_obj, curve->ecc_curve->a);
-    mp_fp_for_int(args.b.u_obj, curve->ecc_curve->b);
-    mp_fp_for_int(args.q.u_obj, curve->ecc_curve->q);
-    mp_fp_for_int(args.gx.u_obj, curve->ecc_curve->g->x);
-    mp_fp_for_int(args.gy.u_obj, curve->ecc_curve->g->y);
+    mp_rsa_key_t *self = m_new_obj(mp_rsa_key_t);
+    self->base.type = type;
+    self->rsa_key = key;
+    return MP_OBJ_FROM_PTR(self);
+}
 
-    if (args.name.u_obj != mp_const_none)
+static const mp_rom_map_elem_t rsa_key_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_n), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_e), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_bits), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_sign), MP_ROM_PTR(&rsa_key_sign_obj)},
+    {MP_ROM_QSTR(MP_QSTR_verify), MP_ROM_PTR(&rsa_key_verify_obj)},
+    {MP_ROM_QSTR(MP_QSTR_encrypt), MP_ROM_PTR(&rsa_key_encrypt_obj)},
+    {MP_ROM_QSTR(MP_QSTR_decrypt), MP_ROM_PTR(&rsa_key_decrypt_obj)},
+};
+
+static MP_DEFINE_CONST_DICT(rsa_key_locals_dict, rsa_key_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    rsa_key_type,
+    MP_QSTR_RSAKey,
+    MP_TYPE_FLAG_NONE,
+    make_new, rsa_key_make_new,
+    print, rsa_key_print,
+    attr, rsa_key_attr,
+    locals_dict, &rsa_key_locals_dict);
+
+////////////////////////////////////// DER /////////////////////////////////////
+
+/*
+    The subset of DER that signatures and EC keys use, read in place from
+    the caller's buffer: definite lengths in their shortest form, INTEGERs
+    non-negative and minimal. A parse stops at the first deviation.
+*/
+#define DER_INTEGER (0x02)
+#define DER_BIT_STRING (0x03)
+#define DER_OCTET_STRING (0x04)
+#define DER_OID (0x06)
+#define DER_SEQUENCE (0x30)
+#define DER_CONTEXT(n) (0xA0 | (n))
+
+typedef struct _der_t
+{
+    const byte *p;
+    const byte *end;
+} der_t;
+
+static bool der_next(der_t *der, byte *tag, der_t *content)
+{
+    if (der->end - der->p < 2)
     {
-        if (!MP_OBJ_IS_STR_OR_BYTES(args.name.u_obj))
-        {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(args.name.u_obj));
-        }
-        else
-        {
-            mp_buffer_info_t bufinfo_name;
-            mp_get_buffer_raise(args.name.u_obj, &bufinfo_name, MP_BUFFER_READ);
-            vstr_add_strn(&curve->ecc_curve->name, bufinfo_name.buf, bufinfo_name.len);
-        }
+        return false;
     }
-
-    if (args.oid.u_obj != mp_const_none)
+    *tag = der->p[0];
+    size_t len = der->p[1];
+    const byte *p = der->p + 2;
+    if (len & 0x80)
     {
-        if (!MP_OBJ_IS_STR_OR_BYTES(args.oid.u_obj))
+        // up to 3 length bytes, no leading zero, a short form length would have fit
+        size_t n = len & 0x7F;
+        if (n == 0 || n > 3 || (size_t)(der->end - p) < n || p[0] == 0)
         {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(args.oid.u_obj));
+            return false;
         }
-        else
+        len = 0;
+        for (size_t i = 0; i < n; i++)
         {
-            mp_buffer_info_t bufinfo_oid;
-            mp_get_buffer_raise(args.oid.u_obj, &bufinfo_oid, MP_BUFFER_READ);
-
-            if (MP_OBJ_IS_TYPE(args.oid.u_obj, &mp_type_bytes))
-            {
-                vstr_init(&curve->ecc_curve->oid, bufinfo_oid.len);
-                vstr_add_strn(&curve->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
-            }
-            else if (MP_OBJ_IS_STR(args.oid.u_obj))
-            {
-                vstr_unhexlify(&curve->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
-            }
+            len = (len << 8) | p[i];
+        }
+        p += n;
+        if (len < 0x80)
+        {
+            return false;
         }
     }
-
-    return MP_OBJ_FROM_PTR(curve);
+    if ((size_t)(der->end - p) < len)
+    {
+        return false;
+    }
+    content->p = p;
+    content->end = p + len;
+    der->p = p + len;
+    return true;
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_KW(curve_obj, 6, curve);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve_obj, MP_ROM_PTR(&curve_obj));
+static bool der_expect(der_t *der, byte tag, der_t *content)
+{
+    byte t;
+    return der_next(der, &t, content) && t == tag;
+}
 
-///////////////////////////////////// Point ////////////////////////////////////
+// the next element only if it has this tag
+static bool der_optional(der_t *der, byte tag, der_t *content)
+{
+    return der->p < der->end && der->p[0] == tag && der_expect(der, tag, content);
+}
 
-static bool ec_point_equal(ecc_point_t *p1, ecc_point_t *p2)
+// a = INTEGER of at most max_bytes bytes, besides the zero in front of a set high bit
+static bool der_read_integer(der_t *der, fp_int *a, size_t max_bytes)
 {
-    // check x coords
-    if (fp_cmp(p1->x, p2->x) != FP_EQ)
+    der_t c;
+    if (!der_expect(der, DER_INTEGER, &c) || c.p == c.end || (c.p[0] & 0x80))
     {
         return false;
     }
-    // check y coords
-    if (fp_cmp(p1->y, p2->y) != FP_EQ)
+    if (c.p[0] == 0 && c.end - c.p > 1)
+    {
+        if (!(c.p[1] & 0x80))
+        {
+            return false;
+        }
+        c.p++;
+    }
+    if ((size_t)(c.end - c.p) > max_bytes)
     {
         return false;
     }
+    fp_read_unsigned_bin(a, (unsigned char *)c.p, c.end - c.p);
     return true;
 }
 
-static void ec_point_double(ecc_point_t *rop, ecc_point_t *op, ecc_curve_t *curve)
+// bytes of an element with len bytes of content
+static size_t der_size(size_t len)
 {
-    if (fp_cmp_d(op->x, 0) == FP_EQ && fp_cmp_d(op->y, 0) == FP_EQ)
+    return len + (len < 0x80 ? 2 : len < 0x100 ? 3 : len < 0x10000 ? 4 : 5);
+}
+
+static byte *der_write_header(byte *buf, byte tag, size_t len)
+{
+    *buf++ = tag;
+    if (len < 0x80)
     {
-        fp_set(rop->x, 0);
-        fp_set(rop->y, 0);
-        return;
+        *buf++ = (byte)len;
+        return buf;
+    }
+    size_t n = len < 0x100 ? 1 : len < 0x10000 ? 2 : 3;
+    *buf++ = 0x80 | n;
+    for (size_t i = n; i-- > 0;)
+    {
+        *buf++ = (byte)(len >> (8 * i));
     }
+    return buf;
+}
 
-    fp_int *numer = fp_alloc();
-    fp_int *denom = fp_alloc();
-    fp_int *lambda = fp_alloc();
+// content bytes of the INTEGER a >= 0, a zero in front of a set high bit
+static size_t der_integer_len(fp_int *a)
+{
+    return fp_count_bits(a) / 8 + 1;
+}
 
-    // calculate lambda
-    fp_mul(op->x, op->x, numer);
-    fp_mul_d(numer, 3, numer);
-    fp_add(numer, curve->a, numer);
-    fp_mul_d(op->y, 2, denom);
-
-    // handle 2P = identity case
-    if (fp_invmod(denom, curve->p, denom) != FP_OKAY)
-    {
-        fp_set(rop->x, 0);
-        fp_set(rop->y, 0);
-
-        fp_free(numer);
-        fp_free(denom);
-        fp_free(lambda);
-        return;
-    }
-
-    fp_mul(numer, denom, lambda);
-    fp_mod(lambda, curve->p, lambda);
-
-    // calculate resulting x coord
-    fp_mul(lambda, lambda, rop->x);
-    fp_sub(rop->x, op->x, rop->x);
-    fp_sub(rop->x, op->x, rop->x);
-    fp_mod(rop->x, curve->p, rop->x);
-
-    // calculate resulting y coord
-    fp_sub(op->x, rop->x, rop->y);
-    fp_mul(lambda, rop->y, rop->y);
-    fp_sub(rop->y, op->y, rop->y);
-    fp_mod(rop->y, curve->p, rop->y);
-
-    fp_free(numer);
-    fp_free(denom);
-    fp_free(lambda);
+static byte *der_write_integer(byte *buf, fp_int *a)
+{
+    size_t len = der_integer_len(a);
+    buf = der_write_header(buf, DER_INTEGER, len);
+    fp_to_unsigned_bin_len(a, buf, len);
+    return buf + len;
 }
 
-static void ec_point_add(ecc_point_t *rop, ecc_point_t *op1, ecc_point_t *op2, ecc_curve_t *curve)
+// point in a prime field
+typedef struct _ecc_point_t
 {
-    // handle the identity element
-    if (fp_cmp_d(op1->x, 0) == FP_EQ && fp_cmp_d(op1->y, 0) == FP_EQ && fp_cmp_d(op2->x, 0) == FP_EQ && fp_cmp_d(op2->y, 0) == FP_EQ)
-    {
-        fp_set(rop->x, 0);
-        fp_set(rop->y, 0);
-        return;
-    }
-    else if (fp_cmp_d(op1->x, 0) == FP_EQ && fp_cmp_d(op1->y, 0) == FP_EQ)
-    {
-        fp_copy(op2->x, rop->x);
-        fp_copy(op2->y, rop->y);
-        return;
-    }
-    else if (fp_cmp_d(op2->x, 0) == FP_EQ && fp_cmp_d(op2->y, 0) == FP_EQ)
-    {
-        fp_copy(op1->x, rop->x);
-        fp_copy(op1->y, rop->y);
-        return;
-    }
-
-    if (ec_point_equal(op1, op2))
-    {
-        ec_point_double(rop, op1, curve);
-        return;
-    }
-
-    // check if points sum to identity element
-    fp_int *negy = fp_alloc();
-
-    fp_sub(curve->p, op2->y, negy);
-    if (fp_cmp(op1->x, op2->x) == FP_EQ && fp_cmp(op1->y, negy) == 0)
-    {
-        fp_set(rop->x, 0);
-        fp_set(rop->y, 0);
+    fp_int *x;
+    fp_int *y;
+} ecc_point_t;
 
-        fp_free(negy);
-        return;
-    }
+// point in jacobian coordinates, (x, y, z) represents the affine point (x/z^2, y/z^3), z = 0 is the identity
+typedef struct _ecc_jacobian_point_t
+{
+    fp_int *x;
+    fp_int *y;
+    fp_int *z;
+} ecc_jacobian_point_t;
 
-    fp_int *xdiff = fp_alloc();
-    fp_int *ydiff = fp_alloc();
-    fp_int *lambda = fp_alloc();
+// fixed-base comb table for the generator, teeth * spacing >= bits of q
+typedef struct _ecc_comb_t
+{
+    int teeth;
+    int spacing;
+    int digits;
+    // (2^teeth - 1) affine points, x then y, each stored in 'digits' fp_digit's
+    fp_digit *table;
+} ecc_comb_t;
+
+// odd multiples table of a point for wNAF, see ec_wnaf_key_build
+typedef struct _ecc_wnaf_key_t
+{
+    int w;
+    int digits;
+    // 2^(w-2) affine points P, 3P, 5P, ..., x then y, each stored in 'digits' fp_digit's
+    fp_digit *table;
+} ecc_wnaf_key_t;
+
+// stack of preallocated fp_int's for the temporaries of the EC primitives
+typedef struct _ecc_scratch_t
+{
+    // blocks of EC_SCRATCH_BLOCK fp_int's, they never move once allocated
+    fp_int **blocks;
+    size_t nblocks;
+    size_t capacity;
+    size_t used;
+    bool busy;
+    // set while a loop runs with the GIL released, see ec_scratch_gil_exit
+    bool nogil;
+} ecc_scratch_t;
+
+// data computed lazily from the curve parameters, shared by all copies of a curve
+typedef struct _ecc_curve_precomp_t
+{
+    int field;
+    int a_kind;
+    // Montgomery constants, 1 and a in the field representation
+    fp_digit mp;
+    fp_int *r2;
+    fp_int *one;
+    fp_int *a;
+    ecc_comb_t *comb;
+    // odd multiples of G, for the verifications with a prepared public key
+    ecc_wnaf_key_t *wnaf;
+    ecc_scratch_t *scratch;
+} ecc_curve_precomp_t;
 
-    // calculate lambda
-    fp_sub(op2->y, op1->y, ydiff);
-    fp_sub(op2->x, op1->x, xdiff);
-    fp_invmod(xdiff, curve->p, xdiff);
-    fp_mul(ydiff, xdiff, lambda);
-    fp_mod(lambda, curve->p, lambda);
+// curve over a prime field
+typedef struct _ecc_curve_t
+{
+    fp_int *p;
+    fp_int *a;
+    fp_int *b;
+    fp_int *q;
+    ecc_point_t *g;
+    vstr_t name;
+    vstr_t oid;
+    ecc_curve_precomp_t *precomp;
+} ecc_curve_t;
 
-    // calculate resulting x coord
-    fp_mul(lambda, lambda, rop->x);
-    fp_sub(rop->x, op1->x, rop->x);
-    fp_sub(rop->x, op2->x, rop->x);
-    fp_mod(rop->x, curve->p, rop->x);
+typedef struct _ecdsa_signature_t
+{
+    fp_int *r;
+    fp_int *s;
+} ecdsa_signature_t;
 
-    // calculate resulting y coord
-    fp_sub(op1->x, rop->x, rop->y);
-    fp_mul(lambda, rop->y, rop->y);
-    fp_sub(rop->y, op1->y, rop->y);
-    fp_mod(rop->y, curve->p, rop->y);
+typedef struct _ecdsa_signature_teth {
+    fp_int *r;
+    fp_int *s;
+    int v; // Adiciona o parâmetro de recuperação
+    int chainId;
+} ecdsa_signature_teth;
 
-    fp_free(xdiff);
-    fp_free(ydiff);
-    fp_free(lambda);
-    fp_free(negy);
-}
+typedef struct _mp_curve_t
+{
+    mp_obj_base_t base;
+    ecc_curve_t *ecc_curve;
+} mp_curve_t;
 
-static void ec_point_mul(ecc_point_t *rop, ecc_point_t *point, fp_int scalar, ecc_curve_t *curve)
+typedef struct _mp_point_t
 {
-    // handle the identity element
-    if (fp_cmp_d(point->x, 0) == FP_EQ && fp_cmp_d(point->y, 0) == FP_EQ)
-    {
-        fp_set(rop->x, 0);
-        fp_set(rop->y, 0);
-        return;
-    }
+    mp_obj_base_t base;
+    // affine coordinates, expanded with mp_point_load to compute with
+    fp_compact_t *x;
+    fp_compact_t *y;
+    // shared with the Curve and the other points on it, see curve_attr
+    ecc_curve_t *ecc_curve;
+    // result of an operator in the field representation, x and y are unset until mp_point_affine
+    ecc_jacobian_point_t *jacobian;
+} mp_point_t;
 
-    bool scalar_is_negative = false;
-    if (fp_cmp_d(&scalar, 2) == FP_EQ)
-    {
-        ec_point_double(rop, point, curve);
-        return;
-    }
+typedef struct _mp_ecdsa_signature_t
+{
+    mp_obj_base_t base;
+    fp_compact_t *r;
+    fp_compact_t *s;
+} mp_ecdsa_signature_t;
 
-    if (fp_cmp_d(&scalar, 0) == FP_LT)
-    {
-        scalar_is_negative = true;
-    }
 
-    fp_int *point_y_fp_int = fp_alloc();
+typedef struct _mp_ecdsa_signature_eth_t {
+    mp_obj_base_t base;
+    fp_compact_t *r;
+    fp_compact_t *s;
+    int v;
+    int chainId;
+} mp_ecdsa_signature_eth_t;
 
-    if (scalar_is_negative)
-    {
-        // copy point.y
-        fp_copy(point->y, point_y_fp_int);
-        // -point.y % curve.p
-        fp_neg(point->y, point->y);
-        fp_mod(point->y, curve->p, point->y);
+typedef struct _mp_public_key_t
+{
+    mp_obj_base_t base;
+    // the point, validated once, and its odd multiples in the field representation of the curve
+    fp_compact_t *x;
+    fp_compact_t *y;
+    ecc_curve_t *ecc_curve;
+    ecc_wnaf_key_t *wnaf;
+} mp_public_key_t;
 
-        // -scalar
-        fp_neg(&scalar, &scalar);
-    }
+const mp_obj_type_t signature_type;
+const mp_obj_type_t signature_eth_type;
+const mp_obj_type_t curve_type;
+const mp_obj_type_t point_type;
+const mp_obj_type_t public_key_type;
+const mp_obj_type_t ecc_type;
 
-    ecc_point_t *R0 = m_new_obj(ecc_point_t);
-    R0->x = fp_alloc();
-    R0->y = fp_alloc();
+static ecc_scratch_t *ec_scratch_acquire(ecc_curve_t *curve);
+static void ec_scratch_done(ecc_curve_t *curve, ecc_scratch_t *scratch);
+static fp_int *ec_scratch_get(ecc_scratch_t *scratch);
+static size_t ec_scratch_mark(ecc_scratch_t *scratch);
+static void ec_scratch_release(ecc_scratch_t *scratch, size_t mark);
+static ecc_comb_t *ec_curve_comb(ecc_curve_t *curve, ecc_scratch_t *scratch);
+static ecc_wnaf_key_t *ec_curve_wnaf(ecc_curve_t *curve, ecc_scratch_t *scratch);
+static void mp_point_affine(mp_point_t *point);
+static void mp_point_view(ecc_point_t *P, mp_point_t *point);
+static void ec_point_view_done(ecc_point_t *P);
 
-    ecc_point_t *R1 = m_new_obj(ecc_point_t);
-    R1->x = fp_alloc();
-    R1->y = fp_alloc();
 
-    ecc_point_t *tmp = m_new_obj(ecc_point_t);
-    tmp->x = fp_alloc();
-    tmp->y = fp_alloc();
+// Prototipagem das funções
+static void signature_eth_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind);
+static mp_obj_t signature_eth_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs);
+static mp_obj_t signature_eth_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest);
+//static void signature_eth_deinit(mp_obj_t self_in);
 
-    fp_copy(point->x, R0->x);
-    fp_copy(point->y, R0->y);
 
-    ec_point_double(R1, point, curve);
 
-    int dbits = fp_count_bits(&scalar), i;
-    for (i = dbits - 2; i >= 0; i--)
-    {
-        if (fp_tstbit(scalar, i))
-        {
-            fp_copy(R0->x, tmp->x);
-            fp_copy(R0->y, tmp->y);
+/**
+ * Impressão do objeto SignatureETH.
+ */
+static void signature_eth_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    (void)kind;
+    mp_ecdsa_signature_eth_t *self = MP_OBJ_TO_PTR(self_in);
+    vstr_t *vstr_r = vstr_new_from_compact(self->r);
+    vstr_t *vstr_s = vstr_new_from_compact(self->s);
+    mp_printf(print, "<SignatureETH r=%s s=%s v_eth=%d chainId=%d>", vstr_str(vstr_r), vstr_str(vstr_s), self->v, self->chainId);
+    vstr_free(vstr_r);
+    vstr_free(vstr_s);
+}
 
-            ec_point_add(R0, R1, tmp, curve);
 
-            fp_copy(R1->x, tmp->x);
-            fp_copy(R1->y, tmp->y);
+// copy of curve, sharing the cached tables, for a Curve about to be changed
+static ecc_curve_t *ec_curve_clone(ecc_curve_t *curve)
+{
+    ecc_curve_t *c = m_new_obj(ecc_curve_t);
+    c->p = fp_alloc();
+    c->a = fp_alloc();
+    c->b = fp_alloc();
+    c->q = fp_alloc();
+    c->g = m_new_obj(ecc_point_t);
+    c->g->x = fp_alloc();
+    c->g->y = fp_alloc();
+
+    vstr_init(&c->name, vstr_len(&curve->name));
+    vstr_add_strn(&c->name, vstr_str(&curve->name), vstr_len(&curve->name));
+    vstr_init(&c->oid, vstr_len(&curve->oid));
+    vstr_add_strn(&c->oid, vstr_str(&curve->oid), vstr_len(&curve->oid));
+
+    fp_copy(curve->p, c->p);
+    fp_copy(curve->a, c->a);
+    fp_copy(curve->b, c->b);
+    fp_copy(curve->q, c->q);
+    fp_copy(curve->g->x, c->g->x);
+    fp_copy(curve->g->y, c->g->y);
+    c->precomp = curve->precomp;
 
-            ec_point_double(R1, tmp, curve);
-        }
-        else
-        {
-            fp_copy(R1->x, tmp->x);
-            fp_copy(R1->y, tmp->y);
+    return c;
+}
 
-            ec_point_add(R1, R0, tmp, curve);
+static mp_curve_t *new_curve_init_copy(mp_point_t *point)
+{
+    mp_curve_t *c = m_new_obj(mp_curve_t);
+    c->base.type = &curve_type;
+    c->ecc_curve = point->ecc_curve;
+    return c;
+}
 
-            fp_copy(R0->x, tmp->x);
-            fp_copy(R0->y, tmp->y);
+// point on curve, x and y are set by the caller
+static mp_point_t *new_point_shared(ecc_curve_t *curve)
+{
+    mp_point_t *pr = m_new_obj(mp_point_t);
+    pr->base.type = &point_type;
+    pr->x = NULL;
+    pr->y = NULL;
+    pr->ecc_curve = curve;
+    pr->jacobian = NULL;
+    return pr;
+}
 
-            ec_point_double(R0, tmp, curve);
-        }
-    }
+// point with the coordinates of op
+static void mp_point_store(mp_point_t *point, ecc_point_t *op)
+{
+    point->x = fp_compact_new(op->x);
+    point->y = fp_compact_new(op->y);
+}
 
-    fp_copy(R0->x, rop->x);
-    fp_copy(R0->y, rop->y);
+// the generator of curve
+static mp_point_t *new_point_init_copy(mp_curve_t *curve)
+{
+    mp_point_t *pr = new_point_shared(curve->ecc_curve);
+    mp_point_store(pr, curve->ecc_curve->g);
+    return pr;
+}
 
-    if (scalar_is_negative)
+static bool ec_signature_equal(mp_ecdsa_signature_t *s1, mp_ecdsa_signature_t *s2)
+{
+    if (!fp_compact_equal(s1->r, s2->r))
     {
-        // restore point.y
-        fp_copy(point_y_fp_int, point->y);
-        // restore scalar
-        fp_neg(&scalar, &scalar);
+        return false;
     }
+    if (!fp_compact_equal(s1->s, s2->s))
+    {
+        return false;
+    }
+    return true;
+}
 
-    fp_free(R0->x);
-    fp_free(R0->y);
-    m_del_obj(ecc_point_t, R0);
-
-    fp_free(R1->x);
-    fp_free(R1->y);
-    m_del_obj(ecc_point_t, R1);
+// working copy of the r and s of a signature, freed with ec_signature_view_done
+static void ec_signature_view(ecdsa_signature_t *sig, fp_compact_t *r, fp_compact_t *s)
+{
+    sig->r = fp_alloc();
+    sig->s = fp_alloc();
+    fp_compact_get(r, sig->r);
+    fp_compact_get(s, sig->s);
+}
 
-    fp_free(tmp->x);
-    fp_free(tmp->y);
-    m_del_obj(ecc_point_t, tmp);
+static void ec_signature_view_done(ecdsa_signature_t *sig)
+{
+    fp_free(sig->r);
+    fp_free(sig->s);
 }
 
-static void ec_point_shamirs_trick(ecc_point_t *rop, ecc_point_t *point1, fp_int scalar1, ecc_point_t *point2, fp_int scalar2, ecc_curve_t *curve)
+// Ecdsa-Sig-Value ::= SEQUENCE { r INTEGER, s INTEGER }
+static size_t ecdsa_signature_der_size(ecdsa_signature_t *sig)
 {
-    ecc_point_t *sum = m_new_obj(ecc_point_t);
-    sum->x = fp_alloc();
-    sum->y = fp_alloc();
+    return der_size(der_size(der_integer_len(sig->r)) + der_size(der_integer_len(sig->s)));
+}
 
-    ecc_point_t *tmp = m_new_obj(ecc_point_t);
-    tmp->x = fp_alloc();
-    tmp->y = fp_alloc();
+static void ecdsa_signature_der_encode(ecdsa_signature_t *sig, byte *buf)
+{
+    buf = der_write_header(buf, DER_SEQUENCE, der_size(der_integer_len(sig->r)) + der_size(der_integer_len(sig->s)));
+    buf = der_write_integer(buf, sig->r);
+    der_write_integer(buf, sig->s);
+}
 
-    ec_point_add(sum, point1, point2, curve);
+// r and s of at most half of FP_MAX_SIZE bits, so that r * s^-1 fits
+static bool ecdsa_signature_der_decode(ecdsa_signature_t *sig, const byte *buf, size_t len)
+{
+    der_t der = {buf, buf + len};
+    der_t seq;
+    return der_expect(&der, DER_SEQUENCE, &seq) && der.p == der.end &&
+           der_read_integer(&seq, sig->r, FP_MAX_SIZE / 16) &&
+           der_read_integer(&seq, sig->s, FP_MAX_SIZE / 16) && seq.p == seq.end;
+}
 
-    int scalar1Bits = fp_count_bits(&scalar1);
-    int scalar2Bits = fp_count_bits(&scalar2);
-    int l = (scalar1Bits > scalar2Bits ? scalar1Bits : scalar2Bits) - 1;
+static void signature_print(mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_ecdsa_signature_t *self = MP_OBJ_TO_PTR(self_in);
+    vstr_t *vstr_r = vstr_new_from_compact(self->r);
+    vstr_t *vstr_s = vstr_new_from_compact(self->s);
+    mp_printf(print, "<Signature r=%s s=%s>", vstr_str(vstr_r), vstr_str(vstr_s));
+    vstr_free(vstr_r);
+    vstr_free(vstr_s);
+}
 
-    if (fp_tstbit(scalar1, l) && fp_tstbit(scalar2, l))
-    {
-        fp_copy(sum->x, rop->x);
-        fp_copy(sum->y, rop->y);
-    }
-    else if (fp_tstbit(scalar1, l))
-    {
-        fp_copy(point1->x, rop->x);
-        fp_copy(point1->y, rop->y);
-    }
-    else if (fp_tstbit(scalar2, l))
+static mp_obj_t signature_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs)
+{
+    switch (op)
     {
-        fp_copy(point2->x, rop->x);
-        fp_copy(point2->y, rop->y);
-    }
-
-    for (l = l - 1; l >= 0; l--)
+    case MP_BINARY_OP_EQUAL:
     {
-        fp_copy(rop->x, tmp->x);
-        fp_copy(rop->y, tmp->y);
-
-        ec_point_double(rop, tmp, curve);
-
-        fp_copy(rop->x, tmp->x);
-        fp_copy(rop->y, tmp->y);
-
-        if (fp_tstbit(scalar1, l) && fp_tstbit(scalar2, l))
-        {
-            ec_point_add(rop, tmp, sum, curve);
-        }
-        else if (fp_tstbit(scalar1, l))
-        {
-            ec_point_add(rop, tmp, point1, curve);
-        }
-        else if (fp_tstbit(scalar2, l))
+        if (!MP_OBJ_IS_TYPE(lhs, &signature_type) && !MP_OBJ_IS_TYPE(rhs, &signature_type))
         {
-            ec_point_add(rop, tmp, point2, curve);
+            mp_raise_TypeError(ERROR_EXPECTED_SIGNATURES);
         }
+        mp_ecdsa_signature_t *l = MP_OBJ_TO_PTR(lhs);
+        mp_ecdsa_signature_t *r = MP_OBJ_TO_PTR(rhs);
+        return mp_obj_new_bool(ec_signature_equal(l, r));
+    }
+    default:
+        return MP_OBJ_NULL; // op not supported
     }
-
-    fp_free(sum->x);
-    fp_free(sum->y);
-    m_del_obj(ecc_point_t, sum);
-
-    fp_free(tmp->x);
-    fp_free(tmp->y);
-    m_del_obj(ecc_point_t, tmp);
 }
 
-static void ecdsa_s(ecdsa_signature_t *sig, unsigned char *msg, size_t msg_len, fp_int d, fp_int k, ecc_curve_t *curve)
+static void signature_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
 {
-    fp_int *e = fp_alloc();
-    fp_int *kinv = fp_alloc();
-
-    // R = k * G, r = R[x]
-    ecc_point_t *R = m_new_obj(ecc_point_t);
-    R->x = fp_alloc();
-    R->y = fp_alloc();
-
-    ec_point_mul(R, curve->g, k, curve);
-    fp_copy(R->x, sig->r);
-    fp_mod(sig->r, curve->q, sig->r);
-
-    // convert digest to integer (digest is computed as hex in ecdsa.py)
-    fp_read_radix(e, (const char *)msg, 16);
-
-    int orderBits = fp_count_bits(curve->q);
-    int digestBits = msg_len * 4;
-
-    if (digestBits > orderBits)
+    mp_ecdsa_signature_t *self = MP_OBJ_TO_PTR(obj);
+    if (dest[0] == MP_OBJ_NULL)
     {
-        fp_int *n = fp_alloc();
-        fp_2expt(n, digestBits - orderBits);
-        fp_div(e, n, e, NULL);
-        fp_free(n);
+        const mp_obj_type_t *type = mp_obj_get_type(obj);
+        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
+        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL)
+        {
+            if (attr == MP_QSTR_r)
+            {
+                dest[0] = mp_obj_new_int_from_compact(self->r);
+                return;
+            }
+            else if (attr == MP_QSTR_s)
+            {
+                dest[0] = mp_obj_new_int_from_compact(self->s);
+                return;
+            }
+            mp_convert_member_lookup(obj, type, elem->value, dest);
+        }
     }
+}
 
-    // s = (k^-1 * (e + d * r)) mod n
-    fp_invmod(&k, curve->q, kinv);
-    fp_zero(sig->s);
 
-    fp_mul(&d, sig->r, sig->s);
-    fp_add(sig->s, e, sig->s);
-    fp_mul(sig->s, kinv, sig->s);
-    fp_mod(sig->s, curve->q, sig->s);
+/**
+ * Calcula o parâmetro de recuperação `v` para assinaturas ECDSA compatíveis com Ethereum.
+ *
+ * @param R      Ponto R resultante de k * G na curva elíptica.
+ * @param curve  Curva elíptica utilizada.
+ * @param chainId Identificador da cadeia Ethereum (genérico).
+ * @return       Valor de `v` calculado (27 + rec_id + chainId * 2).
+ */
+static int calculate_recovery_id(ecc_point_t *R, ecc_curve_t *curve, int chainId) {
+    // Verifica se o ponto R está no ponto de identidade
+    if (fp_iszero(R->x) && fp_iszero(R->y)) {
+        // Não é possível recuperar a chave pública a partir do ponto de identidade
+        return -1;
+    }
 
-    fp_free(e);
-    fp_free(kinv);
+    // Determina a paridade de y(R)
+    int rec_id = fp_tstbit(*R->y, 0) ? 1 : 0; // 1 se y(R) é ímpar, 0 se par
 
-    fp_free(R->x);
-    fp_free(R->y);
-    m_del_obj(ecc_point_t, R);
+    // Calcula v conforme EIP-155: v = rec_id + (chainId * 2 + 35)
+    // Onde rec_id é 0 ou 1
+    int v = rec_id + (chainId * 2) + 35;
+
+    return v;
 }
 
-static void ecdsa_s_eth(ecdsa_signature_t *sig, unsigned char *msg, size_t msg_len, fp_int d, fp_int k, ecc_curve_t *curve, ecc_point_t *R_out)
+static mp_obj_t signature_to_der(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 {
-    fp_int *e = fp_alloc();
-    fp_int *kinv = fp_alloc();
+    /*
+        out (bytearray/memoryview): written in place, returns the number of bytes written
+    */
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_out, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
 
-    // R = k * G, r = R[x]
-    ecc_point_t *R = m_new_obj(ecc_point_t);
-    R->x = fp_alloc();
-    R->y = fp_alloc();
+    struct
+    {
+        mp_arg_val_t out;
+    } args;
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
 
-    ec_point_mul(R, curve->g, k, curve);
-    fp_copy(R->x, sig->r);
-    fp_mod(sig->r, curve->q, sig->r);
+    mp_ecdsa_signature_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    ecdsa_signature_t sig;
+    ec_signature_view(&sig, self->r, self->s);
+    size_t len = ecdsa_signature_der_size(&sig);
+
+    if (args.out.u_obj != mp_const_none)
+    {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(args.out.u_obj, &bufinfo, MP_BUFFER_WRITE);
+        if (bufinfo.len < len)
+        {
+            ec_signature_view_done(&sig);
+            mp_raise_msg_varg(&mp_type_ValueError, ERROR_BUFFER_TOO_SMALL, (unsigned)len, (unsigned)bufinfo.len);
+        }
+        ecdsa_signature_der_encode(&sig, bufinfo.buf);
+        ec_signature_view_done(&sig);
+        return mp_obj_new_int(len);
+    }
 
-    // Converter digest para inteiro (digest é computado como hex em ecdsa.py)
-    fp_read_radix(e, (const char *)msg, 16);
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    ecdsa_signature_der_encode(&sig, (byte *)vstr.buf);
+    ec_signature_view_done(&sig);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
 
-    int orderBits = fp_count_bits(curve->q);
-    int digestBits = msg_len * 4;
+static MP_DEFINE_CONST_FUN_OBJ_KW(signature_to_der_obj, 1, signature_to_der);
 
-    if (digestBits > orderBits) {
-        fp_int *n = fp_alloc();
-        fp_2expt(n, digestBits - orderBits);
-        fp_div(e, n, e, NULL);
-        fp_free(n);
+static mp_obj_t signature_from_der(mp_obj_t data)
+{
+    /*
+        data (buffer): DER of SEQUENCE { r INTEGER, s INTEGER }, read in place
+    */
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+
+    ecdsa_signature_t sig;
+    sig.r = fp_alloc();
+    sig.s = fp_alloc();
+    bool valid = ecdsa_signature_der_decode(&sig, bufinfo.buf, bufinfo.len);
+    mp_ecdsa_signature_t *signature = NULL;
+    if (valid)
+    {
+        signature = m_new_obj(mp_ecdsa_signature_t);
+        signature->base.type = &signature_type;
+        signature->r = fp_compact_new(sig.r);
+        signature->s = fp_compact_new(sig.s);
     }
+    ec_signature_view_done(&sig);
+    if (!valid)
+    {
+        mp_raise_ValueError(ERROR_INVALID_DER);
+    }
+    return MP_OBJ_FROM_PTR(signature);
+}
 
-    // s = (k^-1 * (e + d * r)) mod n
-    fp_invmod(&k, curve->q, kinv);
-    fp_zero(sig->s);
+static MP_DEFINE_CONST_FUN_OBJ_1(signature_from_der_obj, signature_from_der);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_signature_from_der_obj, MP_ROM_PTR(&signature_from_der_obj));
 
-    fp_mul(&d, sig->r, sig->s);
-    fp_add(sig->s, e, sig->s);
-    fp_mul(sig->s, kinv, sig->s);
-    fp_mod(sig->s, curve->q, sig->s);
+static const mp_rom_map_elem_t signature_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_s), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_r), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_to_der), MP_ROM_PTR(&signature_to_der_obj)},
+    {MP_ROM_QSTR(MP_QSTR_from_der), MP_ROM_PTR(&static_signature_from_der_obj)},
+};
 
-    // Copiar R para R_out
-    fp_copy(R->x, R_out->x);
-    fp_copy(R->y, R_out->y);
+static MP_DEFINE_CONST_DICT(signature_locals_dict, signature_locals_dict_table);
 
-    // Liberação de memória
-    fp_free(e);
-    fp_free(kinv);
+MP_DEFINE_CONST_OBJ_TYPE(
+    signature_type,
+    MP_QSTR_Signature,
+    MP_TYPE_FLAG_NONE,
+    print, signature_print,
+    binary_op, signature_binary_op,
+    attr, signature_attr,
+    locals_dict, &signature_locals_dict);
 
-    fp_free(R->x);
-    fp_free(R->y);
-    m_del_obj(ecc_point_t, R);
-}
 
-static int ecdsa_v(ecdsa_signature_t *sig, unsigned char *msg, size_t msg_len, ecc_point_t *Q, ecc_curve_t *curve)
-{
-    fp_int *e = fp_alloc();
-    fp_int *w = fp_alloc();
-    fp_int *u1 = fp_alloc();
-    fp_int *u2 = fp_alloc();
+/**
+ * Definição do tipo SignatureETH.
+ */
 
-    ecc_point_t *tmp = m_new_obj(ecc_point_t);
-    tmp->x = fp_alloc();
-    tmp->y = fp_alloc();
+static const mp_rom_map_elem_t signature_eth_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_r), MP_ROM_PTR(&mp_type_int)},
+    {MP_ROM_QSTR(MP_QSTR_s), MP_ROM_PTR(&mp_type_int)},
+    {MP_ROM_QSTR(MP_QSTR_v_eth), MP_ROM_PTR(&mp_type_int)},
+    {MP_ROM_QSTR(MP_QSTR_chainId), MP_ROM_PTR(&mp_type_int)},
+};
+static MP_DEFINE_CONST_DICT(signature_eth_locals_dict, signature_eth_locals_dict_table);
 
-    // convert digest to integer (digest is computed as hex in ecdsa.py)
-    fp_read_radix(e, (const char *)msg, 16);
+ 
+MP_DEFINE_CONST_OBJ_TYPE(
+    signature_eth_type,
+    MP_QSTR_SignatureETH,
+    MP_TYPE_FLAG_NONE,
+    print, signature_eth_print,
+    binary_op, signature_eth_binary_op,
+    attr, signature_eth_attr,
+    locals_dict, &signature_eth_locals_dict);
 
-    int orderBits = fp_count_bits(curve->q);
-    int digestBits = msg_len * 4;
+static bool ec_point_in_curve(ecc_point_t *point, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *left = ec_scratch_get(scratch);
+    fp_int *right = ec_scratch_get(scratch);
+    fp_int *t = ec_scratch_get(scratch);
 
-    if (digestBits > orderBits)
-    {
-        fp_int *tmp_ = fp_alloc();
-        fp_2expt(tmp_, digestBits - orderBits);
-        fp_div(e, tmp_, e, NULL);
-        fp_free(tmp_);
-    }
+    /*
+    left = y * y
+    right = (x * x * x) + (self.a * x) + self.b
+    return (left - right) % self.p == 0
+    */
 
-    fp_invmod(sig->s, curve->q, w);
-    fp_mul(e, w, u1);
-    fp_mod(u1, curve->q, u1);
-    fp_mul(sig->r, w, u2);
-    fp_mod(u2, curve->q, u2);
+    // left = (y * y)
+    fp_sqr(point->y, left);
 
-    ec_point_shamirs_trick(tmp, curve->g, *u1, Q, *u2, curve);
-    fp_mod(tmp->x, curve->q, tmp->x);
+    //(x * x * x)
+    fp_sqr(point->x, t);
+    fp_mul(t, point->x, t);
 
-    int equal = (fp_cmp(tmp->x, sig->r) == FP_EQ);
+    //(curve.a * x)
+    fp_mul(curve->a, point->x, right);
 
-    fp_free(e);
-    fp_free(w);
-    fp_free(u1);
-    fp_free(u2);
+    // right = (x * x * x) + (curve.a * x) + curve.b
+    fp_add(t, right, right);
+    fp_add(right, curve->b, right);
 
-    fp_free(tmp->x);
-    fp_free(tmp->y);
-    m_del_obj(ecc_point_t, tmp);
-    return equal;
-}
+    // return (left - right) % curve.p == 0
+    fp_submod(left, right, curve->p, t);
+    bool is_point_in_curve = (fp_iszero(t) == FP_YES);
 
-/**
- * Verifica a assinatura ECDSA compatível com Ethereum.
- *
- * @param sig_eth Assinatura Ethereum contendo r, s, v e chainId.
- * @param msg     Mensagem assinada (hash Keccak-256).
- * @param Q       Chave pública do signatário.
- * @param curve   Curva elíptica utilizada.
- * @return        True se a assinatura for válida, False caso contrário.
- */
-static bool ecdsa_v_eth(ecdsa_signature_teth *sig_eth, unsigned char *msg, size_t msg_len, ecc_point_t *Q, ecc_curve_t *curve) {
-    // Cria uma assinatura padrão temporária
-    ecdsa_signature_t sig_standard;
-    sig_standard.r = sig_eth->r;
-    sig_standard.s = sig_eth->s;
-    return ecdsa_v(&sig_standard, msg, msg_len, Q, curve);
+    ec_scratch_release(scratch, mark);
+    return is_point_in_curve;
 }
 
-static mp_obj_t point_equal(mp_obj_t point1, mp_obj_t point2)
+static bool ec_curve_equal(ecc_curve_t *c1, ecc_curve_t *c2)
 {
-    if (!MP_OBJ_IS_TYPE(point1, &point_type))
+    if (fp_cmp(c1->p, c2->p) != FP_EQ)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point1));
+        return false;
     }
-    if (!MP_OBJ_IS_TYPE(point2, &point_type))
+    if (fp_cmp(c1->a, c2->a) != FP_EQ)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 2, mp_obj_get_type_str(point2));
+        return false;
     }
-
-    mp_point_t *p1 = MP_OBJ_TO_PTR(point1);
-    mp_point_t *p2 = MP_OBJ_TO_PTR(point2);
-    return mp_obj_new_bool(ec_point_equal(p1->ecc_point, p2->ecc_point));
-}
-
-static MP_DEFINE_CONST_FUN_OBJ_2(point_equal_obj, point_equal);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_equal_obj, MP_ROM_PTR(&point_equal_obj));
-
-static mp_obj_t point_double(mp_obj_t point, mp_obj_t curve)
-{
-    if (!MP_OBJ_IS_TYPE(point, &point_type))
+    if (fp_cmp(c1->b, c2->b) != FP_EQ)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
+        return false;
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    if (fp_cmp(c1->q, c2->q) != FP_EQ)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve));
+        return false;
     }
-
-    mp_point_t *p = MP_OBJ_TO_PTR(point);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
-
-    mp_point_t *pr = new_point_init_copy(c);
-    ec_point_double(pr->ecc_point, p->ecc_point, c->ecc_curve);
-    return MP_OBJ_FROM_PTR(pr);
+    if (fp_cmp(c1->g->x, c2->g->x) != FP_EQ)
+    {
+        return false;
+    }
+    if (fp_cmp(c1->g->y, c2->g->y) != FP_EQ)
+    {
+        return false;
+    }
+    return true;
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_2(point_double_obj, point_double);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_double_obj, MP_ROM_PTR(&point_double_obj));
-
-static mp_obj_t point_add(mp_obj_t point1, mp_obj_t point2, mp_obj_t curve)
+static mp_obj_t curve_equal(mp_obj_t curve1, mp_obj_t curve2)
 {
-    if (!MP_OBJ_IS_TYPE(point1, &point_type))
-    {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point1));
-    }
-    if (!MP_OBJ_IS_TYPE(point2, &point_type))
+    if (!MP_OBJ_IS_TYPE(curve1, &curve_type))
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 2, mp_obj_get_type_str(point2));
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 1, mp_obj_get_type_str(curve1));
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    if (!MP_OBJ_IS_TYPE(curve2, &curve_type))
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve2));
     }
 
-    mp_point_t *p1 = MP_OBJ_TO_PTR(point1);
-    mp_point_t *p2 = MP_OBJ_TO_PTR(point2);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
-
-    mp_point_t *pr = new_point_init_copy(c);
-    ec_point_add(pr->ecc_point, p1->ecc_point, p2->ecc_point, c->ecc_curve);
-    return MP_OBJ_FROM_PTR(pr);
+    mp_curve_t *c1 = MP_OBJ_TO_PTR(curve1);
+    mp_curve_t *c2 = MP_OBJ_TO_PTR(curve2);
+    return mp_obj_new_bool(ec_curve_equal(c1->ecc_curve, c2->ecc_curve));
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_3(point_add_obj, point_add);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_add_obj, MP_ROM_PTR(&point_add_obj));
+static MP_DEFINE_CONST_FUN_OBJ_2(curve_equal_obj, curve_equal);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve_equal_obj, MP_ROM_PTR(&curve_equal_obj));
 
-static mp_obj_t point_sub(mp_obj_t point1, mp_obj_t point2, mp_obj_t curve)
+static mp_obj_t point_in_curve(mp_obj_t point, mp_obj_t curve)
 {
-    if (!MP_OBJ_IS_TYPE(point1, &point_type))
-    {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point1));
-    }
-    if (!MP_OBJ_IS_TYPE(point2, &point_type))
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(point, &point_type))
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 2, mp_obj_get_type_str(point2));
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
     }
     if (!MP_OBJ_IS_TYPE(curve, &curve_type))
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve));
     }
 
-    mp_point_t *p1 = MP_OBJ_TO_PTR(point1);
-    mp_point_t *p2 = MP_OBJ_TO_PTR(point2);
+    mp_point_t *p = MP_OBJ_TO_PTR(point);
     mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+    ecc_point_t affine;
+    mp_point_view(&affine, p);
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    bool in_curve = ec_point_in_curve(&affine, c->ecc_curve, scratch);
+    ec_scratch_done(c->ecc_curve, scratch);
+    ec_point_view_done(&affine);
+    return mp_obj_new_bool(in_curve);
+}
 
-    // -point2.y % curve.p
-    fp_int *p2_y_fp_int = fp_alloc();
+static MP_DEFINE_CONST_FUN_OBJ_2(point_in_curve_obj, point_in_curve);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_in_curve_obj, MP_ROM_PTR(&point_in_curve_obj));
+
+static void curve_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_curve_t *self = MP_OBJ_TO_PTR(self_in);
+    vstr_t vstr_oid;
+    vstr_hexlify(&vstr_oid, (const byte *)vstr_str(&self->ecc_curve->oid), vstr_len(&self->ecc_curve->oid));
+    vstr_t *ecc_curve_p = vstr_new_from_fp(self->ecc_curve->p);
+    vstr_t *ecc_curve_a = vstr_new_from_fp(self->ecc_curve->a);
+    vstr_t *ecc_curve_b = vstr_new_from_fp(self->ecc_curve->b);
+    vstr_t *ecc_curve_q = vstr_new_from_fp(self->ecc_curve->q);
+    vstr_t *ecc_curve_g_x = vstr_new_from_fp(self->ecc_curve->g->x);
+    vstr_t *ecc_curve_g_y = vstr_new_from_fp(self->ecc_curve->g->y);
+    mp_printf(print, "<Curve name=%s oid=%s p=%s a=%s b=%s q=%s gx=%s gy=%s>", vstr_str(&self->ecc_curve->name), vstr_str(&vstr_oid), vstr_str(ecc_curve_p), vstr_str(ecc_curve_a), vstr_str(ecc_curve_b), vstr_str(ecc_curve_q), vstr_str(ecc_curve_g_x), vstr_str(ecc_curve_g_y));
+    vstr_free(ecc_curve_p);
+    vstr_free(ecc_curve_a);
+    vstr_free(ecc_curve_b);
+    vstr_free(ecc_curve_q);
+    vstr_free(ecc_curve_g_x);
+    vstr_free(ecc_curve_g_y);
+}
+
+static mp_obj_t curve_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs)
+{
+    switch (op)
+    {
+    case MP_BINARY_OP_EQUAL:
+    {
+        if (!MP_OBJ_IS_TYPE(lhs, &curve_type) && !MP_OBJ_IS_TYPE(rhs, &curve_type))
+        {
+            mp_raise_TypeError(ERROR_EXPECTED_CURVES);
+        }
+        mp_curve_t *l = MP_OBJ_TO_PTR(lhs);
+        mp_curve_t *r = MP_OBJ_TO_PTR(rhs);
+        return curve_equal(MP_OBJ_FROM_PTR(l), MP_OBJ_FROM_PTR(r));
+    }
+    case MP_BINARY_OP_CONTAINS:
+    {
+        if (!MP_OBJ_IS_TYPE(lhs, &curve_type))
+        {
+            mp_raise_TypeError(ERROR_LEFT_EXPECTED_CURVE);
+        }
+        if (!MP_OBJ_IS_TYPE(rhs, &point_type))
+        {
+            mp_raise_TypeError(ERROR_RIGHT_EXPECTED_POINT);
+        }
+        mp_curve_t *l = MP_OBJ_TO_PTR(lhs);
+        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
+        return point_in_curve(MP_OBJ_FROM_PTR(r), MP_OBJ_FROM_PTR(l));
+    }
+    default:
+        return MP_OBJ_NULL; // op not supported
+    }
+}
+
+static void curve_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
+{
+    mp_curve_t *self = MP_OBJ_TO_PTR(obj);
+    if (dest[0] == MP_OBJ_NULL)
+    {
+        const mp_obj_type_t *type = mp_obj_get_type(obj);
+        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
+        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL)
+        {
+            if (attr == MP_QSTR_p)
+            {
+                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->p);
+                return;
+            }
+            else if (attr == MP_QSTR_a)
+            {
+                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->a);
+                return;
+            }
+            else if (attr == MP_QSTR_b)
+            {
+                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->b);
+                return;
+            }
+            else if (attr == MP_QSTR_q)
+            {
+                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->q);
+                return;
+            }
+            else if (attr == MP_QSTR_G)
+            {
+                mp_point_t *pr = new_point_init_copy(self);
+                dest[0] = pr;
+                return;
+            }
+            else if (attr == MP_QSTR_gx)
+            {
+                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->g->x);
+                return;
+            }
+            else if (attr == MP_QSTR_gy)
+            {
+                dest[0] = mp_obj_new_int_from_fp(self->ecc_curve->g->y);
+                return;
+            }
+            else if (attr == MP_QSTR_name)
+            {
+                dest[0] = mp_obj_new_str_of_type(&mp_type_str, (const byte *)vstr_str(&self->ecc_curve->name), vstr_len(&self->ecc_curve->name));
+                return;
+            }
+            else if (attr == MP_QSTR_oid)
+            {
+                dest[0] = mp_obj_new_str_of_type(&mp_type_bytes, (const byte *)vstr_str(&self->ecc_curve->oid), vstr_len(&self->ecc_curve->oid));
+                return;
+            }
+            mp_convert_member_lookup(obj, type, elem->value, dest);
+        }
+    }
+    else
+    {
+        if ((attr == MP_QSTR_p || attr == MP_QSTR_a || attr == MP_QSTR_b || attr == MP_QSTR_q || attr == MP_QSTR_gx || attr == MP_QSTR_gy) && !MP_OBJ_IS_INT(dest[1]))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT, mp_obj_get_type_str(dest[1]));
+        }
+        else if (attr == MP_QSTR_G && !MP_OBJ_IS_TYPE(dest[1], &point_type))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_BUT, mp_obj_get_type_str(dest[1]));
+        }
+        else if ((attr == MP_QSTR_name || attr == MP_QSTR_oid) && !MP_OBJ_IS_STR_OR_BYTES(dest[1]))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(dest[1]));
+        }
+
+        if (attr == MP_QSTR_p || attr == MP_QSTR_a || attr == MP_QSTR_b || attr == MP_QSTR_q || attr == MP_QSTR_G || attr == MP_QSTR_gx || attr == MP_QSTR_gy || attr == MP_QSTR_name || attr == MP_QSTR_oid)
+        {
+            // points and copies of the curve share its parameters, they keep the old ones
+            self->ecc_curve = ec_curve_clone(self->ecc_curve);
+        }
+        if (attr == MP_QSTR_p || attr == MP_QSTR_a || attr == MP_QSTR_b || attr == MP_QSTR_q || attr == MP_QSTR_G || attr == MP_QSTR_gx || attr == MP_QSTR_gy)
+        {
+            // the cached tables belong to the old parameters
+            self->ecc_curve->precomp = m_new0(ecc_curve_precomp_t, 1);
+        }
+
+        if (attr == MP_QSTR_p)
+        {
+            mp_fp_for_int(dest[1], self->ecc_curve->p);
+        }
+        else if (attr == MP_QSTR_a)
+        {
+            mp_fp_for_int(dest[1], self->ecc_curve->a);
+        }
+        else if (attr == MP_QSTR_b)
+        {
+            mp_fp_for_int(dest[1], self->ecc_curve->b);
+        }
+        else if (attr == MP_QSTR_q)
+        {
+            mp_fp_for_int(dest[1], self->ecc_curve->q);
+        }
+        else if (attr == MP_QSTR_G)
+        {
+            mp_point_t *other = MP_OBJ_TO_PTR(dest[1]);
+
+            mp_point_affine(other);
+            fp_copy(other->ecc_curve->p, self->ecc_curve->p);
+            fp_copy(other->ecc_curve->a, self->ecc_curve->a);
+            fp_copy(other->ecc_curve->b, self->ecc_curve->b);
+            fp_copy(other->ecc_curve->q, self->ecc_curve->q);
+            fp_compact_get(other->x, self->ecc_curve->g->x);
+            fp_compact_get(other->y, self->ecc_curve->g->y);
+        }
+        else if (attr == MP_QSTR_gx)
+        {
+            mp_fp_for_int(dest[1], self->ecc_curve->g->x);
+        }
+        else if (attr == MP_QSTR_gy)
+        {
+            mp_fp_for_int(dest[1], self->ecc_curve->g->y);
+        }
+        else if (attr == MP_QSTR_name)
+        {
+            mp_buffer_info_t bufinfo_name;
+            mp_get_buffer_raise(dest[1], &bufinfo_name, MP_BUFFER_READ);
+            vstr_init(&self->ecc_curve->name, bufinfo_name.len);
+            vstr_add_strn(&self->ecc_curve->name, bufinfo_name.buf, bufinfo_name.len);
+        }
+        else if (attr == MP_QSTR_oid)
+        {
+            mp_buffer_info_t bufinfo_oid;
+            mp_get_buffer_raise(dest[1], &bufinfo_oid, MP_BUFFER_READ);
+
+            if (MP_OBJ_IS_TYPE(dest[1], &mp_type_bytes))
+            {
+                vstr_init(&self->ecc_curve->oid, bufinfo_oid.len);
+                vstr_add_strn(&self->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
+            }
+            else if (MP_OBJ_IS_STR(dest[1]))
+            {
+                vstr_unhexlify(&self->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
+            }
+        }
+        else
+        {
+            return;
+        }
+        dest[0] = MP_OBJ_NULL; // indicate success
+    }
+}
+
+static mp_obj_t curve_precompute(mp_obj_t self_in)
+{
+    UCRYPTO_STATS_API(POINT);
+    mp_curve_t *self = MP_OBJ_TO_PTR(self_in);
+    ecc_scratch_t *scratch = ec_scratch_acquire(self->ecc_curve);
+    ec_curve_comb(self->ecc_curve, scratch);
+    ec_curve_wnaf(self->ecc_curve, scratch);
+    ec_scratch_done(self->ecc_curve, scratch);
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(curve_precompute_obj, curve_precompute);
+
+static const mp_rom_map_elem_t curve_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_p), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_a), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_b), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_q), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_G), MP_ROM_PTR(mp_const_none)},
+    {MP_ROM_QSTR(MP_QSTR_gx), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_gy), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_name), MP_ROM_PTR(mp_const_none)},
+    {MP_ROM_QSTR(MP_QSTR_oid), MP_ROM_PTR(mp_const_none)},
+    {MP_ROM_QSTR(MP_QSTR_precompute), MP_ROM_PTR(&curve_precompute_obj)},
+};
+
+static MP_DEFINE_CONST_DICT(curve_locals_dict, curve_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    curve_type,
+    MP_QSTR_Curve,
+    MP_TYPE_FLAG_NONE,
+    print, curve_print,
+    binary_op, curve_binary_op,
+    attr, curve_attr,
+    locals_dict, &curve_locals_dict);
+
+static mp_obj_t curve(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    /*
+        Currently only curves in Weierstrass form (y^2 = x^3 + ax + b (mod p))
+
+        p (int): The value of math p in the curve equation
+        a (int): The value of math a in the curve equation
+        b (int): The value of math b in the curve equation
+        q (int): The order of the base point of the curve
+        gx (int): The x coordinate of the base point of the curve
+        gy (int): The y coordinate of the base point of the curve
+        name (str): The name of the curve
+        oid (str/bytes): The object identifier of the curve
+    */
+
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_p, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_a, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_b, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_q, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_gx, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_gy, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_name, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_oid, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
+
+    struct
+    {
+        mp_arg_val_t p, a, b, q, gx, gy, name, oid;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    mp_curve_t *curve = m_new_obj(mp_curve_t);
+    curve->base.type = &curve_type;
+    curve->ecc_curve = m_new_obj(ecc_curve_t);
+    curve->ecc_curve->p = fp_alloc();
+    curve->ecc_curve->a = fp_alloc();
+    curve->ecc_curve->b = fp_alloc();
+    curve->ecc_curve->q = fp_alloc();
+    curve->ecc_curve->g = m_new_obj(ecc_point_t);
+    curve->ecc_curve->g->x = fp_alloc();
+    curve->ecc_curve->g->y = fp_alloc();
+
+    curve->ecc_curve->precomp = m_new0(ecc_curve_precomp_t, 1);
+
+    vstr_init(&curve->ecc_curve->name, 0);
+    vstr_init(&curve->ecc_curve->oid, 0);
+    for (size_t i = 0; i < n_args; i++)
+    {
+        if (!MP_OBJ_IS_INT(pos_args[i]))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(pos_args[i]), i);
+        }
+    }
+
+    mp_fp_for_int(args.p.u_obj, curve->ecc_curve->p);
+    mp_fp_for_int(args.a.u_obj, curve->ecc_curve->a);
+    mp_fp_for_int(args.b.u_obj, curve->ecc_curve->b);
+    mp_fp_for_int(args.q.u_obj, curve->ecc_curve->q);
+    mp_fp_for_int(args.gx.u_obj, curve->ecc_curve->g->x);
+    mp_fp_for_int(args.gy.u_obj, curve->ecc_curve->g->y);
+
+    if (args.name.u_obj != mp_const_none)
+    {
+        if (!MP_OBJ_IS_STR_OR_BYTES(args.name.u_obj))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(args.name.u_obj));
+        }
+        else
+        {
+            mp_buffer_info_t bufinfo_name;
+            mp_get_buffer_raise(args.name.u_obj, &bufinfo_name, MP_BUFFER_READ);
+            vstr_add_strn(&curve->ecc_curve->name, bufinfo_name.buf, bufinfo_name.len);
+        }
+    }
+
+    if (args.oid.u_obj != mp_const_none)
+    {
+        if (!MP_OBJ_IS_STR_OR_BYTES(args.oid.u_obj))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(args.oid.u_obj));
+        }
+        else
+        {
+            mp_buffer_info_t bufinfo_oid;
+            mp_get_buffer_raise(args.oid.u_obj, &bufinfo_oid, MP_BUFFER_READ);
+
+            if (MP_OBJ_IS_TYPE(args.oid.u_obj, &mp_type_bytes))
+            {
+                vstr_init(&curve->ecc_curve->oid, bufinfo_oid.len);
+                vstr_add_strn(&curve->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
+            }
+            else if (MP_OBJ_IS_STR(args.oid.u_obj))
+            {
+                vstr_unhexlify(&curve->ecc_curve->oid, bufinfo_oid.buf, bufinfo_oid.len);
+            }
+        }
+    }
+
+    return MP_OBJ_FROM_PTR(curve);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(curve_obj, 6, curve);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve_obj, MP_ROM_PTR(&curve_obj));
+
+/////////////////////////////////// Named curves ///////////////////////////////
+
+// curve kept in ROM, parameters as big-endian bytes, a reduced mod p
+typedef struct _ecc_named_curve_t
+{
+    const char *name;
+    const char *alias;
+    const byte *oid;
+    size_t oid_len;
+    size_t size;
+    // p, a, b, q, gx, gy, 'size' bytes each
+    const byte *params;
+} ecc_named_curve_t;
+
+static const byte ec_p192_oid[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x01};
+static const byte ec_p192_params[] = {
+    // p
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    // a
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC,
+    // b
+    0x64, 0x21, 0x05, 0x19, 0xE5, 0x9C, 0x80, 0xE7, 0x0F, 0xA7, 0xE9, 0xAB, 0x72, 0x24, 0x30, 0x49,
+    0xFE, 0xB8, 0xDE, 0xEC, 0xC1, 0x46, 0xB9, 0xB1,
+    // q
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x99, 0xDE, 0xF8, 0x36,
+    0x14, 0x6B, 0xC9, 0xB1, 0xB4, 0xD2, 0x28, 0x31,
+    // gx
+    0x18, 0x8D, 0xA8, 0x0E, 0xB0, 0x30, 0x90, 0xF6, 0x7C, 0xBF, 0x20, 0xEB, 0x43, 0xA1, 0x88, 0x00,
+    0xF4, 0xFF, 0x0A, 0xFD, 0x82, 0xFF, 0x10, 0x12,
+    // gy
+    0x07, 0x19, 0x2B, 0x95, 0xFF, 0xC8, 0xDA, 0x78, 0x63, 0x10, 0x11, 0xED, 0x6B, 0x24, 0xCD, 0xD5,
+    0x73, 0xF9, 0x77, 0xA1, 0x1E, 0x79, 0x48, 0x11,
+};
+
+static const byte ec_p224_oid[] = {0x2B, 0x81, 0x04, 0x00, 0x21};
+static const byte ec_p224_params[] = {
+    // p
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    // a
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    // b
+    0xB4, 0x05, 0x0A, 0x85, 0x0C, 0x04, 0xB3, 0xAB, 0xF5, 0x41, 0x32, 0x56, 0x50, 0x44, 0xB0, 0xB7,
+    0xD7, 0xBF, 0xD8, 0xBA, 0x27, 0x0B, 0x39, 0x43, 0x23, 0x55, 0xFF, 0xB4,
+    // q
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x16, 0xA2,
+    0xE0, 0xB8, 0xF0, 0x3E, 0x13, 0xDD, 0x29, 0x45, 0x5C, 0x5C, 0x2A, 0x3D,
+    // gx
+    0xB7, 0x0E, 0x0C, 0xBD, 0x6B, 0xB4, 0xBF, 0x7F, 0x32, 0x13, 0x90, 0xB9, 0x4A, 0x03, 0xC1, 0xD3,
+    0x56, 0xC2, 0x11, 0x22, 0x34, 0x32, 0x80, 0xD6, 0x11, 0x5C, 0x1D, 0x21,
+    // gy
+    0xBD, 0x37, 0x63, 0x88, 0xB5, 0xF7, 0x23, 0xFB, 0x4C, 0x22, 0xDF, 0xE6, 0xCD, 0x43, 0x75, 0xA0,
+    0x5A, 0x07, 0x47, 0x64, 0x44, 0xD5, 0x81, 0x99, 0x85, 0x00, 0x7E, 0x34,
+};
+
+static const byte ec_p256_oid[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07};
+static const byte ec_p256_params[] = {
+    // p
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    // a
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC,
+    // b
+    0x5A, 0xC6, 0x35, 0xD8, 0xAA, 0x3A, 0x93, 0xE7, 0xB3, 0xEB, 0xBD, 0x55, 0x76, 0x98, 0x86, 0xBC,
+    0x65, 0x1D, 0x06, 0xB0, 0xCC, 0x53, 0xB0, 0xF6, 0x3B, 0xCE, 0x3C, 0x3E, 0x27, 0xD2, 0x60, 0x4B,
+    // q
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51,
+    // gx
+    0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+    0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+    // gy
+    0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+    0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+};
+
+static const byte ec_p384_oid[] = {0x2B, 0x81, 0x04, 0x00, 0x22};
+static const byte ec_p384_params[] = {
+    // p
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+    // a
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFC,
+    // b
+    0xB3, 0x31, 0x2F, 0xA7, 0xE2, 0x3E, 0xE7, 0xE4, 0x98, 0x8E, 0x05, 0x6B, 0xE3, 0xF8, 0x2D, 0x19,
+    0x18, 0x1D, 0x9C, 0x6E, 0xFE, 0x81, 0x41, 0x12, 0x03, 0x14, 0x08, 0x8F, 0x50, 0x13, 0x87, 0x5A,
+    0xC6, 0x56, 0x39, 0x8D, 0x8A, 0x2E, 0xD1, 0x9D, 0x2A, 0x85, 0xC8, 0xED, 0xD3, 0xEC, 0x2A, 0xEF,
+    // q
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0x63, 0x4D, 0x81, 0xF4, 0x37, 0x2D, 0xDF,
+    0x58, 0x1A, 0x0D, 0xB2, 0x48, 0xB0, 0xA7, 0x7A, 0xEC, 0xEC, 0x19, 0x6A, 0xCC, 0xC5, 0x29, 0x73,
+    // gx
+    0xAA, 0x87, 0xCA, 0x22, 0xBE, 0x8B, 0x05, 0x37, 0x8E, 0xB1, 0xC7, 0x1E, 0xF3, 0x20, 0xAD, 0x74,
+    0x6E, 0x1D, 0x3B, 0x62, 0x8B, 0xA7, 0x9B, 0x98, 0x59, 0xF7, 0x41, 0xE0, 0x82, 0x54, 0x2A, 0x38,
+    0x55, 0x02, 0xF2, 0x5D, 0xBF, 0x55, 0x29, 0x6C, 0x3A, 0x54, 0x5E, 0x38, 0x72, 0x76, 0x0A, 0xB7,
+    // gy
+    0x36, 0x17, 0xDE, 0x4A, 0x96, 0x26, 0x2C, 0x6F, 0x5D, 0x9E, 0x98, 0xBF, 0x92, 0x92, 0xDC, 0x29,
+    0xF8, 0xF4, 0x1D, 0xBD, 0x28, 0x9A, 0x14, 0x7C, 0xE9, 0xDA, 0x31, 0x13, 0xB5, 0xF0, 0xB8, 0xC0,
+    0x0A, 0x60, 0xB1, 0xCE, 0x1D, 0x7E, 0x81, 0x9D, 0x7A, 0x43, 0x1D, 0x7C, 0x90, 0xEA, 0x0E, 0x5F,
+};
+
+static const byte ec_p521_oid[] = {0x2B, 0x81, 0x04, 0x00, 0x23};
+static const byte ec_p521_params[] = {
+    // p
+    0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF,
+    // a
+    0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFC,
+    // b
+    0x00, 0x51, 0x95, 0x3E, 0xB9, 0x61, 0x8E, 0x1C, 0x9A, 0x1F, 0x92, 0x9A, 0x21, 0xA0, 0xB6, 0x85,
+    0x40, 0xEE, 0xA2, 0xDA, 0x72, 0x5B, 0x99, 0xB3, 0x15, 0xF3, 0xB8, 0xB4, 0x89, 0x91, 0x8E, 0xF1,
+    0x09, 0xE1, 0x56, 0x19, 0x39, 0x51, 0xEC, 0x7E, 0x93, 0x7B, 0x16, 0x52, 0xC0, 0xBD, 0x3B, 0xB1,
+    0xBF, 0x07, 0x35, 0x73, 0xDF, 0x88, 0x3D, 0x2C, 0x34, 0xF1, 0xEF, 0x45, 0x1F, 0xD4, 0x6B, 0x50,
+    0x3F, 0x00,
+    // q
+    0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFA, 0x51, 0x86, 0x87, 0x83, 0xBF, 0x2F, 0x96, 0x6B, 0x7F, 0xCC, 0x01, 0x48, 0xF7, 0x09,
+    0xA5, 0xD0, 0x3B, 0xB5, 0xC9, 0xB8, 0x89, 0x9C, 0x47, 0xAE, 0xBB, 0x6F, 0xB7, 0x1E, 0x91, 0x38,
+    0x64, 0x09,
+    // gx
+    0x00, 0xC6, 0x85, 0x8E, 0x06, 0xB7, 0x04, 0x04, 0xE9, 0xCD, 0x9E, 0x3E, 0xCB, 0x66, 0x23, 0x95,
+    0xB4, 0x42, 0x9C, 0x64, 0x81, 0x39, 0x05, 0x3F, 0xB5, 0x21, 0xF8, 0x28, 0xAF, 0x60, 0x6B, 0x4D,
+    0x3D, 0xBA, 0xA1, 0x4B, 0x5E, 0x77, 0xEF, 0xE7, 0x59, 0x28, 0xFE, 0x1D, 0xC1, 0x27, 0xA2, 0xFF,
+    0xA8, 0xDE, 0x33, 0x48, 0xB3, 0xC1, 0x85, 0x6A, 0x42, 0x9B, 0xF9, 0x7E, 0x7E, 0x31, 0xC2, 0xE5,
+    0xBD, 0x66,
+    // gy
+    0x01, 0x18, 0x39, 0x29, 0x6A, 0x78, 0x9A, 0x3B, 0xC0, 0x04, 0x5C, 0x8A, 0x5F, 0xB4, 0x2C, 0x7D,
+    0x1B, 0xD9, 0x98, 0xF5, 0x44, 0x49, 0x57, 0x9B, 0x44, 0x68, 0x17, 0xAF, 0xBD, 0x17, 0x27, 0x3E,
+    0x66, 0x2C, 0x97, 0xEE, 0x72, 0x99, 0x5E, 0xF4, 0x26, 0x40, 0xC5, 0x50, 0xB9, 0x01, 0x3F, 0xAD,
+    0x07, 0x61, 0x35, 0x3C, 0x70, 0x86, 0xA2, 0x72, 0xC2, 0x40, 0x88, 0xBE, 0x94, 0x76, 0x9F, 0xD1,
+    0x66, 0x50,
+};
+
+static const byte ec_secp256k1_oid[] = {0x2B, 0x81, 0x04, 0x00, 0x0A};
+static const byte ec_secp256k1_params[] = {
+    // p
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFC, 0x2F,
+    // a
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // b
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07,
+    // q
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41,
+    // gx
+    0x79, 0xBE, 0x66, 0x7E, 0xF9, 0xDC, 0xBB, 0xAC, 0x55, 0xA0, 0x62, 0x95, 0xCE, 0x87, 0x0B, 0x07,
+    0x02, 0x9B, 0xFC, 0xDB, 0x2D, 0xCE, 0x28, 0xD9, 0x59, 0xF2, 0x81, 0x5B, 0x16, 0xF8, 0x17, 0x98,
+    // gy
+    0x48, 0x3A, 0xDA, 0x77, 0x26, 0xA3, 0xC4, 0x65, 0x5D, 0xA4, 0xFB, 0xFC, 0x0E, 0x11, 0x08, 0xA8,
+    0xFD, 0x17, 0xB4, 0x48, 0xA6, 0x85, 0x54, 0x19, 0x9C, 0x47, 0xD0, 0x8F, 0xFB, 0x10, 0xD4, 0xB8,
+};
+
+static const byte ec_brainpoolp256r1_oid[] = {0x2B, 0x24, 0x03, 0x03, 0x02, 0x08, 0x01, 0x01, 0x07};
+static const byte ec_brainpoolp256r1_params[] = {
+    // p
+    0xA9, 0xFB, 0x57, 0xDB, 0xA1, 0xEE, 0xA9, 0xBC, 0x3E, 0x66, 0x0A, 0x90, 0x9D, 0x83, 0x8D, 0x72,
+    0x6E, 0x3B, 0xF6, 0x23, 0xD5, 0x26, 0x20, 0x28, 0x20, 0x13, 0x48, 0x1D, 0x1F, 0x6E, 0x53, 0x77,
+    // a
+    0x7D, 0x5A, 0x09, 0x75, 0xFC, 0x2C, 0x30, 0x57, 0xEE, 0xF6, 0x75, 0x30, 0x41, 0x7A, 0xFF, 0xE7,
+    0xFB, 0x80, 0x55, 0xC1, 0x26, 0xDC, 0x5C, 0x6C, 0xE9, 0x4A, 0x4B, 0x44, 0xF3, 0x30, 0xB5, 0xD9,
+    // b
+    0x26, 0xDC, 0x5C, 0x6C, 0xE9, 0x4A, 0x4B, 0x44, 0xF3, 0x30, 0xB5, 0xD9, 0xBB, 0xD7, 0x7C, 0xBF,
+    0x95, 0x84, 0x16, 0x29, 0x5C, 0xF7, 0xE1, 0xCE, 0x6B, 0xCC, 0xDC, 0x18, 0xFF, 0x8C, 0x07, 0xB6,
+    // q
+    0xA9, 0xFB, 0x57, 0xDB, 0xA1, 0xEE, 0xA9, 0xBC, 0x3E, 0x66, 0x0A, 0x90, 0x9D, 0x83, 0x8D, 0x71,
+    0x8C, 0x39, 0x7A, 0xA3, 0xB5, 0x61, 0xA6, 0xF7, 0x90, 0x1E, 0x0E, 0x82, 0x97, 0x48, 0x56, 0xA7,
+    // gx
+    0x8B, 0xD2, 0xAE, 0xB9, 0xCB, 0x7E, 0x57, 0xCB, 0x2C, 0x4B, 0x48, 0x2F, 0xFC, 0x81, 0xB7, 0xAF,
+    0xB9, 0xDE, 0x27, 0xE1, 0xE3, 0xBD, 0x23, 0xC2, 0x3A, 0x44, 0x53, 0xBD, 0x9A, 0xCE, 0x32, 0x62,
+    // gy
+    0x54, 0x7E, 0xF8, 0x35, 0xC3, 0xDA, 0xC4, 0xFD, 0x97, 0xF8, 0x46, 0x1A, 0x14, 0x61, 0x1D, 0xC9,
+    0xC2, 0x77, 0x45, 0x13, 0x2D, 0xED, 0x8E, 0x54, 0x5C, 0x1D, 0x54, 0xC7, 0x2F, 0x04, 0x69, 0x97,
+};
+
+static const ecc_named_curve_t ec_named_curves[] = {
+    {"P192", "secp192r1", ec_p192_oid, sizeof(ec_p192_oid), 24, ec_p192_params},
+    {"P224", "secp224r1", ec_p224_oid, sizeof(ec_p224_oid), 28, ec_p224_params},
+    {"P256", "secp256r1", ec_p256_oid, sizeof(ec_p256_oid), 32, ec_p256_params},
+    {"P384", "secp384r1", ec_p384_oid, sizeof(ec_p384_oid), 48, ec_p384_params},
+    {"P521", "secp521r1", ec_p521_oid, sizeof(ec_p521_oid), 66, ec_p521_params},
+    {"secp256k1", NULL, ec_secp256k1_oid, sizeof(ec_secp256k1_oid), 32, ec_secp256k1_params},
+    {"brainpoolP256r1", NULL, ec_brainpoolp256r1_oid, sizeof(ec_brainpoolp256r1_oid), 32, ec_brainpoolp256r1_params},
+};
+
+static const ecc_named_curve_t *ec_named_curve_find_oid(const byte *oid, size_t oid_len)
+{
+    for (size_t i = 0; i < MP_ARRAY_SIZE(ec_named_curves); i++)
+    {
+        const ecc_named_curve_t *nc = &ec_named_curves[i];
+        if (nc->oid_len == oid_len && memcmp(nc->oid, oid, oid_len) == 0)
+        {
+            return nc;
+        }
+    }
+    return NULL;
+}
+
+static const ecc_named_curve_t *ec_named_curve_find(mp_obj_t name_or_oid)
+{
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(name_or_oid, &bufinfo, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_STR(name_or_oid))
+    {
+        return ec_named_curve_find_oid(bufinfo.buf, bufinfo.len);
+    }
+    for (size_t i = 0; i < MP_ARRAY_SIZE(ec_named_curves); i++)
+    {
+        const ecc_named_curve_t *nc = &ec_named_curves[i];
+        if ((strlen(nc->name) == bufinfo.len && memcmp(nc->name, bufinfo.buf, bufinfo.len) == 0) ||
+            (nc->alias != NULL && strlen(nc->alias) == bufinfo.len && memcmp(nc->alias, bufinfo.buf, bufinfo.len) == 0))
+        {
+            return nc;
+        }
+    }
+    return NULL;
+}
+
+/*
+    One ecc_curve_t per entry of ec_named_curves, built from the ROM bytes on
+    first use and kept for the life of the VM, so that every Curve and key of
+    a named curve shares its parameters and its comb and wNAF tables. A
+    Curve whose attributes are set copies them first, see curve_attr.
+*/
+#define EC_NAMED_CURVES (7)
+MP_STATIC_ASSERT(MP_ARRAY_SIZE(ec_named_curves) == EC_NAMED_CURVES);
+// the declaration goes to mpstate.h as is, so the size is spelled out
+MP_REGISTER_ROOT_POINTER(struct _ecc_curve_t *ucrypto_named_curves[7]);
+
+static ecc_curve_t *ec_named_curve_get(const ecc_named_curve_t *nc)
+{
+    ecc_curve_t **cached = &MP_STATE_VM(ucrypto_named_curves)[nc - ec_named_curves];
+    if (*cached != NULL)
+    {
+        return *cached;
+    }
+
+    ecc_curve_t *curve = m_new_obj(ecc_curve_t);
+    curve->p = fp_alloc();
+    curve->a = fp_alloc();
+    curve->b = fp_alloc();
+    curve->q = fp_alloc();
+    curve->g = m_new_obj(ecc_point_t);
+    curve->g->x = fp_alloc();
+    curve->g->y = fp_alloc();
+
+    curve->precomp = m_new0(ecc_curve_precomp_t, 1);
+
+    // straight from the ROM bytes, no int objects in between
+    const byte *params = nc->params;
+    fp_read_unsigned_bin(curve->p, params, nc->size);
+    fp_read_unsigned_bin(curve->a, params += nc->size, nc->size);
+    fp_read_unsigned_bin(curve->b, params += nc->size, nc->size);
+    fp_read_unsigned_bin(curve->q, params += nc->size, nc->size);
+    fp_read_unsigned_bin(curve->g->x, params += nc->size, nc->size);
+    fp_read_unsigned_bin(curve->g->y, params += nc->size, nc->size);
+
+    size_t name_len = strlen(nc->name);
+    vstr_init(&curve->name, name_len);
+    vstr_add_strn(&curve->name, nc->name, name_len);
+    vstr_init(&curve->oid, nc->oid_len);
+    vstr_add_strn(&curve->oid, (const char *)nc->oid, nc->oid_len);
+
+    *cached = curve;
+    return curve;
+}
+
+// a new Curve object on the shared parameters of a named curve
+static mp_curve_t *new_named_curve(const ecc_named_curve_t *nc)
+{
+    mp_curve_t *curve = m_new_obj(mp_curve_t);
+    curve->base.type = &curve_type;
+    curve->ecc_curve = ec_named_curve_get(nc);
+    return curve;
+}
+
+static mp_obj_t named_curve(mp_obj_t name_or_oid)
+{
+    /*
+        name_or_oid (str/bytes): name of the curve, like 'P256' or 'secp256r1', or the bytes of its object identifier
+    */
+    if (!MP_OBJ_IS_STR_OR_BYTES(name_or_oid))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_STR_BYTES_BUT, mp_obj_get_type_str(name_or_oid));
+    }
+    const ecc_named_curve_t *nc = ec_named_curve_find(name_or_oid);
+    if (nc == NULL)
+    {
+        mp_raise_ValueError(ERROR_UNKNOWN_CURVE);
+    }
+
+    return MP_OBJ_FROM_PTR(new_named_curve(nc));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(named_curve_obj, named_curve);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_named_curve_obj, MP_ROM_PTR(&named_curve_obj));
+
+///////////////////////////////////// Point ////////////////////////////////////
+
+static bool ec_point_equal(ecc_point_t *p1, ecc_point_t *p2)
+{
+    // check x coords
+    if (fp_cmp(p1->x, p2->x) != FP_EQ)
+    {
+        return false;
+    }
+    // check y coords
+    if (fp_cmp(p1->y, p2->y) != FP_EQ)
+    {
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////// Scratch ///////////////////////////////////
+
+#ifndef EC_SCRATCH_BLOCK
+#define EC_SCRATCH_BLOCK (8)
+#endif
+
+// fp_int's kept by the scratch cached in a curve, enough for a signature
+#ifndef MICROPY_PY_UCRYPTO_EC_SCRATCH_KEEP
+#define MICROPY_PY_UCRYPTO_EC_SCRATCH_KEEP (24)
+#endif
+
+/*
+    The temporaries of the EC primitives are taken from a scratch stack
+    instead of the heap: a primitive remembers the mark on entry and gives
+    back everything it took on exit. One scratch is cached per curve, so in
+    steady state a scalar multiplication or a signature allocates nothing;
+    the wNAF tables take a few more blocks, released at the end of the call.
+*/
+static ecc_scratch_t *ec_scratch_acquire(ecc_curve_t *curve)
+{
+    // without a GIL the other core may be taking the cached scratch too
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    ecc_scratch_t *scratch = curve->precomp->scratch;
+    bool cached = (scratch != NULL && !scratch->busy);
+    if (cached)
+    {
+        scratch->busy = true;
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+
+    if (!cached)
+    {
+        // first use, or the cached scratch is held by another operation; only one of the
+        // threads allocating here at the same time may install its scratch in the curve
+        scratch = m_new0(ecc_scratch_t, 1);
+        scratch->busy = true;
+        atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        if (curve->precomp->scratch == NULL)
+        {
+            curve->precomp->scratch = scratch;
+        }
+        MICROPY_END_ATOMIC_SECTION(atomic_state);
+    }
+    // an exception raised while growing a released loop left it set
+    scratch->nogil = false;
+    return scratch;
+}
+
+static void ec_scratch_done(ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    // the cached scratch of a curve is installed once, by the thread that allocated it, and never replaced
+    bool cached = (scratch == curve->precomp->scratch);
+    size_t keep = 0;
+    if (cached)
+    {
+        keep = (MICROPY_PY_UCRYPTO_EC_SCRATCH_KEEP + EC_SCRATCH_BLOCK - 1) / EC_SCRATCH_BLOCK;
+    }
+
+    while (scratch->nblocks > keep)
+    {
+        m_del(fp_int, scratch->blocks[--scratch->nblocks], EC_SCRATCH_BLOCK);
+    }
+    scratch->used = 0;
+
+    if (cached)
+    {
+        // the release, another thread may claim it from here on
+        mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        scratch->busy = false;
+        MICROPY_END_ATOMIC_SECTION(atomic_state);
+    }
+    else
+    {
+        m_del(fp_int *, scratch->blocks, scratch->capacity);
+        m_del_obj(ecc_scratch_t, scratch);
+    }
+}
+
+// next free fp_int of the scratch, set to zero
+static fp_int *ec_scratch_get(ecc_scratch_t *scratch)
+{
+    size_t block = scratch->used / EC_SCRATCH_BLOCK;
+    if (block == scratch->nblocks)
+    {
+        if (scratch->nogil)
+        {
+            UCRYPTO_GIL_ENTER();
+        }
+        if (scratch->nblocks == scratch->capacity)
+        {
+            scratch->blocks = m_renew(fp_int *, scratch->blocks, scratch->capacity, scratch->capacity + 4);
+            scratch->capacity += 4;
+        }
+        scratch->blocks[scratch->nblocks++] = m_new(fp_int, EC_SCRATCH_BLOCK);
+        if (scratch->nogil)
+        {
+            UCRYPTO_GIL_EXIT();
+        }
+    }
+    fp_int *a = &scratch->blocks[block][scratch->used++ % EC_SCRATCH_BLOCK];
+    fp_zero(a);
+    return a;
+}
+
+// the loop that follows runs with the GIL released, taking its temporaries from scratch only
+static void ec_scratch_gil_exit(ecc_scratch_t *scratch)
+{
+    scratch->nogil = true;
+    UCRYPTO_GIL_EXIT();
+}
+
+static void ec_scratch_gil_enter(ecc_scratch_t *scratch)
+{
+    UCRYPTO_GIL_ENTER();
+    scratch->nogil = false;
+}
+
+static size_t ec_scratch_mark(ecc_scratch_t *scratch)
+{
+    return scratch->used;
+}
+
+// give back every fp_int taken since mark
+static void ec_scratch_release(ecc_scratch_t *scratch, size_t mark)
+{
+    scratch->used = mark;
+}
+
+static void ec_scratch_point(ecc_point_t *P, ecc_scratch_t *scratch)
+{
+    P->x = ec_scratch_get(scratch);
+    P->y = ec_scratch_get(scratch);
+}
+
+static void ec_scratch_jacobian(ecc_jacobian_point_t *P, ecc_scratch_t *scratch)
+{
+    P->x = ec_scratch_get(scratch);
+    P->y = ec_scratch_get(scratch);
+    P->z = ec_scratch_get(scratch);
+}
+
+///////////////////////////////// Affine points ////////////////////////////////
+
+static void ec_point_double(ecc_point_t *rop, ecc_point_t *op, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    UCRYPTO_STATS_INC(POINT_DOUBLE);
+    if (fp_cmp_d(op->x, 0) == FP_EQ && fp_cmp_d(op->y, 0) == FP_EQ)
+    {
+        fp_set(rop->x, 0);
+        fp_set(rop->y, 0);
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *numer = ec_scratch_get(scratch);
+    fp_int *denom = ec_scratch_get(scratch);
+    fp_int *lambda = ec_scratch_get(scratch);
+
+    // calculate lambda
+    fp_mul(op->x, op->x, numer);
+    fp_mul_d(numer, 3, numer);
+    fp_add(numer, curve->a, numer);
+    fp_mul_d(op->y, 2, denom);
+
+    // handle 2P = identity case
+    if (fp_invmod(denom, curve->p, denom) != FP_OKAY)
+    {
+        fp_set(rop->x, 0);
+        fp_set(rop->y, 0);
+
+        ec_scratch_release(scratch, mark);
+        return;
+    }
+
+    fp_mul(numer, denom, lambda);
+    fp_mod(lambda, curve->p, lambda);
+
+    // calculate resulting x coord
+    fp_mul(lambda, lambda, rop->x);
+    fp_sub(rop->x, op->x, rop->x);
+    fp_sub(rop->x, op->x, rop->x);
+    fp_mod(rop->x, curve->p, rop->x);
+
+    // calculate resulting y coord
+    fp_sub(op->x, rop->x, rop->y);
+    fp_mul(lambda, rop->y, rop->y);
+    fp_sub(rop->y, op->y, rop->y);
+    fp_mod(rop->y, curve->p, rop->y);
+
+    ec_scratch_release(scratch, mark);
+}
+
+static void ec_point_add(ecc_point_t *rop, ecc_point_t *op1, ecc_point_t *op2, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    UCRYPTO_STATS_INC(POINT_ADD);
+    // handle the identity element
+    if (fp_cmp_d(op1->x, 0) == FP_EQ && fp_cmp_d(op1->y, 0) == FP_EQ && fp_cmp_d(op2->x, 0) == FP_EQ && fp_cmp_d(op2->y, 0) == FP_EQ)
+    {
+        fp_set(rop->x, 0);
+        fp_set(rop->y, 0);
+        return;
+    }
+    else if (fp_cmp_d(op1->x, 0) == FP_EQ && fp_cmp_d(op1->y, 0) == FP_EQ)
+    {
+        fp_copy(op2->x, rop->x);
+        fp_copy(op2->y, rop->y);
+        return;
+    }
+    else if (fp_cmp_d(op2->x, 0) == FP_EQ && fp_cmp_d(op2->y, 0) == FP_EQ)
+    {
+        fp_copy(op1->x, rop->x);
+        fp_copy(op1->y, rop->y);
+        return;
+    }
+
+    if (ec_point_equal(op1, op2))
+    {
+        ec_point_double(rop, op1, curve, scratch);
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+
+    // check if points sum to identity element
+    fp_int *negy = ec_scratch_get(scratch);
+
+    fp_sub(curve->p, op2->y, negy);
+    if (fp_cmp(op1->x, op2->x) == FP_EQ && fp_cmp(op1->y, negy) == 0)
+    {
+        fp_set(rop->x, 0);
+        fp_set(rop->y, 0);
+
+        ec_scratch_release(scratch, mark);
+        return;
+    }
+
+    fp_int *xdiff = ec_scratch_get(scratch);
+    fp_int *ydiff = ec_scratch_get(scratch);
+    fp_int *lambda = ec_scratch_get(scratch);
+
+    // calculate lambda
+    fp_sub(op2->y, op1->y, ydiff);
+    fp_sub(op2->x, op1->x, xdiff);
+    fp_invmod(xdiff, curve->p, xdiff);
+    fp_mul(ydiff, xdiff, lambda);
+    fp_mod(lambda, curve->p, lambda);
+
+    // calculate resulting x coord
+    fp_mul(lambda, lambda, rop->x);
+    fp_sub(rop->x, op1->x, rop->x);
+    fp_sub(rop->x, op2->x, rop->x);
+    fp_mod(rop->x, curve->p, rop->x);
+
+    // calculate resulting y coord
+    fp_sub(op1->x, rop->x, rop->y);
+    fp_mul(lambda, rop->y, rop->y);
+    fp_sub(rop->y, op1->y, rop->y);
+    fp_mod(rop->y, curve->p, rop->y);
+
+    ec_scratch_release(scratch, mark);
+}
+
+//////////////////////////////// Field backends ///////////////////////////////
+
+#define EC_FIELD_UNKNOWN (0)
+#define EC_FIELD_GENERIC (1)
+#define EC_FIELD_P256 (2)
+#define EC_FIELD_SECP256K1 (3)
+#define EC_FIELD_MONTGOMERY (4)
+
+#define EC_A_GENERIC (0)
+#define EC_A_ZERO (1)
+#define EC_A_MINUS_3 (2)
+
+#define EC_P256_P "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF"
+#define EC_SECP256K1_P "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F"
+
+/*
+    Pick the field backend and the doubling formula from the curve parameters,
+    once per curve. Field elements inside the scalar multiplications are kept
+    in the representation of the backend: plain residues for the dedicated
+    primes, x * R mod p for the Montgomery backend used by any other odd p.
+*/
+static void ec_curve_detect(ecc_curve_t *curve)
+{
+    ecc_curve_precomp_t *precomp = curve->precomp;
+    fp_int *t = fp_alloc();
+
+    precomp->field = EC_FIELD_GENERIC;
+    fp_read_radix(t, EC_P256_P, 16);
+    if (fp_cmp(curve->p, t) == FP_EQ)
+    {
+        precomp->field = EC_FIELD_P256;
+    }
+    fp_read_radix(t, EC_SECP256K1_P, 16);
+    if (fp_cmp(curve->p, t) == FP_EQ)
+    {
+        precomp->field = EC_FIELD_SECP256K1;
+    }
+    if (precomp->field == EC_FIELD_GENERIC && fp_montgomery_setup(curve->p, &precomp->mp) == FP_OKAY)
+    {
+        precomp->field = EC_FIELD_MONTGOMERY;
+    }
+
+    precomp->one = fp_alloc();
+    precomp->a = fp_alloc();
+    fp_mod(curve->a, curve->p, precomp->a);
+    if (precomp->field == EC_FIELD_MONTGOMERY)
+    {
+        // one = R mod p, r2 = R^2 mod p, a = a * R mod p
+        precomp->r2 = fp_alloc();
+        fp_montgomery_calc_normalization(precomp->one, curve->p);
+        fp_mulmod(precomp->one, precomp->one, curve->p, precomp->r2);
+        fp_mulmod(precomp->a, precomp->one, curve->p, precomp->a);
+    }
+    else
+    {
+        fp_set(precomp->one, 1);
+    }
+
+    curve->precomp->a_kind = EC_A_GENERIC;
+    fp_mod(curve->a, curve->p, t);
+    if (fp_iszero(t))
+    {
+        curve->precomp->a_kind = EC_A_ZERO;
+    }
+    else
+    {
+        fp_add_d(t, 3, t);
+        if (fp_cmp(t, curve->p) == FP_EQ)
+        {
+            curve->precomp->a_kind = EC_A_MINUS_3;
+        }
+    }
+
+    fp_free(t);
+}
+
+static int ec_curve_field(ecc_curve_t *curve)
+{
+    if (curve->precomp->field == EC_FIELD_UNKNOWN)
+    {
+        ec_curve_detect(curve);
+    }
+    return curve->precomp->field;
+}
+
+// a as little-endian 32-bit words, a must fit in n words
+static void ec_fp_to_words(uint32_t *w, int n, fp_int *a)
+{
+    memset(w, 0, n * sizeof(uint32_t));
+    for (int i = 0; i < a->used; i++)
+    {
+#if DIGIT_BIT == 64
+        w[2 * i] = (uint32_t)a->dp[i];
+        w[2 * i + 1] = (uint32_t)(a->dp[i] >> 32);
+#else
+        w[i] = (uint32_t)a->dp[i];
+#endif
+    }
+}
+
+// a = 8 little-endian 32-bit words, then a mod p for a < 2p
+static void ec_words_to_fp(fp_int *a, uint32_t *w, fp_int *p)
+{
+    int old_used = a->used;
+#if DIGIT_BIT == 64
+    for (int i = 0; i < 4; i++)
+    {
+        a->dp[i] = (fp_digit)w[2 * i] | ((fp_digit)w[2 * i + 1] << 32);
+    }
+    a->used = 4;
+#else
+    for (int i = 0; i < 8; i++)
+    {
+        a->dp[i] = w[i];
+    }
+    a->used = 8;
+#endif
+    for (int i = a->used; i < old_used; i++)
+    {
+        a->dp[i] = 0;
+    }
+    a->sign = FP_ZPOS;
+    fp_clamp(a);
+
+    if (fp_cmp_mag(a, p) != FP_LT)
+    {
+        fp_sub(a, p, a);
+    }
+}
+
+/*
+    NIST P-256, p = 2^256 - 2^224 + 2^192 + 2^96 - 1, FIPS 186-4 D.2.3:
+    the 16 words of c are folded with the sums s1 + 2s2 + 2s3 + s4 + s5 -
+    d1 - d2 - d3 - d4, every column just adds or subtracts a few words.
+*/
+static void ec_reduce_p256(fp_int *c, fp_int *p)
+{
+    uint32_t w[16];
+    int64_t t[8];
+
+    ec_fp_to_words(w, 16, c);
+
+    t[0] = (int64_t)w[0] + w[8] + w[9] - w[11] - w[12] - w[13] - w[14];
+    t[1] = (int64_t)w[1] + w[9] + w[10] - w[12] - w[13] - w[14] - w[15];
+    t[2] = (int64_t)w[2] + w[10] + w[11] - w[13] - w[14] - w[15];
+    t[3] = (int64_t)w[3] + 2 * (int64_t)w[11] + 2 * (int64_t)w[12] + w[13] - w[15] - w[8] - w[9];
+    t[4] = (int64_t)w[4] + 2 * (int64_t)w[12] + 2 * (int64_t)w[13] + w[14] - w[9] - w[10];
+    t[5] = (int64_t)w[5] + 2 * (int64_t)w[13] + 2 * (int64_t)w[14] + w[15] - w[10] - w[11];
+    t[6] = (int64_t)w[6] + 3 * (int64_t)w[14] + 2 * (int64_t)w[15] + w[13] - w[8] - w[9];
+    t[7] = (int64_t)w[7] + 3 * (int64_t)w[15] + w[8] - w[10] - w[11] - w[12] - w[13];
+
+    int64_t carry = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        carry += t[i];
+        w[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    // carry * 2^256 = carry * (2^224 - 2^192 - 2^96 + 1) (mod p)
+    while (carry != 0)
+    {
+        int64_t f = carry;
+        carry = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            carry += w[i];
+            if (i == 0 || i == 7)
+            {
+                carry += f;
+            }
+            else if (i == 3 || i == 6)
+            {
+                carry -= f;
+            }
+            w[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+    }
+
+    ec_words_to_fp(c, w, p);
+}
+
+// secp256k1, p = 2^256 - 2^32 - 977, so 2^256 = 2^32 + 977 (mod p)
+static void ec_reduce_secp256k1(fp_int *c, fp_int *p)
+{
+    uint32_t w[16];
+
+    ec_fp_to_words(w, 16, c);
+
+    // c = H * 2^256 + L = L + H * 977 + H * 2^32
+    uint64_t carry = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        carry += (uint64_t)w[i] + (uint64_t)w[8 + i] * 977;
+        if (i > 0)
+        {
+            carry += w[7 + i];
+        }
+        w[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    carry += w[15];
+
+    while (carry != 0)
+    {
+        uint64_t f = carry;
+        carry = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            carry += w[i];
+            if (i == 0)
+            {
+                carry += f * 977;
+            }
+            else if (i == 1)
+            {
+                carry += f;
+            }
+            w[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+    }
+
+    ec_words_to_fp(c, w, p);
+}
+
+// reduce the product c of two field elements, c / R mod p for the Montgomery backend
+static void ec_field_reduce(fp_int *c, ecc_curve_t *curve)
+{
+    int field = ec_curve_field(curve);
+    if (field == EC_FIELD_MONTGOMERY)
+    {
+        fp_montgomery_reduce(c, curve->p, curve->precomp->mp);
+        return;
+    }
+    if (c->sign == FP_ZPOS && c->used * DIGIT_BIT <= 512)
+    {
+        if (field == EC_FIELD_P256)
+        {
+            UCRYPTO_STATS_INC(FP_REDUCE);
+            ec_reduce_p256(c, curve->p);
+            return;
+        }
+        else if (field == EC_FIELD_SECP256K1)
+        {
+            UCRYPTO_STATS_INC(FP_REDUCE);
+            ec_reduce_secp256k1(c, curve->p);
+            return;
+        }
+    }
+    fp_mod(c, curve->p, c);
+}
+
+// 1 in the field representation of the curve
+static fp_int *ec_field_one(ecc_curve_t *curve)
+{
+    ec_curve_field(curve);
+    return curve->precomp->one;
+}
+
+// c = c mod p for a small multiple c of a field element
+static void ec_field_mod_small(fp_int *c, ecc_curve_t *curve)
+{
+    while (fp_cmp_mag(c, curve->p) != FP_LT)
+    {
+        fp_sub(c, curve->p, c);
+    }
+}
+
+// r = a in the field representation of the curve
+static void ec_field_enter(fp_int *a, fp_int *r, ecc_curve_t *curve)
+{
+    fp_mod(a, curve->p, r);
+    if (ec_curve_field(curve) == EC_FIELD_MONTGOMERY)
+    {
+        fp_mul(r, curve->precomp->r2, r);
+        fp_montgomery_reduce(r, curve->p, curve->precomp->mp);
+    }
+}
+
+// r = a back from the field representation of the curve
+static void ec_field_leave(fp_int *a, fp_int *r, ecc_curve_t *curve)
+{
+    fp_copy(a, r);
+    if (ec_curve_field(curve) == EC_FIELD_MONTGOMERY)
+    {
+        fp_montgomery_reduce(r, curve->p, curve->precomp->mp);
+    }
+}
+
+// r = 1 / a, both in the field representation of the curve
+static void ec_field_inv(fp_int *a, fp_int *r, ecc_curve_t *curve)
+{
+    ec_field_leave(a, r, curve);
+    fp_invmod(r, curve->p, r);
+    ec_field_enter(r, r, curve);
+}
+
+// candidates of the non-square search, a prime p past it is all but impossible
+#define EC_SQRT_NON_SQUARE_TRIES (256)
+
+// r = a^(1/2) mod p, plain residues, false if a is not a square, ValueError if p is not an odd prime
+static bool ec_field_sqrt(fp_int *a, fp_int *r, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *e = ec_scratch_get(scratch);
+    fp_int *t = ec_scratch_get(scratch);
+    fp_int *root = ec_scratch_get(scratch);
+
+    fp_mod(a, curve->p, t);
+    if (fp_iszero(t))
+    {
+        fp_zero(r);
+        ec_scratch_release(scratch, mark);
+        return true;
+    }
+
+    if ((curve->p->dp[0] & 3) == 3)
+    {
+        // p = 3 (mod 4): a^((p + 1) / 4)
+        fp_add_d(curve->p, 1, e);
+        fp_div_2d(e, 2, e, NULL);
+        fp_exptmod(t, e, curve->p, root);
+    }
+    else
+    {
+        // Tonelli-Shanks, p - 1 = q * 2^m with q odd
+        fp_int *z = ec_scratch_get(scratch);
+        fp_int *c = ec_scratch_get(scratch);
+        fp_int *b = ec_scratch_get(scratch);
+        fp_int *pm1 = ec_scratch_get(scratch);
+
+        // p = 1 or an even p would never end the loops below
+        bool prime = fp_isodd(curve->p) && fp_cmp_d(curve->p, 1) == FP_GT;
+        if (prime)
+        {
+            fp_sub_d(curve->p, 1, pm1);
+            fp_copy(pm1, e);
+        }
+        int m = 0;
+        while (prime && fp_iseven(e))
+        {
+            fp_div_2(e, e);
+            m++;
+        }
+
+        // z = first non-square, z^((p - 1) / 2) = -1, a value other than 1 or -1 only if p is not prime
+        fp_div_2(pm1, b);
+        fp_set(z, 2);
+        for (int tries = 0; prime; tries++)
+        {
+            fp_exptmod(z, b, curve->p, c);
+            if (fp_cmp(c, pm1) == FP_EQ)
+            {
+                break;
+            }
+            prime = tries < EC_SQRT_NON_SQUARE_TRIES && fp_cmp_d(c, 1) == FP_EQ;
+            fp_add_d(z, 1, z);
+        }
+        if (!prime)
+        {
+            ec_scratch_done(curve, scratch);
+            mp_raise_ValueError(ERROR_CURVE_FIELD_NOT_PRIME);
+        }
+
+        // c = z^q, root = a^((q + 1) / 2), t = a^q
+        fp_exptmod(z, e, curve->p, c);
+        fp_add_d(e, 1, b);
+        fp_div_2(b, b);
+        fp_exptmod(t, b, curve->p, root);
+        fp_exptmod(t, e, curve->p, t);
+
+        while (fp_cmp_d(t, 1) != FP_EQ)
+        {
+            // least i, t^(2^i) = 1
+            int i = 0;
+            fp_copy(t, b);
+            while (fp_cmp_d(b, 1) != FP_EQ && i < m)
+            {
+                fp_sqrmod(b, curve->p, b);
+                i++;
+            }
+            if (i >= m)
+            {
+                break;
+            }
+
+            // b = c^(2^(m - i - 1))
+            fp_copy(c, b);
+            for (int j = 0; j < m - i - 1; j++)
+            {
+                fp_sqrmod(b, curve->p, b);
+            }
+            m = i;
+            fp_sqrmod(b, curve->p, c);
+            fp_mulmod(t, c, curve->p, t);
+            fp_mulmod(root, b, curve->p, root);
+        }
+    }
+
+    // a square only if root^2 = a
+    fp_sqrmod(root, curve->p, e);
+    fp_mod(a, curve->p, t);
+    bool square = (fp_cmp(e, t) == FP_EQ);
+    fp_copy(root, r);
+
+    ec_scratch_release(scratch, mark);
+    return square;
+}
+
+////////////////////////////// Jacobian coordinates ///////////////////////////
+
+// c = a * b (mod p)
+static void ec_field_mul(fp_int *a, fp_int *b, fp_int *c, ecc_curve_t *curve)
+{
+    fp_mul(a, b, c);
+    ec_field_reduce(c, curve);
+}
+
+// c = a^2 (mod p)
+static void ec_field_sqr(fp_int *a, fp_int *c, ecc_curve_t *curve)
+{
+    fp_sqr(a, c);
+    ec_field_reduce(c, curve);
+}
+
+// c = a + b (mod p), a and b already reduced
+static void ec_field_add(fp_int *a, fp_int *b, fp_int *c, ecc_curve_t *curve)
+{
+    fp_add(a, b, c);
+    if (fp_cmp_mag(c, curve->p) != FP_LT)
+    {
+        fp_sub(c, curve->p, c);
+    }
+}
+
+// c = a - b (mod p), a and b already reduced
+static void ec_field_sub(fp_int *a, fp_int *b, fp_int *c, ecc_curve_t *curve)
+{
+    fp_sub(a, b, c);
+    if (fp_cmp_d(c, 0) == FP_LT)
+    {
+        fp_add(c, curve->p, c);
+    }
+}
+
+// bit 'bit' of |k|, without copying k
+static int ec_scalar_bit(fp_int *k, int bit)
+{
+    int digit = bit / DIGIT_BIT;
+    if (digit >= k->used)
+    {
+        return 0;
+    }
+    return (int)((k->dp[digit] >> (bit % DIGIT_BIT)) & 1);
+}
+
+static void ec_jacobian_copy(ecc_jacobian_point_t *op, ecc_jacobian_point_t *rop)
+{
+    fp_copy(op->x, rop->x);
+    fp_copy(op->y, rop->y);
+    fp_copy(op->z, rop->z);
+}
+
+static void ec_jacobian_from_affine(ecc_jacobian_point_t *rop, ecc_point_t *op, ecc_curve_t *curve)
+{
+    // affine (0, 0) is the identity element
+    if (fp_iszero(op->x) && fp_iszero(op->y))
+    {
+        fp_set(rop->x, 1);
+        fp_set(rop->y, 1);
+        fp_zero(rop->z);
+        return;
+    }
+    ec_field_enter(op->x, rop->x, curve);
+    ec_field_enter(op->y, rop->y, curve);
+    fp_copy(ec_field_one(curve), rop->z);
+}
+
+// same as ec_jacobian_from_affine for an affine point already in the field representation
+static void ec_jacobian_from_normalized(ecc_jacobian_point_t *rop, ecc_point_t *op, ecc_curve_t *curve)
+{
+    if (fp_iszero(op->x) && fp_iszero(op->y))
+    {
+        fp_set(rop->x, 1);
+        fp_set(rop->y, 1);
+        fp_zero(rop->z);
+        return;
+    }
+    fp_copy(op->x, rop->x);
+    fp_copy(op->y, rop->y);
+    fp_copy(ec_field_one(curve), rop->z);
+}
+
+// affine point in the field representation, (0, 0) for the identity element
+static void ec_jacobian_normalize(ecc_point_t *rop, ecc_jacobian_point_t *op, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (fp_iszero(op->z))
+    {
+        fp_zero(rop->x);
+        fp_zero(rop->y);
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *zinv = ec_scratch_get(scratch);
+    fp_int *zinv2 = ec_scratch_get(scratch);
+
+    ec_field_inv(op->z, zinv, curve);
+    ec_field_sqr(zinv, zinv2, curve);
+    ec_field_mul(op->x, zinv2, rop->x, curve);
+    ec_field_mul(zinv, zinv2, zinv2, curve);
+    ec_field_mul(op->y, zinv2, rop->y, curve);
+
+    ec_scratch_release(scratch, mark);
+}
+
+// the only inversion of a scalar multiplication
+static void ec_jacobian_to_affine(ecc_point_t *rop, ecc_jacobian_point_t *op, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    ec_jacobian_normalize(rop, op, curve, scratch);
+    ec_field_leave(rop->x, rop->x, curve);
+    ec_field_leave(rop->y, rop->y, curve);
+}
+
+// rop = 2 * op, rop may alias op
+static void ec_jacobian_double(ecc_jacobian_point_t *rop, ecc_jacobian_point_t *op, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    UCRYPTO_STATS_INC(POINT_DOUBLE);
+    if (fp_iszero(op->z) || fp_iszero(op->y))
+    {
+        fp_set(rop->x, 1);
+        fp_set(rop->y, 1);
+        fp_zero(rop->z);
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *delta = ec_scratch_get(scratch);
+    fp_int *gamma = ec_scratch_get(scratch);
+    fp_int *beta = ec_scratch_get(scratch);
+    fp_int *alpha = ec_scratch_get(scratch);
+    fp_int *t = ec_scratch_get(scratch);
+
+    // delta = z^2, gamma = y^2, beta = x * gamma
+    ec_field_sqr(op->z, delta, curve);
+    ec_field_sqr(op->y, gamma, curve);
+    ec_field_mul(op->x, gamma, beta, curve);
+
+    // alpha = 3 * x^2 + a * delta^2
+    ec_curve_field(curve);
+    if (curve->precomp->a_kind == EC_A_MINUS_3)
+    {
+        // 3 * (x - delta) * (x + delta)
+        ec_field_sub(op->x, delta, t, curve);
+        ec_field_add(op->x, delta, alpha, curve);
+        ec_field_mul(t, alpha, alpha, curve);
+        fp_mul_d(alpha, 3, alpha);
+        ec_field_mod_small(alpha, curve);
+    }
+    else
+    {
+        ec_field_sqr(op->x, alpha, curve);
+        fp_mul_d(alpha, 3, alpha);
+        ec_field_mod_small(alpha, curve);
+        if (curve->precomp->a_kind != EC_A_ZERO)
+        {
+            ec_field_sqr(delta, t, curve);
+            ec_field_mul(t, curve->precomp->a, t, curve);
+            ec_field_add(alpha, t, alpha, curve);
+        }
+    }
+
+    // z3 = (y + z)^2 - gamma - delta
+    ec_field_add(op->y, op->z, t, curve);
+    ec_field_sqr(t, t, curve);
+    ec_field_sub(t, gamma, t, curve);
+    ec_field_sub(t, delta, rop->z, curve);
+
+    // x3 = alpha^2 - 8 * beta
+    fp_mul_2d(beta, 2, beta);
+    ec_field_mod_small(beta, curve);
+    ec_field_sqr(alpha, t, curve);
+    ec_field_sub(t, beta, t, curve);
+    ec_field_sub(t, beta, rop->x, curve);
+
+    // y3 = alpha * (4 * beta - x3) - 8 * gamma^2
+    ec_field_sub(beta, rop->x, t, curve);
+    ec_field_mul(alpha, t, t, curve);
+    ec_field_sqr(gamma, gamma, curve);
+    fp_mul_2d(gamma, 3, gamma);
+    ec_field_mod_small(gamma, curve);
+    ec_field_sub(t, gamma, rop->y, curve);
+
+    ec_scratch_release(scratch, mark);
+}
+
+// rop = op1 + op2, op2 in affine coordinates (mixed addition), rop may alias op1
+static void ec_jacobian_add_affine(ecc_jacobian_point_t *rop, ecc_jacobian_point_t *op1, ecc_point_t *op2, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    UCRYPTO_STATS_INC(POINT_ADD);
+    // handle the identity element
+    if (fp_iszero(op2->x) && fp_iszero(op2->y))
+    {
+        if (rop != op1)
+        {
+            ec_jacobian_copy(op1, rop);
+        }
+        return;
+    }
+    if (fp_iszero(op1->z))
+    {
+        ec_jacobian_from_normalized(rop, op2, curve);
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *z1z1 = ec_scratch_get(scratch);
+    fp_int *h = ec_scratch_get(scratch);
+    fp_int *r = ec_scratch_get(scratch);
+    fp_int *hhh = ec_scratch_get(scratch);
+    fp_int *v = ec_scratch_get(scratch);
+
+    // u2 = x2 * z1^2, s2 = y2 * z1^3
+    ec_field_sqr(op1->z, z1z1, curve);
+    ec_field_mul(op2->x, z1z1, h, curve);
+    ec_field_mul(op1->z, z1z1, z1z1, curve);
+    ec_field_mul(op2->y, z1z1, r, curve);
+
+    // h = u2 - x1, r = s2 - y1
+    ec_field_sub(h, op1->x, h, curve);
+    ec_field_sub(r, op1->y, r, curve);
+
+    if (fp_iszero(h))
+    {
+        if (fp_iszero(r))
+        {
+            // same point
+            ec_jacobian_double(rop, op1, curve, scratch);
+        }
+        else
+        {
+            // points sum to identity element
+            fp_set(rop->x, 1);
+            fp_set(rop->y, 1);
+            fp_zero(rop->z);
+        }
+    }
+    else
+    {
+        // v = x1 * h^2, hhh = h^3
+        ec_field_sqr(h, v, curve);
+        ec_field_mul(h, v, hhh, curve);
+        ec_field_mul(op1->x, v, v, curve);
+
+        // z3 = z1 * h
+        ec_field_mul(op1->z, h, rop->z, curve);
+
+        // x3 = r^2 - h^3 - 2 * v
+        ec_field_sqr(r, h, curve);
+        ec_field_sub(h, hhh, h, curve);
+        ec_field_sub(h, v, h, curve);
+        ec_field_sub(h, v, h, curve);
+
+        // y3 = r * (v - x3) - y1 * h^3
+        ec_field_sub(v, h, v, curve);
+        ec_field_mul(r, v, v, curve);
+        ec_field_mul(op1->y, hhh, hhh, curve);
+        ec_field_sub(v, hhh, rop->y, curve);
+        fp_copy(h, rop->x);
+    }
+
+    ec_scratch_release(scratch, mark);
+}
+
+// rop = op1 + op2, rop may alias op1 or op2
+static void ec_jacobian_add(ecc_jacobian_point_t *rop, ecc_jacobian_point_t *op1, ecc_jacobian_point_t *op2, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    UCRYPTO_STATS_INC(POINT_ADD);
+    // handle the identity element
+    if (fp_iszero(op1->z))
+    {
+        if (rop != op2)
+        {
+            ec_jacobian_copy(op2, rop);
+        }
+        return;
+    }
+    if (fp_iszero(op2->z))
+    {
+        if (rop != op1)
+        {
+            ec_jacobian_copy(op1, rop);
+        }
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *u1 = ec_scratch_get(scratch);
+    fp_int *s1 = ec_scratch_get(scratch);
+    fp_int *h = ec_scratch_get(scratch);
+    fp_int *r = ec_scratch_get(scratch);
+    fp_int *t = ec_scratch_get(scratch);
+
+    // u1 = x1 * z2^2, s1 = y1 * z2^3
+    ec_field_sqr(op2->z, t, curve);
+    ec_field_mul(op1->x, t, u1, curve);
+    ec_field_mul(op2->z, t, t, curve);
+    ec_field_mul(op1->y, t, s1, curve);
+
+    // h = x2 * z1^2 - u1, r = y2 * z1^3 - s1
+    ec_field_sqr(op1->z, t, curve);
+    ec_field_mul(op2->x, t, h, curve);
+    ec_field_mul(op1->z, t, t, curve);
+    ec_field_mul(op2->y, t, r, curve);
+    ec_field_sub(h, u1, h, curve);
+    ec_field_sub(r, s1, r, curve);
+
+    if (fp_iszero(h))
+    {
+        if (fp_iszero(r))
+        {
+            // same point
+            ec_jacobian_double(rop, op1, curve, scratch);
+        }
+        else
+        {
+            // points sum to identity element
+            fp_set(rop->x, 1);
+            fp_set(rop->y, 1);
+            fp_zero(rop->z);
+        }
+    }
+    else
+    {
+        // z3 = z1 * z2 * h
+        ec_field_mul(op1->z, op2->z, t, curve);
+        ec_field_mul(t, h, rop->z, curve);
+
+        // u1 = u1 * h^2, h = h^3
+        ec_field_sqr(h, t, curve);
+        ec_field_mul(u1, t, u1, curve);
+        ec_field_mul(h, t, h, curve);
+
+        // x3 = r^2 - h^3 - 2 * u1 * h^2
+        ec_field_sqr(r, t, curve);
+        ec_field_sub(t, h, t, curve);
+        ec_field_sub(t, u1, t, curve);
+        ec_field_sub(t, u1, rop->x, curve);
+
+        // y3 = r * (u1 * h^2 - x3) - s1 * h^3
+        ec_field_sub(u1, rop->x, u1, curve);
+        ec_field_mul(r, u1, u1, curve);
+        ec_field_mul(s1, h, s1, curve);
+        ec_field_sub(u1, s1, rop->y, curve);
+    }
+
+    ec_scratch_release(scratch, mark);
+}
+
+#if MICROPY_PY_UCRYPTO_HW
+// rop = scalar * point on the hardware, false to compute it here
+static bool ec_point_mul_hw(ecc_point_t *rop, ecc_point_t *point, fp_int *scalar, ecc_curve_t *curve)
+{
+    if (fp_cmp_d(scalar, 0) != FP_GT || fp_cmp(scalar, curve->q) != FP_LT || (fp_iszero(point->x) && fp_iszero(point->y)))
+    {
+        return false;
+    }
+
+    UCRYPTO_GIL_ROOTS(curve, rop->x, rop->y, point->x, point->y, scalar);
+    UCRYPTO_GIL_EXIT();
+    int err = ucrypto_hw_point_mul(rop->x, rop->y, point->x, point->y, scalar, curve->p, curve->a, curve->b, curve->q);
+    UCRYPTO_GIL_ENTER();
+    if (err != FP_OKAY)
+    {
+        return false;
+    }
+    UCRYPTO_STATS_INC(HW_CALLS);
+    return true;
+}
+#else
+#define ec_point_mul_hw(rop, point, scalar, curve) (false)
+#endif
+
+/*
+    R0 = point, R1 = 2 * point and k = |scalar|, the registers of the ladder of
+    ec_point_mul for a point and a scalar that are not the identity or 0.
+    Returns the first bit of k for ec_ladder_bit, the top one is consumed.
+*/
+static int ec_ladder_start(ecc_jacobian_point_t *R0, ecc_jacobian_point_t *R1, fp_int *k, ecc_point_t *point, fp_int *scalar, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    ec_jacobian_from_affine(R0, point, curve);
+
+    // -point.y % curve.p, -scalar
+    if (fp_cmp_d(scalar, 0) == FP_LT && !fp_iszero(R0->y))
+    {
+        fp_sub(curve->p, R0->y, R0->y);
+    }
+    fp_abs(scalar, k);
+
+    ec_jacobian_double(R1, R0, curve, scratch);
+
+    return fp_count_bits(k) - 2;
+}
+
+// one step of the ladder for the scalar bit, R1 - R0 stays the point
+static void ec_ladder_bit(ecc_jacobian_point_t *R0, ecc_jacobian_point_t *R1, int bit, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (bit)
+    {
+        ec_jacobian_add(R0, R0, R1, curve, scratch);
+        ec_jacobian_double(R1, R1, curve, scratch);
+    }
+    else
+    {
+        ec_jacobian_add(R1, R1, R0, curve, scratch);
+        ec_jacobian_double(R0, R0, curve, scratch);
+    }
+}
+
+// rop = scalar * point, Montgomery ladder: one add and one double per bit whatever the scalar is
+static void ec_point_mul(ecc_point_t *rop, ecc_point_t *point, fp_int *scalar, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    // handle the identity element
+    if ((fp_cmp_d(point->x, 0) == FP_EQ && fp_cmp_d(point->y, 0) == FP_EQ) || fp_iszero(scalar))
+    {
+        fp_set(rop->x, 0);
+        fp_set(rop->y, 0);
+        return;
+    }
+    if (ec_point_mul_hw(rop, point, scalar, curve))
+    {
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *k = ec_scratch_get(scratch);
+    ecc_jacobian_point_t R0, R1;
+    ec_scratch_jacobian(&R0, scratch);
+    ec_scratch_jacobian(&R1, scratch);
+
+    int i = ec_ladder_start(&R0, &R1, k, point, scalar, curve, scratch);
+    UCRYPTO_GIL_ROOTS(curve, scratch);
+    ec_scratch_gil_exit(scratch);
+    for (; i >= 0; i--)
+    {
+        ec_ladder_bit(&R0, &R1, ec_scalar_bit(k, i), curve, scratch);
+    }
+    ec_scratch_gil_enter(scratch);
+
+    ec_jacobian_to_affine(rop, &R0, curve, scratch);
+
+    ec_scratch_release(scratch, mark);
+}
+
+//////////////////////////////////// wNAF /////////////////////////////////////
+
+// window width for a scalar of 'bits' bits, balancing table size against additions
+static int ec_wnaf_width(int bits)
+{
+    if (bits <= 80)
+    {
+        return 3;
+    }
+    else if (bits <= 160)
+    {
+        return 4;
+    }
+    else if (bits <= 320)
+    {
+        return 5;
+    }
+    return 6;
+}
+
+/*
+    Width-w non-adjacent form of |k| into naf[0..bits], every non-zero digit
+    is odd, lies in (-2^(w-1), 2^(w-1)) and is followed by at least w - 1 zeros.
+    Returns the number of digits.
+*/
+static int ec_scalar_wnaf(int8_t *naf, fp_int *k, int w)
+{
+    int bits = fp_count_bits(k);
+    int len = bits + 1;
+    int carry = 0;
+    int bit = 0;
+
+    memset(naf, 0, len);
+    while (bit < len)
+    {
+        if (ec_scalar_bit(k, bit) == carry)
+        {
+            bit++;
+            continue;
+        }
+
+        int now = w;
+        if (now > len - bit)
+        {
+            now = len - bit;
+        }
+
+        int word = carry;
+        for (int i = 0; i < now; i++)
+        {
+            word += ec_scalar_bit(k, bit + i) << i;
+        }
+
+        carry = (word >> (w - 1)) & 1;
+        word -= carry << w;
+
+        naf[bit] = (int8_t)word;
+        bit += now;
+    }
+
+    while (len > 0 && naf[len - 1] == 0)
+    {
+        len--;
+    }
+    return len;
+}
+
+// normalize n jacobian points with a single inversion (Montgomery's trick), see ec_jacobian_normalize
+static void ec_jacobian_batch_normalize(ecc_point_t *rop, ecc_jacobian_point_t *op, int n, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *acc = ec_scratch_get(scratch);
+    fp_int *inv = ec_scratch_get(scratch);
+    fp_int *zinv = ec_scratch_get(scratch);
+    fp_int *zinv2 = ec_scratch_get(scratch);
+
+    // rop[i].x holds the product of the non-zero z's before i
+    fp_copy(ec_field_one(curve), acc);
+    for (int i = 0; i < n; i++)
+    {
+        fp_copy(acc, rop[i].x);
+        if (!fp_iszero(op[i].z))
+        {
+            ec_field_mul(acc, op[i].z, acc, curve);
+        }
+    }
+
+    ec_field_inv(acc, inv, curve);
+
+    for (int i = n - 1; i >= 0; i--)
+    {
+        if (fp_iszero(op[i].z))
+        {
+            fp_zero(rop[i].x);
+            fp_zero(rop[i].y);
+            continue;
+        }
+
+        // zinv = 1 / z_i, inv = 1 / (z_0 * ... * z_(i-1))
+        ec_field_mul(inv, rop[i].x, zinv, curve);
+        ec_field_mul(inv, op[i].z, inv, curve);
+
+        ec_field_sqr(zinv, zinv2, curve);
+        ec_field_mul(op[i].x, zinv2, rop[i].x, curve);
+        ec_field_mul(zinv, zinv2, zinv2, curve);
+        ec_field_mul(op[i].y, zinv2, rop[i].y, curve);
+    }
+
+    ec_scratch_release(scratch, mark);
+}
+
+// fill J with the odd multiples P, 3P, 5P, ..., (2^(w-1) - 1)P, P taken from jpoint when given
+static void ec_wnaf_table_fill(ecc_jacobian_point_t *J, ecc_point_t *point, ecc_jacobian_point_t *jpoint, int w, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    int n = 1 << (w - 2);
+
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_jacobian_point_t P2;
+    ec_scratch_jacobian(&P2, scratch);
+
+    if (jpoint != NULL)
+    {
+        ec_jacobian_copy(jpoint, &J[0]);
+    }
+    else
+    {
+        ec_jacobian_from_affine(&J[0], point, curve);
+    }
+    ec_jacobian_double(&P2, &J[0], curve, scratch);
+    for (int i = 1; i < n; i++)
+    {
+        ec_jacobian_add(&J[i], &J[i - 1], &P2, curve, scratch);
+    }
+
+    ec_scratch_release(scratch, mark);
+}
+
+// rop += digit * P, P taken from the odd multiples table
+static void ec_wnaf_add(ecc_jacobian_point_t *rop, ecc_point_t *table, int digit, fp_int *negy, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (digit > 0)
+    {
+        ec_jacobian_add_affine(rop, rop, &table[digit >> 1], curve, scratch);
+    }
+    else
+    {
+        ecc_point_t *T = &table[(-digit) >> 1];
+        ecc_point_t neg = {T->x, negy};
+        fp_zero(negy);
+        if (!fp_iszero(T->y))
+        {
+            fp_sub(curve->p, T->y, negy);
+        }
+        ec_jacobian_add_affine(rop, rop, &neg, curve, scratch);
+    }
+}
+
+/*
+    rop = sum(scalars[i] * points[i]), interleaved wNAF (Straus): all the
+    terms share one chain of doublings, the odd multiples tables of every
+    term are normalized with a single inversion. Not constant time.
+    A term given in jpoints (NULL, or NULL entries, for affine ones) is
+    normalized along with the tables, R is left in jacobian coordinates.
+*/
+static void ec_point_multi_mul_jacobian(ecc_jacobian_point_t *R, ecc_point_t **points, ecc_jacobian_point_t **jpoints, fp_int **scalars, size_t n, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    int *w = m_new(int, n);
+    int *len = m_new(int, n);
+    int *size = m_new(int, n);
+    int8_t **naf = m_new(int8_t *, n);
+    ecc_point_t **table = m_new(ecc_point_t *, n);
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *k = ec_scratch_get(scratch);
+    fp_int *negy = ec_scratch_get(scratch);
+
+    int total = 0, maxlen = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        w[i] = len[i] = size[i] = 0;
+        naf[i] = NULL;
+        table[i] = NULL;
+
+        // terms equal to the identity element are skipped
+        ecc_jacobian_point_t *jpoint = (jpoints != NULL ? jpoints[i] : NULL);
+        if ((jpoint != NULL ? fp_iszero(jpoint->z) : (fp_iszero(points[i]->x) && fp_iszero(points[i]->y))) || fp_iszero(scalars[i]))
+        {
+            continue;
+        }
+
+        fp_abs(scalars[i], k);
+        w[i] = ec_wnaf_width(fp_count_bits(k));
+        size[i] = fp_count_bits(k) + 1;
+        naf[i] = m_new(int8_t, size[i]);
+        len[i] = ec_scalar_wnaf(naf[i], k, w[i]);
+
+        // a negative scalar flips the sign of every digit
+        if (fp_cmp_d(scalars[i], 0) == FP_LT)
+        {
+            for (int j = 0; j < len[i]; j++)
+            {
+                naf[i][j] = -naf[i][j];
+            }
+        }
+
+        total += 1 << (w[i] - 2);
+        if (len[i] > maxlen)
+        {
+            maxlen = len[i];
+        }
+    }
+
+    ecc_point_t *T = m_new(ecc_point_t, total);
+    ecc_jacobian_point_t *J = m_new(ecc_jacobian_point_t, total);
+    for (int i = 0; i < total; i++)
+    {
+        ec_scratch_point(&T[i], scratch);
+    }
+
+    // the jacobian tables are given back to the scratch once normalized
+    size_t jmark = ec_scratch_mark(scratch);
+    for (int i = 0; i < total; i++)
+    {
+        ec_scratch_jacobian(&J[i], scratch);
+    }
+
+    int offset = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (w[i] != 0)
+        {
+            ec_wnaf_table_fill(&J[offset], points[i], (jpoints != NULL ? jpoints[i] : NULL), w[i], curve, scratch);
+            table[i] = &T[offset];
+            offset += 1 << (w[i] - 2);
+        }
+    }
+
+    ec_jacobian_batch_normalize(T, J, total, curve, scratch);
+
+    ec_scratch_release(scratch, jmark);
+    m_del(ecc_jacobian_point_t, J, total);
+
+    fp_set(R->x, 1);
+    fp_set(R->y, 1);
+    fp_zero(R->z);
+
+    UCRYPTO_GIL_ROOTS(curve, scratch, R->x, R->y, R->z, len, naf, table, T);
+    ec_scratch_gil_exit(scratch);
+    for (int bit = maxlen - 1; bit >= 0; bit--)
+    {
+        ec_jacobian_double(R, R, curve, scratch);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (bit < len[i] && naf[i][bit] != 0)
+            {
+                ec_wnaf_add(R, table[i], naf[i][bit], negy, curve, scratch);
+            }
+        }
+    }
+    ec_scratch_gil_enter(scratch);
+
+    ec_scratch_release(scratch, mark);
+    m_del(ecc_point_t, T, total);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (naf[i] != NULL)
+        {
+            m_del(int8_t, naf[i], size[i]);
+        }
+    }
+
+    m_del(int, w, n);
+    m_del(int, len, n);
+    m_del(int, size, n);
+    m_del(int8_t *, naf, n);
+    m_del(ecc_point_t *, table, n);
+}
+
+static void ec_point_multi_mul(ecc_point_t *rop, ecc_point_t **points, fp_int **scalars, size_t n, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_jacobian_point_t R;
+    ec_scratch_jacobian(&R, scratch);
+
+    ec_point_multi_mul_jacobian(&R, points, NULL, scalars, n, curve, scratch);
+    ec_jacobian_to_affine(rop, &R, curve, scratch);
+
+    ec_scratch_release(scratch, mark);
+}
+
+// rop = scalar * point, variable-base wNAF (not constant time)
+static void ec_point_mul_wnaf(ecc_point_t *rop, ecc_point_t *point, fp_int *scalar, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (ec_point_mul_hw(rop, point, scalar, curve))
+    {
+        return;
+    }
+    ec_point_multi_mul(rop, &point, &scalar, 1, curve, scratch);
+}
+
+/////////////////////////////// Fixed-base comb ///////////////////////////////
+
+#ifndef MICROPY_PY_UCRYPTO_COMB_TEETH
+#define MICROPY_PY_UCRYPTO_COMB_TEETH (5)
+#endif
+
+// entry index of a table of affine points, x then y, each stored in 'digits' fp_digit's
+static void ec_table_store(fp_digit *table, int digits, int index, ecc_point_t *point)
+{
+    fp_digit *dst = table + (size_t)index * 2 * digits;
+    memset(dst, 0, 2 * digits * sizeof(fp_digit));
+    memcpy(dst, point->x->dp, point->x->used * sizeof(fp_digit));
+    memcpy(dst + digits, point->y->dp, point->y->used * sizeof(fp_digit));
+}
+
+static void ec_table_load(ecc_point_t *rop, fp_digit *table, int digits, int index)
+{
+    fp_digit *src = table + (size_t)index * 2 * digits;
+    fp_zero(rop->x);
+    fp_zero(rop->y);
+    memcpy(rop->x->dp, src, digits * sizeof(fp_digit));
+    memcpy(rop->y->dp, src + digits, digits * sizeof(fp_digit));
+    rop->x->used = rop->y->used = digits;
+    fp_clamp(rop->x);
+    fp_clamp(rop->y);
+}
+
+static void ec_comb_store(ecc_comb_t *comb, int index, ecc_point_t *point)
+{
+    ec_table_store(comb->table, comb->digits, index, point);
+}
+
+static void ec_comb_load(ecc_point_t *rop, ecc_comb_t *comb, int index)
+{
+    ec_table_load(rop, comb->table, comb->digits, index);
+}
+
+/*
+    Lim-Lee comb, entry j - 1 of the table holds sum(2^(i * spacing) * G) for
+    every bit i set in j, so k * G costs 'spacing' doubles and 'spacing' mixed
+    additions. The recoding of ec_point_mul_base_jacobian only reads the odd j.
+*/
+static void ec_comb_build(ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    ecc_comb_t *comb = m_new_obj(ecc_comb_t);
+    comb->teeth = MICROPY_PY_UCRYPTO_COMB_TEETH;
+    comb->spacing = (fp_count_bits(curve->q) + comb->teeth - 1) / comb->teeth;
+    comb->digits = curve->p->used;
+    comb->table = m_new(fp_digit, (size_t)((1 << comb->teeth) - 1) * 2 * comb->digits);
+
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_point_t T, B;
+    ecc_jacobian_point_t J;
+    ec_scratch_point(&T, scratch);
+    ec_scratch_point(&B, scratch);
+    ec_scratch_jacobian(&J, scratch);
+
+    // the teeth, 2^(i * spacing) * G
+    ec_jacobian_from_affine(&J, curve->g, curve);
+    for (int i = 0; i < comb->teeth; i++)
+    {
+        if (i > 0)
+        {
+            for (int j = 0; j < comb->spacing; j++)
+            {
+                ec_jacobian_double(&J, &J, curve, scratch);
+            }
+        }
+        ec_jacobian_normalize(&T, &J, curve, scratch);
+        ec_comb_store(comb, (1 << i) - 1, &T);
+    }
+
+    // every other entry adds its highest tooth to an entry already computed
+    for (int j = 3; j < (1 << comb->teeth); j++)
+    {
+        if ((j & (j - 1)) == 0)
+        {
+            continue;
+        }
+        int high = 1;
+        while ((j >> high) > 1)
+        {
+            high++;
+        }
+        ec_comb_load(&T, comb, j - (1 << high) - 1);
+        ec_comb_load(&B, comb, (1 << high) - 1);
+        ec_jacobian_from_normalized(&J, &T, curve);
+        ec_jacobian_add_affine(&J, &J, &B, curve, scratch);
+        ec_jacobian_normalize(&T, &J, curve, scratch);
+        ec_comb_store(comb, j - 1, &T);
+    }
+
+    ec_scratch_release(scratch, mark);
+
+    curve->precomp->comb = comb;
+}
+
+static ecc_comb_t *ec_curve_comb(ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (curve->precomp->comb == NULL)
+    {
+        ec_comb_build(curve, scratch);
+    }
+    return curve->precomp->comb;
+}
+
+#if MICROPY_PY_UCRYPTO_COMB_TEETH > 7
+#error "MICROPY_PY_UCRYPTO_COMB_TEETH must fit the 7 bits of a recoded comb digit"
+#endif
+
+// all ones if a == b, else zero, without a branch
+static fp_digit ec_ct_mask_eq(unsigned int a, unsigned int b)
+{
+    return (fp_digit)0 - (fp_digit)(((a ^ b) - 1U) >> (sizeof(unsigned int) * 8 - 1));
+}
+
+// a = b where mask is all ones, a unchanged where it is zero, over the first digits of both
+static void ec_ct_select(fp_int *a, fp_int *b, fp_digit mask, int digits)
+{
+    for (int i = 0; i < digits; i++)
+    {
+        a->dp[i] = (a->dp[i] & ~mask) | (b->dp[i] & mask);
+    }
+    a->used = digits;
+    a->sign = FP_ZPOS;
+    fp_clamp(a);
+}
+
+/*
+    rop = the entry of an odd comb index, negated if bit 7 of digit is set. Every
+    odd entry is read and masked in, so the memory access does not depend on
+    the digit; neg is a temporary.
+*/
+static void ec_comb_select(ecc_point_t *rop, fp_int *neg, ecc_comb_t *comb, unsigned int digit, ecc_curve_t *curve)
+{
+    unsigned int index = digit & 0x7F;
+    fp_zero(rop->x);
+    fp_zero(rop->y);
+    for (unsigned int j = 1; j < (1U << comb->teeth); j += 2)
+    {
+        fp_digit mask = ec_ct_mask_eq(j, index);
+        fp_digit *src = comb->table + (size_t)(j - 1) * 2 * comb->digits;
+        for (int i = 0; i < comb->digits; i++)
+        {
+            rop->x->dp[i] |= src[i] & mask;
+            rop->y->dp[i] |= src[comb->digits + i] & mask;
+        }
+    }
+    rop->x->used = rop->y->used = comb->digits;
+    fp_clamp(rop->x);
+    fp_clamp(rop->y);
+
+    // -y = p - y, the points of the table are not of order 2
+    fp_sub(curve->p, rop->y, neg);
+    ec_ct_select(rop->y, neg, (fp_digit)0 - (fp_digit)(digit >> 7), curve->p->used);
+}
+
+/*
+    R = scalar * G using the comb table of the curve, in jacobian coordinates.
+    The scalar is secret (the nonce of a signature, a private key), so the
+    comb runs the same for every scalar of the curve, as the recoding of
+    mbedtls ecp_mul_comb does: the scalar is made odd by taking q - k for an
+    even k and negating the result, and its columns are recoded into odd
+    signed digits, so that every column adds one entry of the odd half of the
+    table, read with ec_comb_select, and no addition meets the identity.
+*/
+static void ec_point_mul_base_jacobian(ecc_jacobian_point_t *R, fp_int *scalar, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    ecc_comb_t *comb = ec_curve_comb(curve, scratch);
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *k = ec_scratch_get(scratch);
+    fp_int *t = ec_scratch_get(scratch);
+    fp_copy(scalar, k);
+    if (fp_cmp_d(k, 0) == FP_LT || fp_cmp(k, curve->q) != FP_LT)
+    {
+        // G has order q
+        fp_mod(k, curve->q, k);
+    }
+    if (fp_iszero(k))
+    {
+        fp_set(R->x, 1);
+        fp_set(R->y, 1);
+        fp_zero(R->z);
+        ec_scratch_release(scratch, mark);
+        return;
+    }
+
+    // k odd, q is
+    fp_digit even = (fp_digit)0 - (fp_digit)((k->dp[0] & 1) ^ 1);
+    fp_sub(curve->q, k, t);
+    ec_ct_select(k, t, even, curve->q->used);
+
+    // the classic comb columns, then each made odd by borrowing from the one below
+    int spacing = comb->spacing;
+    unsigned char *x = m_new(unsigned char, spacing + 1);
+    for (int i = 0; i < spacing; i++)
+    {
+        x[i] = 0;
+        for (int j = 0; j < comb->teeth; j++)
+        {
+            x[i] |= (unsigned char)(ec_scalar_bit(k, i + j * spacing) << j);
+        }
+    }
+    x[spacing] = 0;
+    unsigned char c = 0;
+    for (int i = 1; i <= spacing; i++)
+    {
+        unsigned char cc = x[i] & c;
+        x[i] ^= c;
+        c = cc;
+        unsigned char adjust = 1 - (x[i] & 1);
+        c |= x[i] & (x[i - 1] * adjust);
+        x[i] ^= x[i - 1] * adjust;
+        x[i - 1] |= adjust << 7;
+    }
+
+    ecc_point_t T;
+    ec_scratch_point(&T, scratch);
+
+    UCRYPTO_GIL_ROOTS(curve, scratch, R->x, R->y, R->z, comb, comb->table, x);
+    ec_scratch_gil_exit(scratch);
+    ec_comb_select(&T, t, comb, x[spacing], curve);
+    ec_jacobian_from_normalized(R, &T, curve);
+    for (int col = spacing - 1; col >= 0; col--)
+    {
+        ec_jacobian_double(R, R, curve, scratch);
+        ec_comb_select(&T, t, comb, x[col], curve);
+        ec_jacobian_add_affine(R, R, &T, curve, scratch);
+    }
+    ec_scratch_gil_enter(scratch);
+
+    // (q - k) * G = -(k * G)
+    fp_sub(curve->p, R->y, t);
+    ec_ct_select(R->y, t, even, curve->p->used);
+
+    memset(x, 0, spacing + 1);
+    m_del(unsigned char, x, spacing + 1);
+    fp_zero(k);
+    ec_scratch_release(scratch, mark);
+}
+
+// rop = scalar * G
+static void ec_point_mul_base(ecc_point_t *rop, fp_int *scalar, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (ec_point_mul_hw(rop, curve->g, scalar, curve))
+    {
+        return;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_jacobian_point_t R;
+    ec_scratch_jacobian(&R, scratch);
+
+    ec_point_mul_base_jacobian(&R, scalar, curve, scratch);
+    ec_jacobian_to_affine(rop, &R, curve, scratch);
+
+    ec_scratch_release(scratch, mark);
+}
+
+/////////////////////////// Prepared public keys ////////////////////////////
+
+// window of a prepared public key, the wNAF digits must fit an int8_t
+#define EC_WNAF_KEY_WINDOW_MIN (2)
+#define EC_WNAF_KEY_WINDOW_MAX (8)
+
+// window of the odd multiples of G kept with the curve
+#ifndef MICROPY_PY_UCRYPTO_WNAF_G_WINDOW
+#define MICROPY_PY_UCRYPTO_WNAF_G_WINDOW (7)
+#endif
+
+// entries of the table normalized with one inversion, bounds the scratch a wide window takes
+#define EC_WNAF_KEY_CHUNK (8)
+
+/*
+    Odd multiples P, 3P, ..., (2^(w-1) - 1)P of an affine point, normalized
+    once in the field representation, so that a verification with the same
+    key neither rebuilds nor normalizes its table.
+*/
+static ecc_wnaf_key_t *ec_wnaf_key_build(ecc_point_t *point, int w, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    int n = 1 << (w - 2);
+    ecc_wnaf_key_t *key = m_new_obj(ecc_wnaf_key_t);
+    key->w = w;
+    key->digits = curve->p->used;
+    key->table = m_new(fp_digit, (size_t)n * 2 * key->digits);
+
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_point_t T[EC_WNAF_KEY_CHUNK];
+    ecc_jacobian_point_t J[EC_WNAF_KEY_CHUNK];
+    ecc_jacobian_point_t P2;
+    for (int i = 0; i < EC_WNAF_KEY_CHUNK; i++)
+    {
+        ec_scratch_point(&T[i], scratch);
+        ec_scratch_jacobian(&J[i], scratch);
+    }
+    ec_scratch_jacobian(&P2, scratch);
+
+    ec_jacobian_from_affine(&J[0], point, curve);
+    ec_jacobian_double(&P2, &J[0], curve, scratch);
+    for (int base = 0; base < n; base += EC_WNAF_KEY_CHUNK)
+    {
+        int m = n - base < EC_WNAF_KEY_CHUNK ? n - base : EC_WNAF_KEY_CHUNK;
+        for (int i = (base == 0 ? 1 : 0); i < m; i++)
+        {
+            // the first entry of a chunk follows the last one of the previous chunk
+            ec_jacobian_add(&J[i], &J[i == 0 ? EC_WNAF_KEY_CHUNK - 1 : i - 1], &P2, curve, scratch);
+        }
+        ec_jacobian_batch_normalize(T, J, m, curve, scratch);
+        for (int i = 0; i < m; i++)
+        {
+            ec_table_store(key->table, key->digits, base + i, &T[i]);
+        }
+    }
+
+    ec_scratch_release(scratch, mark);
+    return key;
+}
+
+static ecc_wnaf_key_t *ec_curve_wnaf(ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (curve->precomp->wnaf == NULL)
+    {
+        curve->precomp->wnaf = ec_wnaf_key_build(curve->g, MICROPY_PY_UCRYPTO_WNAF_G_WINDOW, curve, scratch);
+    }
+    return curve->precomp->wnaf;
+}
+
+/*
+    R = sum(scalars[i] * keys[i]), 0 <= scalars[i], interleaved wNAF over
+    the tables of the keys, in jacobian coordinates. Not constant time.
+*/
+static void ec_wnaf_key_multi_mul_jacobian(ecc_jacobian_point_t *R, ecc_wnaf_key_t **keys, fp_int **scalars, size_t n, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    int *len = m_new(int, n);
+    int *size = m_new(int, n);
+    int8_t **naf = m_new(int8_t *, n);
+
+    int maxlen = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        size[i] = fp_count_bits(scalars[i]) + 1;
+        naf[i] = m_new(int8_t, size[i]);
+        len[i] = ec_scalar_wnaf(naf[i], scalars[i], keys[i]->w);
+        if (len[i] > maxlen)
+        {
+            maxlen = len[i];
+        }
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_point_t T;
+    ec_scratch_point(&T, scratch);
+
+    // start from the identity element
+    fp_set(R->x, 1);
+    fp_set(R->y, 1);
+    fp_zero(R->z);
+
+    UCRYPTO_GIL_ROOTS(curve, scratch, R->x, R->y, R->z, keys, len, naf);
+    ec_scratch_gil_exit(scratch);
+    for (int bit = maxlen - 1; bit >= 0; bit--)
+    {
+        ec_jacobian_double(R, R, curve, scratch);
+        for (size_t i = 0; i < n; i++)
+        {
+            int digit = (bit < len[i] ? naf[i][bit] : 0);
+            if (digit == 0)
+            {
+                continue;
+            }
+            ec_table_load(&T, keys[i]->table, keys[i]->digits, (digit > 0 ? digit : -digit) >> 1);
+            if (digit < 0 && !fp_iszero(T.y))
+            {
+                fp_sub(curve->p, T.y, T.y);
+            }
+            ec_jacobian_add_affine(R, R, &T, curve, scratch);
+        }
+    }
+    ec_scratch_gil_enter(scratch);
+
+    ec_scratch_release(scratch, mark);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        m_del(int8_t, naf[i], size[i]);
+    }
+    m_del(int, len, n);
+    m_del(int, size, n);
+    m_del(int8_t *, naf, n);
+}
+
+/*
+    R[x] mod q == r, without the inversion of normalizing R: one of the
+    x = r + j * q < p has x * Z^2 == X in the field representation.
+*/
+static bool ec_jacobian_x_mod_q_equal(ecc_jacobian_point_t *R, fp_int *r, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    if (fp_iszero(R->z))
+    {
+        return false;
+    }
+
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *x = ec_scratch_get(scratch);
+    fp_int *t = ec_scratch_get(scratch);
+    fp_int *z2 = ec_scratch_get(scratch);
+
+    ec_field_sqr(R->z, z2, curve);
+    bool equal = false;
+    for (fp_copy(r, x); !equal && fp_cmp(x, curve->p) == FP_LT; fp_add(x, curve->q, x))
+    {
+        ec_field_enter(x, t, curve);
+        ec_field_mul(t, z2, t, curve);
+        equal = (fp_cmp(t, R->x) == FP_EQ);
+    }
+
+    ec_scratch_release(scratch, mark);
+    return equal;
+}
+
+// e = digest as an integer, truncated to the bit length of the curve order
+static void ecdsa_digest_int(fp_int *e, unsigned char *msg, size_t msg_len, bool raw, ecc_curve_t *curve)
+{
+    int digestBits;
+    if (raw)
+    {
+        fp_read_unsigned_bin(e, msg, msg_len);
+        digestBits = msg_len * 8;
+    }
+    else
+    {
+        // digest as hex string
+        fp_read_radix(e, (const char *)msg, 16);
+        digestBits = msg_len * 4;
+    }
+
+    int orderBits = fp_count_bits(curve->q);
+    if (digestBits > orderBits)
+    {
+        fp_div_2d(e, digestBits - orderBits, e, NULL);
+    }
+}
+
+// SHA-256 (FIPS 180-4) and HMAC-SHA-256, enough for the RFC 6979 nonces
+typedef struct _sha256_ctx_t
+{
+    uint32_t state[8];
+    uint64_t length;
+    unsigned char block[64];
+    size_t used;
+} sha256_ctx_t;
+
+typedef struct _hmac_sha256_ctx_t
+{
+    sha256_ctx_t inner;
+    sha256_ctx_t outer;
+} hmac_sha256_ctx_t;
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static void sha256_init(sha256_ctx_t *ctx)
+{
+    static const uint32_t iv[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(ctx->state, iv, sizeof(iv));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+static void sha256_compress(sha256_ctx_t *ctx, const unsigned char *block)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) | (uint32_t)block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = SHA256_ROR(w[i - 15], 7) ^ SHA256_ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = SHA256_ROR(w[i - 2], 17) ^ SHA256_ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (SHA256_ROR(e, 6) ^ SHA256_ROR(e, 11) ^ SHA256_ROR(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        uint32_t t2 = (SHA256_ROR(a, 2) ^ SHA256_ROR(a, 13) ^ SHA256_ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+static void sha256_update(sha256_ctx_t *ctx, const unsigned char *data, size_t len)
+{
+    ctx->length += len;
+    while (len > 0)
+    {
+        size_t n = MIN(len, 64 - ctx->used);
+        memcpy(ctx->block + ctx->used, data, n);
+        ctx->used += n;
+        data += n;
+        len -= n;
+        if (ctx->used == 64)
+        {
+            sha256_compress(ctx, ctx->block);
+            ctx->used = 0;
+        }
+    }
+}
+
+static void sha256_final(sha256_ctx_t *ctx, unsigned char *digest)
+{
+    uint64_t bits = ctx->length * 8;
+    unsigned char pad = 0x80;
+    sha256_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->used != 56)
+    {
+        sha256_update(ctx, &pad, 1);
+    }
+    unsigned char length[8];
+    for (int i = 0; i < 8; i++)
+    {
+        length[i] = (unsigned char)(bits >> (56 - 8 * i));
+    }
+    sha256_update(ctx, length, 8);
+
+    for (int i = 0; i < 8; i++)
+    {
+        digest[4 * i] = (unsigned char)(ctx->state[i] >> 24);
+        digest[4 * i + 1] = (unsigned char)(ctx->state[i] >> 16);
+        digest[4 * i + 2] = (unsigned char)(ctx->state[i] >> 8);
+        digest[4 * i + 3] = (unsigned char)ctx->state[i];
+    }
+}
+
+// key is at most one block, that is all HMAC-DRBG needs
+static void hmac_sha256_init(hmac_sha256_ctx_t *ctx, const unsigned char *key, size_t key_len)
+{
+    unsigned char pad[64];
+
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < key_len; i++)
+    {
+        pad[i] ^= key[i];
+    }
+    sha256_init(&ctx->inner);
+    sha256_update(&ctx->inner, pad, sizeof(pad));
+
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < key_len; i++)
+    {
+        pad[i] ^= key[i];
+    }
+    sha256_init(&ctx->outer);
+    sha256_update(&ctx->outer, pad, sizeof(pad));
+}
+
+static void hmac_sha256_final(hmac_sha256_ctx_t *ctx, unsigned char *mac)
+{
+    unsigned char inner[SHA256_DIGEST_SIZE];
+    sha256_final(&ctx->inner, inner);
+    sha256_update(&ctx->outer, inner, sizeof(inner));
+    sha256_final(&ctx->outer, mac);
+}
+
+// largest curve order the nonce generation accepts, in bytes
+#define ECDSA_RFC6979_MAX_BYTES (FP_MAX_SIZE / 16)
+
+// HMAC-DRBG state of RFC 6979 section 3.2, kept across candidates of k
+typedef struct _ecdsa_rfc6979_t
+{
+    unsigned char V[SHA256_DIGEST_SIZE];
+    unsigned char K[SHA256_DIGEST_SIZE];
+    // int2octets(d) || bits2octets(h1), then reused for T
+    unsigned char buf[2 * ECDSA_RFC6979_MAX_BYTES];
+    hmac_sha256_ctx_t ctx;
+    int qlen;
+    size_t rlen;
+} ecdsa_rfc6979_t;
+
+/*
+    steps b to d of RFC 6979 section 3.2 with HMAC-SHA-256,
+    from the private key d and the digest e already reduced to the bit length of q;
+    k is used as a temporary
+*/
+static void ecdsa_rfc6979_init(ecdsa_rfc6979_t *drbg, fp_int *k, fp_int *d, fp_int *e, ecc_curve_t *curve)
+{
+    drbg->qlen = fp_count_bits(curve->q);
+    drbg->rlen = (drbg->qlen + 7) / 8;
+
+    // x = d mod q and h1 mod q
+    fp_mod(d, curve->q, k);
+    fp_to_unsigned_bin_len(k, drbg->buf, drbg->rlen);
+    fp_mod(e, curve->q, k);
+    fp_to_unsigned_bin_len(k, drbg->buf + drbg->rlen, drbg->rlen);
+    fp_zero(k);
+
+    memset(drbg->V, 0x01, sizeof(drbg->V));
+    memset(drbg->K, 0x00, sizeof(drbg->K));
+
+    // K = HMAC_K(V || i || int2octets(x) || bits2octets(h1)), V = HMAC_K(V), for i = 0 and 1
+    for (unsigned char i = 0; i < 2; i++)
+    {
+        hmac_sha256_init(&drbg->ctx, drbg->K, sizeof(drbg->K));
+        sha256_update(&drbg->ctx.inner, drbg->V, sizeof(drbg->V));
+        sha256_update(&drbg->ctx.inner, &i, 1);
+        sha256_update(&drbg->ctx.inner, drbg->buf, 2 * drbg->rlen);
+        hmac_sha256_final(&drbg->ctx, drbg->K);
+
+        hmac_sha256_init(&drbg->ctx, drbg->K, sizeof(drbg->K));
+        sha256_update(&drbg->ctx.inner, drbg->V, sizeof(drbg->V));
+        hmac_sha256_final(&drbg->ctx, drbg->V);
+    }
+}
+
+// K = HMAC_K(V || 0x00), V = HMAC_K(V), run before each retry of step h
+static void ecdsa_rfc6979_update(ecdsa_rfc6979_t *drbg)
+{
+    unsigned char zero = 0;
+    hmac_sha256_init(&drbg->ctx, drbg->K, sizeof(drbg->K));
+    sha256_update(&drbg->ctx.inner, drbg->V, sizeof(drbg->V));
+    sha256_update(&drbg->ctx.inner, &zero, 1);
+    hmac_sha256_final(&drbg->ctx, drbg->K);
+
+    hmac_sha256_init(&drbg->ctx, drbg->K, sizeof(drbg->K));
+    sha256_update(&drbg->ctx.inner, drbg->V, sizeof(drbg->V));
+    hmac_sha256_final(&drbg->ctx, drbg->V);
+}
+
+// k = next candidate of step h with 0 < k < q
+static void ecdsa_rfc6979_next(ecdsa_rfc6979_t *drbg, fp_int *k, ecc_curve_t *curve)
+{
+    while (true)
+    {
+        size_t tlen = 0;
+        while (tlen < drbg->rlen)
+        {
+            hmac_sha256_init(&drbg->ctx, drbg->K, sizeof(drbg->K));
+            sha256_update(&drbg->ctx.inner, drbg->V, sizeof(drbg->V));
+            hmac_sha256_final(&drbg->ctx, drbg->V);
+
+            size_t n = MIN(sizeof(drbg->V), drbg->rlen - tlen);
+            memcpy(drbg->buf + tlen, drbg->V, n);
+            tlen += n;
+        }
+
+        // bits2int(T)
+        fp_read_unsigned_bin(k, drbg->buf, drbg->rlen);
+        if ((int)(drbg->rlen * 8) > drbg->qlen)
+        {
+            fp_div_2d(k, drbg->rlen * 8 - drbg->qlen, k, NULL);
+        }
+        if (!fp_iszero(k) && fp_cmp(k, curve->q) == FP_LT)
+        {
+            return;
+        }
+
+        ecdsa_rfc6979_update(drbg);
+    }
+}
+
+// k = NULL takes the nonce of RFC 6979
+static void ecdsa_s(ecdsa_signature_t *sig, unsigned char *msg, size_t msg_len, bool raw, fp_int *d, fp_int *k, ecc_curve_t *curve)
+{
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    fp_int *e = ec_scratch_get(scratch);
+    fp_int *kinv = ec_scratch_get(scratch);
+    ecdsa_rfc6979_t drbg;
+    bool deterministic = (k == NULL);
+
+    // convert digest to integer
+    ecdsa_digest_int(e, msg, msg_len, raw, curve);
+
+    if (deterministic)
+    {
+        k = ec_scratch_get(scratch);
+        ecdsa_rfc6979_init(&drbg, k, d, e, curve);
+        ecdsa_rfc6979_next(&drbg, k, curve);
+    }
+
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+
+    while (true)
+    {
+        // R = k * G, r = R[x]
+        ec_point_mul_base(&R, k, curve, scratch);
+        fp_copy(R.x, sig->r);
+        fp_mod(sig->r, curve->q, sig->r);
+
+        // s = (k^-1 * (e + d * r)) mod n
+        fp_invmod(k, curve->q, kinv);
+        fp_zero(sig->s);
+
+        fp_mul(d, sig->r, sig->s);
+        fp_add(sig->s, e, sig->s);
+        fp_mul(sig->s, kinv, sig->s);
+        fp_mod(sig->s, curve->q, sig->s);
+
+        // a caller supplied k is used as is, RFC 6979 moves on to the next k
+        if (!deterministic || (!fp_iszero(sig->r) && !fp_iszero(sig->s)))
+        {
+            break;
+        }
+        ecdsa_rfc6979_update(&drbg);
+        ecdsa_rfc6979_next(&drbg, k, curve);
+    }
+
+    if (deterministic)
+    {
+        fp_zero(k);
+        fp_zero(kinv);
+        memset(&drbg, 0, sizeof(drbg));
+    }
+
+    ec_scratch_done(curve, scratch);
+}
+
+static void ecdsa_s_eth(ecdsa_signature_t *sig, unsigned char *msg, size_t msg_len, fp_int *d, fp_int *k, ecc_curve_t *curve, ecc_point_t *R_out)
+{
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    fp_int *e = ec_scratch_get(scratch);
+    fp_int *kinv = ec_scratch_get(scratch);
+
+    // R = k * G, r = R[x]
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+
+    ec_point_mul_base(&R, k, curve, scratch);
+    fp_copy(R.x, sig->r);
+    fp_mod(sig->r, curve->q, sig->r);
+
+    // Converter digest para inteiro (digest é computado como hex)
+    ecdsa_digest_int(e, msg, msg_len, false, curve);
+
+    // s = (k^-1 * (e + d * r)) mod n
+    fp_invmod(k, curve->q, kinv);
+    fp_zero(sig->s);
+
+    fp_mul(d, sig->r, sig->s);
+    fp_add(sig->s, e, sig->s);
+    fp_mul(sig->s, kinv, sig->s);
+    fp_mod(sig->s, curve->q, sig->s);
+
+    // Copiar R para R_out
+    fp_copy(R.x, R_out->x);
+    fp_copy(R.y, R_out->y);
+
+    // Liberação de memória
+    ec_scratch_done(curve, scratch);
+}
+
+// 0 < r < q and 0 < s < q
+static bool ecdsa_sig_in_range(ecdsa_signature_t *sig, ecc_curve_t *curve)
+{
+    return fp_cmp_d(sig->r, 0) == FP_GT && fp_cmp(sig->r, curve->q) == FP_LT &&
+           fp_cmp_d(sig->s, 0) == FP_GT && fp_cmp(sig->s, curve->q) == FP_LT;
+}
+
+/*
+    u1 = e * w, u2 = r * w, valid if (u1 * G + u2 * Q)[x] mod q == r, w = s^-1 mod q.
+    With the table of a prepared public key in key, Q is not read and both
+    terms come from cached tables.
+*/
+static int ecdsa_v_inverse(ecdsa_signature_t *sig, fp_int *e, fp_int *w, ecc_point_t *Q, ecc_wnaf_key_t *key, ecc_point_t *tmp, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *u1 = ec_scratch_get(scratch);
+    fp_int *u2 = ec_scratch_get(scratch);
+
+    fp_mul(e, w, u1);
+    fp_mod(u1, curve->q, u1);
+    fp_mul(sig->r, w, u2);
+    fp_mod(u2, curve->q, u2);
+
+    fp_int *scalars[2] = {u1, u2};
+    int equal;
+    if (key != NULL)
+    {
+        ecc_jacobian_point_t R;
+        ec_scratch_jacobian(&R, scratch);
+        ecc_wnaf_key_t *keys[2] = {ec_curve_wnaf(curve, scratch), key};
+        ec_wnaf_key_multi_mul_jacobian(&R, keys, scalars, 2, curve, scratch);
+        equal = ec_jacobian_x_mod_q_equal(&R, sig->r, curve, scratch);
+    }
+    else
+    {
+        ecc_point_t *points[2] = {curve->g, Q};
+        ec_point_multi_mul(tmp, points, scalars, 2, curve, scratch);
+        fp_mod(tmp->x, curve->q, tmp->x);
+        equal = (fp_cmp(tmp->x, sig->r) == FP_EQ);
+    }
+
+    ec_scratch_release(scratch, mark);
+    return equal;
+}
+
+static int ecdsa_v(ecdsa_signature_t *sig, unsigned char *msg, size_t msg_len, bool raw, ecc_point_t *Q, ecc_wnaf_key_t *key, ecc_curve_t *curve)
+{
+    // out of range is invalid, and fp_invmod never returns for s = 0
+    if (!ecdsa_sig_in_range(sig, curve))
+    {
+        return false;
+    }
+
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    fp_int *e = ec_scratch_get(scratch);
+    fp_int *w = ec_scratch_get(scratch);
+
+    ecc_point_t tmp;
+    ec_scratch_point(&tmp, scratch);
+
+    // convert digest to integer
+    ecdsa_digest_int(e, msg, msg_len, raw, curve);
+
+    fp_invmod(sig->s, curve->q, w);
+
+    int equal = ecdsa_v_inverse(sig, e, w, Q, key, &tmp, curve, scratch);
+
+    ec_scratch_done(curve, scratch);
+    return equal;
+}
+
+// verifies n signatures (keys[i] the table of a prepared Qs[i], or NULL), s^-1 mod q of all of them share a single inversion:
+// with c[i] = s[0] * ... * s[i], s[i]^-1 = c[i]^-1 * c[i - 1] and c[i - 1]^-1 = c[i]^-1 * s[i]
+static void ecdsa_v_batch(ecdsa_signature_t **sigs, unsigned char **msgs, size_t *msg_lens, ecc_point_t **Qs, ecc_wnaf_key_t **keys, size_t n, ecc_curve_t *curve, bool *valid)
+{
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    fp_int *acc = ec_scratch_get(scratch);
+    fp_int *e = ec_scratch_get(scratch);
+    fp_int *w = ec_scratch_get(scratch);
+    fp_int **c = m_new(fp_int *, n);
+
+    ecc_point_t tmp;
+    ec_scratch_point(&tmp, scratch);
+
+    // signatures out of range are invalid and left out of the product, a zero s would cancel it
+    fp_set(acc, 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        valid[i] = ecdsa_sig_in_range(sigs[i], curve);
+        if (valid[i])
+        {
+            fp_mulmod(acc, sigs[i]->s, curve->q, acc);
+        }
+        c[i] = ec_scratch_get(scratch);
+        fp_copy(acc, c[i]);
+    }
+
+    fp_invmod(acc, curve->q, acc);
+
+    for (size_t i = n; i-- > 0;)
+    {
+        if (!valid[i])
+        {
+            continue;
+        }
+
+        if (i > 0)
+        {
+            fp_mulmod(acc, c[i - 1], curve->q, w);
+        }
+        else
+        {
+            fp_copy(acc, w);
+        }
+        fp_mulmod(acc, sigs[i]->s, curve->q, acc);
+
+        ecdsa_digest_int(e, msgs[i], msg_lens[i], true, curve);
+        valid[i] = ecdsa_v_inverse(sigs[i], e, w, Qs[i], keys[i], &tmp, curve, scratch);
+    }
+
+    m_del(fp_int *, c, n);
+    ec_scratch_done(curve, scratch);
+}
+
+/**
+ * Verifica a assinatura ECDSA compatível com Ethereum.
+ *
+ * @param sig_eth Assinatura Ethereum contendo r, s, v e chainId.
+ * @param msg     Mensagem assinada (hash Keccak-256).
+ * @param Q       Chave pública do signatário.
+ * @param curve   Curva elíptica utilizada.
+ * @return        True se a assinatura for válida, False caso contrário.
+ */
+static bool ecdsa_v_eth(ecdsa_signature_teth *sig_eth, unsigned char *msg, size_t msg_len, ecc_point_t *Q, ecc_curve_t *curve) {
+    // Cria uma assinatura padrão temporária
+    ecdsa_signature_t sig_standard;
+    sig_standard.r = sig_eth->r;
+    sig_standard.s = sig_eth->s;
+    return ecdsa_v(&sig_standard, msg, msg_len, false, Q, NULL, curve);
+}
+
+// P = (x, y) on the curve with y = parity (mod 2), x < p, false if there is no such point
+static bool ec_point_lift_x(ecc_point_t *P, fp_int *x, int parity, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t mark = ec_scratch_mark(scratch);
+    fp_int *t = ec_scratch_get(scratch);
+
+    // y^2 = x^3 + a * x + b
+    fp_copy(x, P->x);
+    fp_sqrmod(P->x, curve->p, t);
+    fp_add(t, curve->a, t);
+    fp_mulmod(t, P->x, curve->p, t);
+    fp_add(t, curve->b, t);
+    fp_mod(t, curve->p, t);
+
+    bool found = ec_field_sqrt(t, P->y, curve, scratch);
+    if (found && (int)(P->y->dp[0] & 1) != parity)
+    {
+        // y = 0 has no odd counterpart
+        found = !fp_iszero(P->y);
+        fp_sub(curve->p, P->y, P->y);
+    }
+
+    ec_scratch_release(scratch, mark);
+    return found;
+}
+
+// Q = r^-1 * (s * R - e * G), R the point of x = r whose y has the parity rec_id
+static bool ecdsa_recover_q(ecc_point_t *Q, ecdsa_signature_t *sig, int rec_id, unsigned char *msg, size_t msg_len, bool raw, ecc_curve_t *curve)
+{
+    if (!ecdsa_sig_in_range(sig, curve) || fp_cmp(sig->r, curve->p) != FP_LT)
+    {
+        return false;
+    }
+
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    fp_int *e = ec_scratch_get(scratch);
+    fp_int *rinv = ec_scratch_get(scratch);
+    fp_int *u1 = ec_scratch_get(scratch);
+    fp_int *u2 = ec_scratch_get(scratch);
+
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+
+    bool found = ec_point_lift_x(&R, sig->r, rec_id, curve, scratch);
+    if (found)
+    {
+        ecdsa_digest_int(e, msg, msg_len, raw, curve);
+
+        // u1 = -e * r^-1, u2 = s * r^-1 (mod q)
+        fp_invmod(sig->r, curve->q, rinv);
+        fp_mulmod(e, rinv, curve->q, u1);
+        if (!fp_iszero(u1))
+        {
+            fp_sub(curve->q, u1, u1);
+        }
+        fp_mulmod(sig->s, rinv, curve->q, u2);
+
+        ecc_point_t *points[2] = {curve->g, &R};
+        fp_int *scalars[2] = {u1, u2};
+        ec_point_multi_mul(Q, points, scalars, 2, curve, scratch);
+        found = !(fp_iszero(Q->x) && fp_iszero(Q->y));
+    }
+
+    ec_scratch_done(curve, scratch);
+    return found;
+}
+
+// bytes of a SEC1 encoding of P, 0x00 alone for the identity
+static size_t ec_point_encoded_size(ecc_point_t *P, ecc_curve_t *curve, bool compressed)
+{
+    if (fp_iszero(P->x) && fp_iszero(P->y))
+    {
+        return 1;
+    }
+    size_t plen = (fp_count_bits(curve->p) + 7) / 8;
+    return compressed ? 1 + plen : 1 + 2 * plen;
+}
+
+// 0x04 || x || y, or 0x02 / 0x03 (parity of y) || x, coordinates in the byte length of p
+static void ec_point_encode(ecc_point_t *P, ecc_curve_t *curve, bool compressed, unsigned char *buf)
+{
+    if (fp_iszero(P->x) && fp_iszero(P->y))
+    {
+        buf[0] = 0x00;
+        return;
+    }
+    size_t plen = (fp_count_bits(curve->p) + 7) / 8;
+    fp_to_unsigned_bin_len(P->x, buf + 1, plen);
+    if (compressed)
+    {
+        buf[0] = 0x02 | (P->y->dp[0] & 1);
+    }
+    else
+    {
+        buf[0] = 0x04;
+        fp_to_unsigned_bin_len(P->y, buf + 1 + plen, plen);
+    }
+}
+
+// inverse of ec_point_encode, false if buf is not a point of the curve
+static bool ec_point_decode(ecc_point_t *P, const unsigned char *buf, size_t len, ecc_curve_t *curve, ecc_scratch_t *scratch)
+{
+    size_t plen = (fp_count_bits(curve->p) + 7) / 8;
+    if (len == 1 && buf[0] == 0x00)
+    {
+        fp_zero(P->x);
+        fp_zero(P->y);
+        return true;
+    }
+
+    if (len == 1 + plen && (buf[0] == 0x02 || buf[0] == 0x03))
+    {
+        size_t mark = ec_scratch_mark(scratch);
+        fp_int *x = ec_scratch_get(scratch);
+        fp_read_unsigned_bin(x, (unsigned char *)buf + 1, plen);
+
+        bool found = fp_cmp(x, curve->p) == FP_LT && ec_point_lift_x(P, x, buf[0] & 1, curve, scratch);
+
+        ec_scratch_release(scratch, mark);
+        return found;
+    }
+
+    if (len == 1 + 2 * plen && buf[0] == 0x04)
+    {
+        fp_read_unsigned_bin(P->x, (unsigned char *)buf + 1, plen);
+        fp_read_unsigned_bin(P->y, (unsigned char *)buf + 1 + plen, plen);
+        return fp_cmp(P->x, curve->p) == FP_LT && fp_cmp(P->y, curve->p) == FP_LT && ec_point_in_curve(P, curve, scratch);
+    }
+
+    return false;
+}
+
+//////////////////////////////// Lazy points //////////////////////////////////
+
+/*
+    The operators of Point (+, -, * and unary -) leave their result in
+    jacobian coordinates, so a chain like a * P + b * Q - R pays a single
+    inversion, when the coordinates are read, compared or encoded.
+*/
+static void mp_point_affine(mp_point_t *point)
+{
+    if (point->jacobian != NULL)
+    {
+        ecc_scratch_t *scratch = ec_scratch_acquire(point->ecc_curve);
+        ecc_point_t P;
+        ec_scratch_point(&P, scratch);
+        ec_jacobian_to_affine(&P, point->jacobian, point->ecc_curve, scratch);
+        mp_point_store(point, &P);
+        ec_scratch_done(point->ecc_curve, scratch);
+
+        fp_free(point->jacobian->x);
+        fp_free(point->jacobian->y);
+        fp_free(point->jacobian->z);
+        m_del_obj(ecc_jacobian_point_t, point->jacobian);
+        point->jacobian = NULL;
+    }
+}
+
+// rop = the affine coordinates of point
+static void mp_point_load(ecc_point_t *rop, mp_point_t *point)
+{
+    mp_point_affine(point);
+    fp_compact_get(point->x, rop->x);
+    fp_compact_get(point->y, rop->y);
+}
+
+// working copy of the coordinates of point, freed with ec_point_view_done
+static void mp_point_view(ecc_point_t *P, mp_point_t *point)
+{
+    P->x = fp_alloc();
+    P->y = fp_alloc();
+    mp_point_load(P, point);
+}
+
+static void ec_point_view_done(ecc_point_t *P)
+{
+    fp_free(P->x);
+    fp_free(P->y);
+}
+
+static mp_point_t *new_point_jacobian(mp_point_t *like)
+{
+    mp_point_t *pr = new_point_shared(like->ecc_curve);
+    pr->jacobian = m_new_obj(ecc_jacobian_point_t);
+    pr->jacobian->x = fp_alloc();
+    pr->jacobian->y = fp_alloc();
+    pr->jacobian->z = fp_alloc();
+    return pr;
+}
+
+static void mp_point_to_jacobian(ecc_jacobian_point_t *rop, mp_point_t *point)
+{
+    if (point->jacobian != NULL)
+    {
+        ec_jacobian_copy(point->jacobian, rop);
+    }
+    else
+    {
+        // the coordinates enter the field representation in place
+        ecc_point_t P = {rop->x, rop->y};
+        fp_compact_get(point->x, P.x);
+        fp_compact_get(point->y, P.y);
+        ec_jacobian_from_affine(rop, &P, point->ecc_curve);
+    }
+}
+
+// -op % curve.p in the field representation
+static void ec_jacobian_negate(ecc_jacobian_point_t *op, ecc_curve_t *curve)
+{
+    if (!fp_iszero(op->z) && !fp_iszero(op->y))
+    {
+        fp_sub(curve->p, op->y, op->y);
+    }
+}
+
+// l + r, or l - r
+static mp_obj_t point_lazy_add(mp_point_t *l, mp_point_t *r, bool subtract)
+{
+    ecc_curve_t *curve = l->ecc_curve;
+    mp_point_t *pr = new_point_jacobian(l);
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_jacobian_point_t T;
+    ec_scratch_jacobian(&T, scratch);
+
+    mp_point_to_jacobian(pr->jacobian, l);
+    mp_point_to_jacobian(&T, r);
+    if (subtract)
+    {
+        ec_jacobian_negate(&T, curve);
+    }
+    ec_jacobian_add(pr->jacobian, pr->jacobian, &T, curve, scratch);
+
+    ec_scratch_release(scratch, mark);
+    ec_scratch_done(curve, scratch);
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+// scalar * p, wNAF or the comb table of the generator
+static mp_obj_t point_lazy_mul(mp_point_t *p, mp_obj_t scalar)
+{
+    ecc_curve_t *curve = p->ecc_curve;
+    fp_int *s_fp_int = fp_alloc();
+    mp_fp_for_int(scalar, s_fp_int);
+
+    mp_point_t *pr = new_point_jacobian(p);
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_point_t P;
+    ecc_point_t *p_point = &P;
+    ec_scratch_point(&P, scratch);
+    if (p->jacobian == NULL)
+    {
+        fp_compact_get(p->x, P.x);
+        fp_compact_get(p->y, P.y);
+    }
+    if (p->jacobian == NULL && ec_point_equal(&P, curve->g))
+    {
+        ec_point_mul_base_jacobian(pr->jacobian, s_fp_int, curve, scratch);
+    }
+    else
+    {
+        // a pending operand is normalized together with its multiples table
+        ec_point_multi_mul_jacobian(pr->jacobian, &p_point, &p->jacobian, &s_fp_int, 1, curve, scratch);
+    }
+    ec_scratch_release(scratch, mark);
+    ec_scratch_done(curve, scratch);
+
+    fp_free(s_fp_int);
+
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+// -p, stays affine when p is
+static mp_obj_t point_lazy_negate(mp_point_t *p)
+{
+    ecc_curve_t *curve = p->ecc_curve;
+    if (p->jacobian != NULL)
+    {
+        mp_point_t *pr = new_point_jacobian(p);
+        ec_jacobian_copy(p->jacobian, pr->jacobian);
+        ec_jacobian_negate(pr->jacobian, curve);
+        return MP_OBJ_FROM_PTR(pr);
+    }
+
+    mp_point_t *pr = new_point_shared(curve);
+    pr->x = p->x;
+    // -point.y % curve.p
+    fp_int *y = fp_alloc();
+    fp_compact_get(p->y, y);
+    fp_neg(y, y);
+    fp_mod(y, curve->p, y);
+    pr->y = fp_compact_new(y);
+    fp_free(y);
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static mp_obj_t point_equal(mp_obj_t point1, mp_obj_t point2)
+{
+    if (!MP_OBJ_IS_TYPE(point1, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point1));
+    }
+    if (!MP_OBJ_IS_TYPE(point2, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 2, mp_obj_get_type_str(point2));
+    }
+
+    mp_point_t *p1 = MP_OBJ_TO_PTR(point1);
+    mp_point_t *p2 = MP_OBJ_TO_PTR(point2);
+    mp_point_affine(p1);
+    mp_point_affine(p2);
+    return mp_obj_new_bool(fp_compact_equal(p1->x, p2->x) && fp_compact_equal(p1->y, p2->y));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(point_equal_obj, point_equal);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_equal_obj, MP_ROM_PTR(&point_equal_obj));
+
+static mp_obj_t point_double(mp_obj_t point, mp_obj_t curve)
+{
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(point, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve));
+    }
+
+    mp_point_t *p = MP_OBJ_TO_PTR(point);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    ecc_point_t P;
+    mp_point_view(&P, p);
+    mp_point_t *pr = new_point_shared(c->ecc_curve);
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+    ec_point_double(&R, &P, c->ecc_curve, scratch);
+    mp_point_store(pr, &R);
+    ec_scratch_done(c->ecc_curve, scratch);
+    ec_point_view_done(&P);
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(point_double_obj, point_double);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_double_obj, MP_ROM_PTR(&point_double_obj));
+
+static mp_obj_t point_add(mp_obj_t point1, mp_obj_t point2, mp_obj_t curve)
+{
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(point1, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point1));
+    }
+    if (!MP_OBJ_IS_TYPE(point2, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 2, mp_obj_get_type_str(point2));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+    }
+
+    mp_point_t *p1 = MP_OBJ_TO_PTR(point1);
+    mp_point_t *p2 = MP_OBJ_TO_PTR(point2);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    ecc_point_t P1, P2;
+    mp_point_view(&P1, p1);
+    mp_point_view(&P2, p2);
+    mp_point_t *pr = new_point_shared(c->ecc_curve);
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+    ec_point_add(&R, &P1, &P2, c->ecc_curve, scratch);
+    mp_point_store(pr, &R);
+    ec_scratch_done(c->ecc_curve, scratch);
+    ec_point_view_done(&P1);
+    ec_point_view_done(&P2);
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(point_add_obj, point_add);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_add_obj, MP_ROM_PTR(&point_add_obj));
+
+static mp_obj_t point_sub(mp_obj_t point1, mp_obj_t point2, mp_obj_t curve)
+{
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(point1, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point1));
+    }
+    if (!MP_OBJ_IS_TYPE(point2, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 2, mp_obj_get_type_str(point2));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+    }
+
+    mp_point_t *p1 = MP_OBJ_TO_PTR(point1);
+    mp_point_t *p2 = MP_OBJ_TO_PTR(point2);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    ecc_point_t P1, P2;
+    mp_point_view(&P1, p1);
+    mp_point_view(&P2, p2);
+
+    // -point2.y % curve.p, on the working copy
+    fp_neg(P2.y, P2.y);
+    fp_mod(P2.y, c->ecc_curve->p, P2.y);
+
+    mp_point_t *pr = new_point_shared(c->ecc_curve);
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+    ec_point_add(&R, &P1, &P2, c->ecc_curve, scratch);
+    mp_point_store(pr, &R);
+    ec_scratch_done(c->ecc_curve, scratch);
+
+    ec_point_view_done(&P1);
+    ec_point_view_done(&P2);
+
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(point_sub_obj, point_sub);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_sub_obj, MP_ROM_PTR(&point_sub_obj));
+
+static mp_obj_t point_mul_helper(mp_obj_t point, mp_obj_t scalar, mp_obj_t curve, bool ct)
+{
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(point, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
+    }
+    if (!MP_OBJ_IS_INT(scalar))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 2, mp_obj_get_type_str(scalar));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+    }
+
+    mp_point_t *p = MP_OBJ_TO_PTR(point);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    fp_int *s_fp_int = fp_alloc();
+
+    mp_fp_for_int(scalar, s_fp_int);
+
+    ecc_point_t P;
+    mp_point_view(&P, p);
+    mp_point_t *pr = new_point_shared(c->ecc_curve);
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    ecc_point_t R;
+    ec_scratch_point(&R, scratch);
+    if (ct)
+    {
+        // the ladder does one add and one double per bit whatever the scalar is
+        ec_point_mul(&R, &P, s_fp_int, c->ecc_curve, scratch);
+    }
+    else if (ec_point_equal(&P, c->ecc_curve->g))
+    {
+        ec_point_mul_base(&R, s_fp_int, c->ecc_curve, scratch);
+    }
+    else
+    {
+        ec_point_mul_wnaf(&R, &P, s_fp_int, c->ecc_curve, scratch);
+    }
+    mp_point_store(pr, &R);
+    ec_scratch_done(c->ecc_curve, scratch);
+
+    ec_point_view_done(&P);
+    fp_free(s_fp_int);
+
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static mp_obj_t point_mul(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_point, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_scalar, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_curve, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_ct, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+    };
+
+    struct
+    {
+        mp_arg_val_t point, scalar, curve, ct;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    return point_mul_helper(args.point.u_obj, args.scalar.u_obj, args.curve.u_obj, args.ct.u_bool);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(point_mul_obj, 3, point_mul);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_mul_obj, MP_ROM_PTR(&point_mul_obj));
+
+static void job_point_mul_step(mp_job_t *job, mp_int_t n)
+{
+    UCRYPTO_STATS_API(POINT);
+    mp_curve_t *c = MP_OBJ_TO_PTR(job->curve);
+    ecc_jacobian_point_t R0 = {job->r[0], job->r[1], job->r[2]};
+    ecc_jacobian_point_t R1 = {job->r[3], job->r[4], job->r[5]};
+
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    for (; n > 0 && job->bit >= 0; n--, job->bit--)
+    {
+        ec_ladder_bit(&R0, &R1, ec_scalar_bit(job->k, job->bit), c->ecc_curve, scratch);
+    }
+
+    if (job->bit < 0)
+    {
+        mp_point_t *pr = new_point_shared(c->ecc_curve);
+        size_t mark = ec_scratch_mark(scratch);
+        ecc_point_t R;
+        ec_scratch_point(&R, scratch);
+        ec_jacobian_to_affine(&R, &R0, c->ecc_curve, scratch);
+        mp_point_store(pr, &R);
+        ec_scratch_release(scratch, mark);
+        job->result = MP_OBJ_FROM_PTR(pr);
+        job_release(job);
+    }
+    ec_scratch_done(c->ecc_curve, scratch);
+}
+
+static mp_obj_t point_mul_start(mp_obj_t point, mp_obj_t scalar, mp_obj_t curve)
+{
+    /*
+        returns a Job for scalar * point, the ladder of point_mul(..., ct=True) one bit per iteration, whose result is the Point
+    */
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(point, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
+    }
+    if (!MP_OBJ_IS_INT(scalar))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 2, mp_obj_get_type_str(scalar));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+    }
+
+    mp_point_t *p = MP_OBJ_TO_PTR(point);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    mp_job_t *job = new_job(job_point_mul_step, 6);
+    job->curve = curve;
+
+    fp_int *s_fp_int = fp_alloc();
+    mp_fp_for_int(scalar, s_fp_int);
+
+    ecc_point_t P;
+    mp_point_view(&P, p);
+    if ((fp_cmp_d(P.x, 0) == FP_EQ && fp_cmp_d(P.y, 0) == FP_EQ) || fp_iszero(s_fp_int))
+    {
+        // the identity element
+        mp_point_t *pr = new_point_shared(c->ecc_curve);
+        fp_zero(P.x);
+        fp_zero(P.y);
+        mp_point_store(pr, &P);
+        job->result = MP_OBJ_FROM_PTR(pr);
+        job_release(job);
+    }
+    else
+    {
+        ecc_jacobian_point_t R0 = {job->r[0], job->r[1], job->r[2]};
+        ecc_jacobian_point_t R1 = {job->r[3], job->r[4], job->r[5]};
+
+        ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+        job->bit = ec_ladder_start(&R0, &R1, job->k, &P, s_fp_int, c->ecc_curve, scratch);
+        ec_scratch_done(c->ecc_curve, scratch);
+    }
+
+    ec_point_view_done(&P);
+    fp_free(s_fp_int);
+
+    return MP_OBJ_FROM_PTR(job);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(point_mul_start_obj, point_mul_start);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_mul_start_obj, MP_ROM_PTR(&point_mul_start_obj));
+
+static mp_obj_t multi_mul(mp_obj_t terms, mp_obj_t curve)
+{
+    /*
+        terms (list/tuple): (Point, int) pairs, returns the Point sum(k * P)
+    */
+    UCRYPTO_STATS_API(POINT);
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve));
+    }
+
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(terms, &n, &items);
+
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    ecc_point_t **points = m_new(ecc_point_t *, n);
+    ecc_jacobian_point_t **jpoints = m_new(ecc_jacobian_point_t *, n);
+    fp_int **scalars = m_new(fp_int *, n);
+    // working copies of the affine terms
+    ecc_point_t *affine = m_new(ecc_point_t, n);
+    fp_int *coords = m_new(fp_int, 2 * n);
+    for (size_t i = 0; i < n; i++)
+    {
+        mp_obj_t *pair;
+        if (!MP_OBJ_IS_TYPE(items[i], &mp_type_tuple) && !MP_OBJ_IS_TYPE(items[i], &mp_type_list))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_TERM_AT_BUT, i, mp_obj_get_type_str(items[i]));
+        }
+        mp_obj_get_array_fixed_n(items[i], 2, &pair);
+        if (!MP_OBJ_IS_TYPE(pair[0], &point_type) || !MP_OBJ_IS_INT(pair[1]))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_TERM_AT_BUT, i, mp_obj_get_type_str(items[i]));
+        }
+        // pending terms are normalized along with the tables
+        mp_point_t *term = MP_OBJ_TO_PTR(pair[0]);
+        affine[i].x = &coords[2 * i];
+        affine[i].y = &coords[2 * i + 1];
+        if (term->jacobian == NULL)
+        {
+            fp_compact_get(term->x, affine[i].x);
+            fp_compact_get(term->y, affine[i].y);
+        }
+        points[i] = &affine[i];
+        jpoints[i] = term->jacobian;
+        scalars[i] = fp_alloc();
+        mp_fp_for_int(pair[1], scalars[i]);
+    }
+
+    mp_point_t *pr = new_point_shared(c->ecc_curve);
+    ecc_scratch_t *scratch = ec_scratch_acquire(c->ecc_curve);
+    size_t mark = ec_scratch_mark(scratch);
+    ecc_jacobian_point_t R;
+    ecc_point_t A;
+    ec_scratch_jacobian(&R, scratch);
+    ec_scratch_point(&A, scratch);
+    ec_point_multi_mul_jacobian(&R, points, jpoints, scalars, n, c->ecc_curve, scratch);
+    ec_jacobian_to_affine(&A, &R, c->ecc_curve, scratch);
+    mp_point_store(pr, &A);
+    ec_scratch_release(scratch, mark);
+    ec_scratch_done(c->ecc_curve, scratch);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fp_free(scalars[i]);
+    }
+    m_del(fp_int, coords, 2 * n);
+    m_del(ecc_point_t, affine, n);
+    m_del(fp_int *, scalars, n);
+    m_del(ecc_jacobian_point_t *, jpoints, n);
+    m_del(ecc_point_t *, points, n);
+
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(multi_mul_obj, multi_mul);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_multi_mul_obj, MP_ROM_PTR(&multi_mul_obj));
+
+// SEC1 encoding into a new Point, NULL if it is not a point of curve
+static mp_point_t *new_point_decoded(ecc_curve_t *curve, const byte *buf, size_t len)
+{
+    mp_point_t *pr = new_point_shared(curve);
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    ecc_point_t P;
+    ec_scratch_point(&P, scratch);
+    bool valid = ec_point_decode(&P, buf, len, curve, scratch);
+    if (valid)
+    {
+        mp_point_store(pr, &P);
+    }
+    ec_scratch_done(curve, scratch);
+    return valid ? pr : NULL;
+}
+
+static mp_obj_t point_from_bytes(mp_obj_t data, mp_obj_t curve)
+{
+    /*
+        data (buffer): SEC1 encoding, uncompressed 0x04 || x || y or compressed 0x02 / 0x03 || x
+    */
+    UCRYPTO_STATS_API(POINT);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(curve));
+    }
+
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+    mp_point_t *pr = new_point_decoded(c->ecc_curve, bufinfo.buf, bufinfo.len);
+    if (pr == NULL)
+    {
+        mp_raise_ValueError(ERROR_INVALID_POINT_ENCODING);
+    }
+
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(point_from_bytes_obj, point_from_bytes);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_from_bytes_obj, MP_ROM_PTR(&point_from_bytes_obj));
+
+// id-ecPublicKey, 1.2.840.10045.2.1
+static const byte der_ec_public_key_oid[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01};
+
+// AlgorithmIdentifier ::= SEQUENCE { id-ecPublicKey, namedCurve OID }, NULL for other keys and curves
+static const ecc_named_curve_t *der_read_ec_algorithm(der_t *der)
+{
+    der_t alg, oid;
+    if (!der_expect(der, DER_SEQUENCE, &alg) || !der_expect(&alg, DER_OID, &oid) ||
+        (size_t)(oid.end - oid.p) != sizeof(der_ec_public_key_oid) || memcmp(oid.p, der_ec_public_key_oid, sizeof(der_ec_public_key_oid)) != 0 ||
+        !der_expect(&alg, DER_OID, &oid) || alg.p != alg.end)
+    {
+        return NULL;
+    }
+    return ec_named_curve_find_oid(oid.p, oid.end - oid.p);
+}
+
+// the SEC1 point of a BIT STRING with no unused bits, NULL for the identity or a point not on curve
+static mp_point_t *der_read_ec_point(der_t *bits, ecc_curve_t *curve)
+{
+    if (bits->end - bits->p < 3 || bits->p[0] != 0)
+    {
+        return NULL;
+    }
+    return new_point_decoded(curve, bits->p + 1, bits->end - bits->p - 1);
+}
+
+static mp_obj_t public_key_from_der(mp_obj_t data)
+{
+    /*
+        data (buffer): DER of a SubjectPublicKeyInfo ::= SEQUENCE { AlgorithmIdentifier, subjectPublicKey BIT STRING },
+            read in place, the Point returned is on the named curve of the key
+    */
+    UCRYPTO_STATS_API(POINT);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+
+    der_t der = {bufinfo.buf, (const byte *)bufinfo.buf + bufinfo.len};
+    der_t spki, bits;
+    if (!der_expect(&der, DER_SEQUENCE, &spki) || der.p != der.end)
+    {
+        mp_raise_ValueError(ERROR_INVALID_DER);
+    }
+    const ecc_named_curve_t *nc = der_read_ec_algorithm(&spki);
+    if (nc == NULL)
+    {
+        mp_raise_ValueError(ERROR_DER_NOT_EC_KEY);
+    }
+    if (!der_expect(&spki, DER_BIT_STRING, &bits) || spki.p != spki.end)
+    {
+        mp_raise_ValueError(ERROR_INVALID_DER);
+    }
+
+    mp_point_t *pr = der_read_ec_point(&bits, ec_named_curve_get(nc));
+    if (pr == NULL)
+    {
+        mp_raise_ValueError(ERROR_INVALID_POINT_ENCODING);
+    }
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(public_key_from_der_obj, public_key_from_der);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_public_key_from_der_obj, MP_ROM_PTR(&public_key_from_der_obj));
+
+static mp_obj_t private_key_from_der(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    /*
+        data (buffer): DER of an ECPrivateKey (RFC 5915) or of a PrivateKeyInfo (RFC 5208) holding one, read in place
+        curve (Curve): for a key that names no curve, else checked against the one it names
+        returns (d, Q, curve), Q is None when the key has no public key
+    */
+    UCRYPTO_STATS_API(POINT);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_data, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_curve, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
+
+    struct
+    {
+        mp_arg_val_t data, curve;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    if (args.curve.u_obj != mp_const_none && !MP_OBJ_IS_TYPE(args.curve.u_obj, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(args.curve.u_obj));
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args.data.u_obj, &bufinfo, MP_BUFFER_READ);
+
+    // the structure first, the numbers once it is known to be well formed
+    der_t der = {bufinfo.buf, (const byte *)bufinfo.buf + bufinfo.len};
+    der_t seq, version, key, params, oid, bits;
+    const ecc_named_curve_t *nc = NULL;
+    bool has_nc = false, has_pub = false;
+    if (!der_expect(&der, DER_SEQUENCE, &seq) || der.p != der.end || !der_expect(&seq, DER_INTEGER, &version) || version.end - version.p != 1)
+    {
+        mp_raise_ValueError(ERROR_INVALID_DER);
+    }
+    if (version.p[0] == 0)
+    {
+        // PrivateKeyInfo, the attributes after the key are ignored
+        nc = der_read_ec_algorithm(&seq);
+        if (nc == NULL)
+        {
+            mp_raise_ValueError(ERROR_DER_NOT_EC_KEY);
+        }
+        has_nc = true;
+        der_t inner;
+        if (!der_expect(&seq, DER_OCTET_STRING, &inner) || !der_expect(&inner, DER_SEQUENCE, &seq) || inner.p != inner.end ||
+            !der_expect(&seq, DER_INTEGER, &version) || version.end - version.p != 1)
+        {
+            mp_raise_ValueError(ERROR_INVALID_DER);
+        }
+    }
+    if (version.p[0] != 1 || !der_expect(&seq, DER_OCTET_STRING, &key) || key.p == key.end || (size_t)(key.end - key.p) > FP_MAX_SIZE / 16)
+    {
+        mp_raise_ValueError(ERROR_INVALID_DER);
+    }
+    if (der_optional(&seq, DER_CONTEXT(0), &params))
+    {
+        if (!der_expect(&params, DER_OID, &oid) || params.p != params.end)
+        {
+            mp_raise_ValueError(ERROR_INVALID_DER);
+        }
+        const ecc_named_curve_t *named = ec_named_curve_find_oid(oid.p, oid.end - oid.p);
+        if (named == NULL || (has_nc && named != nc))
+        {
+            mp_raise_ValueError(ERROR_DER_NOT_EC_KEY);
+        }
+        nc = named;
+        has_nc = true;
+    }
+    if (der_optional(&seq, DER_CONTEXT(1), &params))
+    {
+        if (!der_expect(&params, DER_BIT_STRING, &bits) || params.p != params.end)
+        {
+            mp_raise_ValueError(ERROR_INVALID_DER);
+        }
+        has_pub = true;
+    }
+    if (seq.p != seq.end)
+    {
+        mp_raise_ValueError(ERROR_INVALID_DER);
+    }
+
+    mp_curve_t *c;
+    if (args.curve.u_obj != mp_const_none)
+    {
+        c = MP_OBJ_TO_PTR(args.curve.u_obj);
+        if (has_nc)
+        {
+            ecc_curve_t *named = ec_named_curve_get(nc);
+            if (named != c->ecc_curve && !ec_curve_equal(named, c->ecc_curve))
+            {
+                mp_raise_ValueError(ERROR_DER_CURVE);
+            }
+        }
+    }
+    else if (has_nc)
+    {
+        c = new_named_curve(nc);
+    }
+    else
+    {
+        mp_raise_ValueError(ERROR_DER_NO_CURVE);
+    }
+
+    fp_int *d = fp_alloc();
+    fp_read_unsigned_bin(d, (unsigned char *)key.p, key.end - key.p);
+    bool in_range = !fp_iszero(d) && fp_cmp(d, c->ecc_curve->q) == FP_LT;
+    mp_obj_t d_obj = in_range ? mp_obj_new_int_from_fp(d) : mp_const_none;
+    fp_free(d);
+    if (!in_range)
+    {
+        mp_raise_ValueError(ERROR_ECDH_PRIVATE_KEY);
+    }
+
+    mp_obj_t Q = mp_const_none;
+    if (has_pub)
+    {
+        mp_point_t *pr = der_read_ec_point(&bits, c->ecc_curve);
+        if (pr == NULL)
+        {
+            mp_raise_ValueError(ERROR_INVALID_POINT_ENCODING);
+        }
+        Q = MP_OBJ_FROM_PTR(pr);
+    }
+
+    mp_obj_t items[3] = {d_obj, Q, MP_OBJ_FROM_PTR(c)};
+    return mp_obj_new_tuple(3, items);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(private_key_from_der_obj, 1, private_key_from_der);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_private_key_from_der_obj, MP_ROM_PTR(&private_key_from_der_obj));
+
+static mp_obj_t ecdh(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    /*
+        d (int): private key, 0 < d < q
+        peer (buffer): SEC1 encoding of the peer public key, uncompressed or compressed
+        curve (Curve): curve of both keys
+        out (bytearray/memoryview): written in place, returns the number of bytes written
+        returns the x-coordinate of d * peer in the byte length of p
+    */
+    UCRYPTO_STATS_API(POINT);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_d, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_peer, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_curve, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_out, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
+
+    struct
+    {
+        mp_arg_val_t d, peer, curve, out;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    if (!MP_OBJ_IS_INT(args.d.u_obj))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 1, mp_obj_get_type_str(args.d.u_obj));
+    }
+    mp_buffer_info_t peer;
+    mp_get_buffer_raise(args.peer.u_obj, &peer, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_TYPE(args.curve.u_obj, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(args.curve.u_obj));
+    }
+
+    ecc_curve_t *curve = ((mp_curve_t *)MP_OBJ_TO_PTR(args.curve.u_obj))->ecc_curve;
+    size_t plen = (fp_count_bits(curve->p) + 7) / 8;
+    // the result is the only heap block, allocated before the scratch is taken, and none with out
+    vstr_t vstr;
+    mp_buffer_info_t out;
+    if (args.out.u_obj != mp_const_none)
+    {
+        mp_get_buffer_raise(args.out.u_obj, &out, MP_BUFFER_WRITE);
+        if (out.len < plen)
+        {
+            mp_raise_msg_varg(&mp_type_ValueError, ERROR_BUFFER_TOO_SMALL, (unsigned)plen, (unsigned)out.len);
+        }
+    }
+    else
+    {
+        vstr_init_len(&vstr, plen);
+    }
+
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    fp_int *d = ec_scratch_get(scratch);
+    ecc_point_t Q, R;
+    ec_scratch_point(&Q, scratch);
+    ec_scratch_point(&R, scratch);
+
+    mp_fp_for_int(args.d.u_obj, d);
+    if (fp_cmp_d(d, 0) != FP_GT || fp_cmp(d, curve->q) != FP_LT)
+    {
+        ec_scratch_done(curve, scratch);
+        mp_raise_ValueError(ERROR_ECDH_PRIVATE_KEY);
+    }
+    // the identity decodes as a point but has no shared secret, neither has a peer of small order
+    bool valid = ec_point_decode(&Q, peer.buf, peer.len, curve, scratch) && !(fp_iszero(Q.x) && fp_iszero(Q.y));
+    if (valid)
+    {
+        // d is secret, the ladder (or the hardware backend) takes the same time for any d
+        ec_point_mul(&R, &Q, d, curve, scratch);
+        valid = !(fp_iszero(R.x) && fp_iszero(R.y));
+    }
+    if (!valid)
+    {
+        ec_scratch_done(curve, scratch);
+        mp_raise_ValueError(ERROR_ECDH_PEER);
+    }
+
+    if (args.out.u_obj != mp_const_none)
+    {
+        // out again, another thread may have resized it while the ladder ran without the GIL
+        mp_get_buffer_raise(args.out.u_obj, &out, MP_BUFFER_WRITE);
+        valid = out.len >= plen;
+        if (valid)
+        {
+            fp_to_unsigned_bin_len(R.x, out.buf, plen);
+        }
+    }
+    else
+    {
+        fp_to_unsigned_bin_len(R.x, (unsigned char *)vstr.buf, plen);
+    }
+    fp_zero(d);
+    fp_zero(R.x);
+    ec_scratch_done(curve, scratch);
+
+    if (args.out.u_obj == mp_const_none)
+    {
+        return mp_obj_new_bytes_from_vstr(&vstr);
+    }
+    if (!valid)
+    {
+        mp_raise_msg_varg(&mp_type_ValueError, ERROR_BUFFER_TOO_SMALL, (unsigned)plen, (unsigned)out.len);
+    }
+    return mp_obj_new_int(plen);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(ecdh_obj, 3, ecdh);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdh_obj, MP_ROM_PTR(&ecdh_obj));
+
+static mp_obj_t signature(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_r, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_s, MP_ARG_OBJ, {.u_obj = mp_const_none}}};
+
+    struct
+    {
+        mp_arg_val_t r, s;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    mp_ecdsa_signature_t *signature = m_new_obj(mp_ecdsa_signature_t);
+    signature->base.type = &signature_type;
+    for (size_t i = 0; i < n_args; i++)
+    {
+        if (!MP_OBJ_IS_INT(pos_args[i]))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(pos_args[i]), i);
+        }
+    }
+
+    signature->r = fp_compact_for_int(args.r.u_obj);
+    signature->s = fp_compact_for_int(args.s.u_obj);
+
+    return MP_OBJ_FROM_PTR(signature);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(signature_obj, 2, signature);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_signature_obj, MP_ROM_PTR(&signature_obj));
+
+/**
+ * Cria um novo objeto SignatureETH.
+ *
+ * @param r       Coordenada r da assinatura.
+ * @param s       Coordenada s da assinatura.
+ * @param v       Parâmetro de recuperação.
+ * @param chainId Identificador da cadeia Ethereum.
+ * @return        Objeto SignatureETH.
+ */
+static mp_obj_t signature_eth_new(fp_int *r, fp_int *s, int v, int chainId) {
+    mp_ecdsa_signature_eth_t *sig_eth = m_new_obj(mp_ecdsa_signature_eth_t);
+    sig_eth->base.type = &signature_eth_type;
+    sig_eth->r = fp_compact_new(r);
+    sig_eth->s = fp_compact_new(s);
+    sig_eth->v = v;
+    sig_eth->chainId = chainId;
+    return MP_OBJ_FROM_PTR(sig_eth);
+}
+
+
+static mp_obj_t ecdsa_sign_helper(const mp_obj_t *args, bool raw)
+{
+    UCRYPTO_STATS_API(SIGN);
+    mp_obj_t msg = args[0];
+    mp_obj_t d = args[1];
+    mp_obj_t k = args[2];
+    mp_obj_t curve = args[3];
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_INT(d))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 2, mp_obj_get_type_str(d));
+    }
+    if (k != mp_const_none && !MP_OBJ_IS_INT(k))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 3, mp_obj_get_type_str(k));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 4, mp_obj_get_type_str(curve));
+    }
+
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+    if (k == mp_const_none && (size_t)fp_count_bits(c->ecc_curve->q) > ECDSA_RFC6979_MAX_BYTES * 8)
+    {
+        mp_raise_ValueError(ERROR_CURVE_ORDER_TOO_LARGE);
+    }
+
+    fp_int *d_fp_int = fp_alloc();
+    fp_int *k_fp_int = NULL;
+
+    mp_fp_for_int(d, d_fp_int);
+    if (k != mp_const_none)
+    {
+        k_fp_int = fp_alloc();
+        mp_fp_for_int(k, k_fp_int);
+    }
+
+    mp_ecdsa_signature_t *sr = m_new_obj(mp_ecdsa_signature_t);
+    sr->base.type = &signature_type;
+
+    ecdsa_signature_t sig = {fp_alloc(), fp_alloc()};
+    ecdsa_s(&sig, bufinfo.buf, bufinfo.len, raw, d_fp_int, k_fp_int, c->ecc_curve);
+    sr->r = fp_compact_new(sig.r);
+    sr->s = fp_compact_new(sig.s);
+    ec_signature_view_done(&sig);
+
+    fp_free(d_fp_int);
+    if (k_fp_int != NULL)
+    {
+        fp_free(k_fp_int);
+    }
+
+    return MP_OBJ_FROM_PTR(sr);
+}
+
+static mp_obj_t ecdsa_sign(size_t n_args, const mp_obj_t *args)
+{
+    /*
+        msg (bytes): hex digest of the message
+        k (int/None): nonce, None takes the deterministic nonce of RFC 6979 (HMAC-SHA-256)
+    */
+    (void)n_args;
+    return ecdsa_sign_helper(args, false);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_sign_obj, 4, 4, ecdsa_sign);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_sign_obj, MP_ROM_PTR(&ecdsa_sign_obj));
+
+static mp_obj_t ecdsa_sign_digest(size_t n_args, const mp_obj_t *args)
+{
+    /*
+        digest (buffer): raw digest of the message, read in place
+        k (int/None): nonce, None takes the deterministic nonce of RFC 6979 (HMAC-SHA-256)
+    */
+    (void)n_args;
+    return ecdsa_sign_helper(args, true);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_sign_digest_obj, 4, 4, ecdsa_sign_digest);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_sign_digest_obj, MP_ROM_PTR(&ecdsa_sign_digest_obj));
+
+/**
+ * Assina uma mensagem usando ECDSA compatível com Ethereum.
+ *
+ * @param n_args Número de argumentos.
+ * @param args    Vetor de argumentos: msg, d, k, curve, chainId.
+ * @return        Objeto SignatureETH contendo r, s e v.
+ */
+static mp_obj_t ecdsa_sign_eth(size_t n_args, const mp_obj_t *args) {
+    // Argumentos esperados: msg, d, k, curve, chainId
+    UCRYPTO_STATS_API(SIGN);
+    if (n_args < 5) {
+        mp_raise_TypeError(MP_ERROR_TEXT("ecdsa_sign_eth requires 5 arguments: msg, d, k, curve, chainId"));
+    }
+
+    mp_obj_t msg = args[0];
+    mp_obj_t d = args[1];
+    mp_obj_t k = args[2];
+    mp_obj_t curve = args[3];
+    mp_obj_t chainId_obj = args[4];
+
+    // Obter o buffer da mensagem (já deve ser o hash Keccak-256)
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
+
+    // Validação dos tipos
+    if (!MP_OBJ_IS_INT(d)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'd' to be an int, got %s"), mp_obj_get_type_str(d));
+    }
+    if (!MP_OBJ_IS_INT(k)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'k' to be an int, got %s"), mp_obj_get_type_str(k));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'curve' to be of type Curve, got %s"), mp_obj_get_type_str(curve));
+    }
+    if (!MP_OBJ_IS_INT(chainId_obj)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'chainId' to be an int, got %s"), mp_obj_get_type_str(chainId_obj));
+    }
+
+    int chainId = mp_obj_get_int(chainId_obj);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    // Converter a chave privada para fp_int
+    fp_int *d_fp_int = fp_alloc();
+    mp_fp_for_int(d, d_fp_int);
+
+    // Converter k para fp_int
+    fp_int *k_fp_int = fp_alloc();
+    mp_fp_for_int(k, k_fp_int);
+
+    // Alocar a assinatura e o ponto R
+    ecdsa_signature_t *sig = m_new_obj(ecdsa_signature_t);
+    sig->r = fp_alloc();
+    sig->s = fp_alloc();
+
+    ecc_point_t *R = m_new_obj(ecc_point_t);
+    R->x = fp_alloc();
+    R->y = fp_alloc();
+
+    // Realizar a assinatura
+    ecdsa_s_eth(sig, bufinfo.buf, bufinfo.len, d_fp_int, k_fp_int, c->ecc_curve, R);
+
+    // Normalizar s
+    fp_int *half_n = fp_alloc();
+    fp_div_2(c->ecc_curve->q, half_n);
+    int s_gt_half_n = fp_cmp(sig->s, half_n) == FP_GT;
+    if (s_gt_half_n) {
+        fp_sub(c->ecc_curve->q, sig->s, sig->s);
+        // n - s corresponde a -R, inverte a paridade de y(R)
+        fp_sub(c->ecc_curve->p, R->y, R->y);
+    }
+    fp_free(half_n);
+
+    // Calcular o parâmetro v
+    int v = calculate_recovery_id(R, c->ecc_curve, chainId);
+    if (v == -1) {
+        // Liberar memória antes de levantar exceção
+        fp_free(d_fp_int);
+        fp_free(k_fp_int);
+        fp_free(sig->r);
+        fp_free(sig->s);
+        fp_free(R->x);
+        fp_free(R->y);
+        m_del_obj(ecc_point_t, R);
+        m_del_obj(ecdsa_signature_t, sig);
+        mp_raise_ValueError(MP_ERROR_TEXT("Failed to calculate recovery id"));
+    }
+
+    // Criar e retornar o objeto SignatureETH
+    mp_obj_t signature_eth = signature_eth_new(sig->r, sig->s, v, chainId);
+
+    // Liberar memória
+    fp_free(d_fp_int);
+    fp_free(k_fp_int);
+    fp_free(sig->r);
+    fp_free(sig->s);
+    m_del_obj(ecdsa_signature_t, sig);
+    fp_free(R->x);
+    fp_free(R->y);
+    m_del_obj(ecc_point_t, R);
+
+    return signature_eth;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_sign_eth_obj, 5, 5, ecdsa_sign_eth);
+//static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_sign_eth_obj, MP_ROM_PTR(&ecdsa_sign_eth_obj));
+
+
+
+static void public_key_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_public_key_t *self = MP_OBJ_TO_PTR(self_in);
+    vstr_t *x = vstr_new_from_compact(self->x);
+    vstr_t *y = vstr_new_from_compact(self->y);
+    mp_printf(print, "<PublicKey x=%s y=%s curve=%s window=%d>", vstr_str(x), vstr_str(y), vstr_str(&self->ecc_curve->name), self->wnaf->w);
+    vstr_free(x);
+    vstr_free(y);
+}
+
+static void public_key_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
+{
+    mp_public_key_t *self = MP_OBJ_TO_PTR(obj);
+    if (dest[0] != MP_OBJ_NULL)
+    {
+        // read only, the table is computed from Q
+        return;
+    }
+    if (attr == MP_QSTR_Q)
+    {
+        mp_point_t *point = new_point_shared(self->ecc_curve);
+        point->x = self->x;
+        point->y = self->y;
+        dest[0] = MP_OBJ_FROM_PTR(point);
+    }
+    else if (attr == MP_QSTR_curve)
+    {
+        mp_curve_t *c = m_new_obj(mp_curve_t);
+        c->base.type = &curve_type;
+        c->ecc_curve = self->ecc_curve;
+        dest[0] = MP_OBJ_FROM_PTR(c);
+    }
+    else if (attr == MP_QSTR_window)
+    {
+        dest[0] = mp_obj_new_int(self->wnaf->w);
+    }
+}
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    public_key_type,
+    MP_QSTR_PublicKey,
+    MP_TYPE_FLAG_NONE,
+    print, public_key_print,
+    attr, public_key_attr);
+
+static mp_obj_t prepare_public_key(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    /*
+        Q (Point): public key, checked once to be a point of the curve
+        curve (Curve): curve of the verifications
+        window (int): wNAF width 2..8, the table takes 2^(window-2) points;
+            None picks one wider than the default of a scalar as large as curve.q
+    */
+    UCRYPTO_STATS_API(POINT);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_Q, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_curve, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_window, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
+
+    struct
+    {
+        mp_arg_val_t Q, curve, window;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    if (!MP_OBJ_IS_TYPE(args.Q.u_obj, &point_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(args.Q.u_obj));
+    }
+    if (!MP_OBJ_IS_TYPE(args.curve.u_obj, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 2, mp_obj_get_type_str(args.curve.u_obj));
+    }
+
+    mp_point_t *point = MP_OBJ_TO_PTR(args.Q.u_obj);
+    mp_curve_t *c = MP_OBJ_TO_PTR(args.curve.u_obj);
+    ecc_curve_t *curve = c->ecc_curve;
+
+    int w;
+    if (args.window.u_obj == mp_const_none)
+    {
+        w = ec_wnaf_width(fp_count_bits(curve->q)) + 1;
+    }
+    else
+    {
+        w = mp_obj_get_int(args.window.u_obj);
+        if (w < EC_WNAF_KEY_WINDOW_MIN || w > EC_WNAF_KEY_WINDOW_MAX)
+        {
+            mp_raise_msg_varg(&mp_type_ValueError, ERROR_PUBLIC_KEY_WINDOW, EC_WNAF_KEY_WINDOW_MIN, EC_WNAF_KEY_WINDOW_MAX);
+        }
+    }
+
+    ecc_point_t Q;
+    mp_point_view(&Q, point);
+    ecc_scratch_t *scratch = ec_scratch_acquire(curve);
+    bool valid = !(fp_iszero(Q.x) && fp_iszero(Q.y)) && fp_cmp(Q.x, curve->p) == FP_LT && fp_cmp(Q.y, curve->p) == FP_LT && ec_point_in_curve(&Q, curve, scratch);
+    ecc_wnaf_key_t *wnaf = NULL;
+    if (valid)
+    {
+        wnaf = ec_wnaf_key_build(&Q, w, curve, scratch);
+    }
+    ec_scratch_done(curve, scratch);
+    ec_point_view_done(&Q);
+    if (!valid)
+    {
+        mp_raise_ValueError(ERROR_PUBLIC_KEY_INVALID);
+    }
+
+    mp_public_key_t *key = m_new_obj(mp_public_key_t);
+    key->base.type = &public_key_type;
+    key->x = point->x;
+    key->y = point->y;
+    key->ecc_curve = curve;
+    key->wnaf = wnaf;
+    return MP_OBJ_FROM_PTR(key);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(prepare_public_key_obj, 2, prepare_public_key);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_prepare_public_key_obj, MP_ROM_PTR(&prepare_public_key_obj));
+
+// the table of a prepared public key for a verification on curve, NULL for a Point
+static ecc_wnaf_key_t *ec_verify_key(mp_obj_t Q, ecc_curve_t *curve, size_t index)
+{
+    if (MP_OBJ_IS_TYPE(Q, &point_type))
+    {
+        return NULL;
+    }
+    if (!MP_OBJ_IS_TYPE(Q, &public_key_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_PUBLIC_KEY_AT_BUT, index, mp_obj_get_type_str(Q));
+    }
+    mp_public_key_t *key = MP_OBJ_TO_PTR(Q);
+    if (key->ecc_curve != curve && !ec_curve_equal(key->ecc_curve, curve))
+    {
+        mp_raise_ValueError(ERROR_PUBLIC_KEY_CURVE);
+    }
+    return key->wnaf;
+}
+
+static mp_obj_t ecdsa_verify_helper(const mp_obj_t *args, bool raw)
+{
+    UCRYPTO_STATS_API(VERIFY);
+    mp_obj_t signature = args[0];
+    mp_obj_t msg = args[1];
+    mp_obj_t Q = args[2];
+    mp_obj_t curve = args[3];
+
+    if (!MP_OBJ_IS_TYPE(signature, &signature_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_SIGNATURE_AT_BUT, 1, mp_obj_get_type_str(signature));
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 4, mp_obj_get_type_str(curve));
+    }
+
+    mp_ecdsa_signature_t *s = MP_OBJ_TO_PTR(signature);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+    ecc_wnaf_key_t *key = ec_verify_key(Q, c->ecc_curve, 3);
+
+    ecdsa_signature_t sig;
+    ec_signature_view(&sig, s->r, s->s);
+    bool valid;
+    if (key != NULL)
+    {
+        valid = ecdsa_v(&sig, bufinfo.buf, bufinfo.len, raw, NULL, key, c->ecc_curve);
+    }
+    else
+    {
+        ecc_point_t Qp;
+        mp_point_view(&Qp, MP_OBJ_TO_PTR(Q));
+        valid = ecdsa_v(&sig, bufinfo.buf, bufinfo.len, raw, &Qp, NULL, c->ecc_curve);
+        ec_point_view_done(&Qp);
+    }
+    ec_signature_view_done(&sig);
+    return mp_obj_new_bool(valid);
+}
+
+static mp_obj_t ecdsa_verify(size_t n_args, const mp_obj_t *args)
+{
+    /*
+        msg (bytes): hex digest of the message
+    */
+    (void)n_args;
+    return ecdsa_verify_helper(args, false);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_verify_obj, 4, 4, ecdsa_verify);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_verify_obj, MP_ROM_PTR(&ecdsa_verify_obj));
+
+static mp_obj_t ecdsa_verify_digest(size_t n_args, const mp_obj_t *args)
+{
+    /*
+        digest (buffer): raw digest of the message, read in place
+    */
+    (void)n_args;
+    return ecdsa_verify_helper(args, true);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_verify_digest_obj, 4, 4, ecdsa_verify_digest);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_verify_digest_obj, MP_ROM_PTR(&ecdsa_verify_digest_obj));
+
+static mp_obj_t ecdsa_verify_batch(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    /*
+        sigs (list/tuple): Signature's
+        digests (list/tuple): raw digests of the messages, read in place
+        pubkeys (list/tuple): Point's or PublicKey's, public key of each signature
+        all (bool): return a single bool, True if every signature is valid
+    */
+    UCRYPTO_STATS_API(VERIFY);
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_sigs, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_digests, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_pubkeys, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_curve, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_all, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+    };
+
+    struct
+    {
+        mp_arg_val_t sigs, digests, pubkeys, curve, all;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    if (!MP_OBJ_IS_TYPE(args.curve.u_obj, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 4, mp_obj_get_type_str(args.curve.u_obj));
+    }
+    mp_curve_t *c = MP_OBJ_TO_PTR(args.curve.u_obj);
+
+    size_t n, n_digests, n_pubkeys;
+    mp_obj_t *sig_items, *digest_items, *pubkey_items;
+    mp_obj_get_array(args.sigs.u_obj, &n, &sig_items);
+    mp_obj_get_array(args.digests.u_obj, &n_digests, &digest_items);
+    mp_obj_get_array(args.pubkeys.u_obj, &n_pubkeys, &pubkey_items);
+    if (n_digests != n || n_pubkeys != n)
+    {
+        mp_raise_ValueError(ERROR_BATCH_LENGTHS);
+    }
+
+    ecdsa_signature_t **sigs = m_new(ecdsa_signature_t *, n);
+    unsigned char **msgs = m_new(unsigned char *, n);
+    size_t *msg_lens = m_new(size_t, n);
+    ecc_point_t **Qs = m_new(ecc_point_t *, n);
+    ecc_wnaf_key_t **keys = m_new(ecc_wnaf_key_t *, n);
+    bool *valid = m_new(bool, n);
+    // working copies of r, s and the public key of each signature
+    ecdsa_signature_t *sig_views = m_new(ecdsa_signature_t, n);
+    ecc_point_t *Q_views = m_new(ecc_point_t, n);
+    fp_int *coords = m_new(fp_int, 4 * n);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!MP_OBJ_IS_TYPE(sig_items[i], &signature_type))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_SIGNATURE_AT_BUT, i, mp_obj_get_type_str(sig_items[i]));
+        }
+        keys[i] = ec_verify_key(pubkey_items[i], c->ecc_curve, i);
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(digest_items[i], &bufinfo, MP_BUFFER_READ);
+
+        mp_ecdsa_signature_t *sig = MP_OBJ_TO_PTR(sig_items[i]);
+        sig_views[i].r = &coords[4 * i];
+        sig_views[i].s = &coords[4 * i + 1];
+        fp_compact_get(sig->r, sig_views[i].r);
+        fp_compact_get(sig->s, sig_views[i].s);
+        Q_views[i].x = &coords[4 * i + 2];
+        Q_views[i].y = &coords[4 * i + 3];
+        Qs[i] = NULL;
+        if (keys[i] == NULL)
+        {
+            mp_point_load(&Q_views[i], MP_OBJ_TO_PTR(pubkey_items[i]));
+            Qs[i] = &Q_views[i];
+        }
+
+        sigs[i] = &sig_views[i];
+        msgs[i] = bufinfo.buf;
+        msg_lens[i] = bufinfo.len;
+    }
+
+    ecdsa_v_batch(sigs, msgs, msg_lens, Qs, keys, n, c->ecc_curve, valid);
+
+    mp_obj_t result;
+    if (args.all.u_bool)
+    {
+        bool all_valid = true;
+        for (size_t i = 0; i < n; i++)
+        {
+            all_valid = all_valid && valid[i];
+        }
+        result = mp_obj_new_bool(all_valid);
+    }
+    else
+    {
+        result = mp_obj_new_list(n, NULL);
+        mp_obj_list_t *list = MP_OBJ_TO_PTR(result);
+        for (size_t i = 0; i < n; i++)
+        {
+            list->items[i] = mp_obj_new_bool(valid[i]);
+        }
+    }
+
+    m_del(fp_int, coords, 4 * n);
+    m_del(ecc_point_t, Q_views, n);
+    m_del(ecdsa_signature_t, sig_views, n);
+    m_del(bool, valid, n);
+    m_del(ecc_wnaf_key_t *, keys, n);
+    m_del(ecc_point_t *, Qs, n);
+    m_del(size_t, msg_lens, n);
+    m_del(unsigned char *, msgs, n);
+    m_del(ecdsa_signature_t *, sigs, n);
+
+    return result;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(ecdsa_verify_batch_obj, 4, ecdsa_verify_batch);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_verify_batch_obj, MP_ROM_PTR(&ecdsa_verify_batch_obj));
+
+/**
+ * Verifica uma assinatura Ethereum ECDSA.
+ *
+ * @param n_args Número de argumentos.
+ * @param args    Vetor de argumentos: signature_eth, msg, Q, curve.
+ * @return        True se a assinatura for válida, False caso contrário.
+ */
+static mp_obj_t ecdsa_verify_eth(size_t n_args, const mp_obj_t *args) {
+    // Argumentos esperados: signature_eth, msg, Q, curve
+    UCRYPTO_STATS_API(VERIFY);
+    if (n_args < 4) {
+        mp_raise_TypeError(MP_ERROR_TEXT("ecdsa_verify_eth requires 4 arguments: signature_eth, msg, Q, curve"));
+    }
+
+    mp_obj_t signature_eth = args[0];
+    mp_obj_t msg = args[1];
+    mp_obj_t Q = args[2];
+    mp_obj_t curve = args[3];
+
+    // Validação dos tipos
+    if (!MP_OBJ_IS_TYPE(signature_eth, &signature_eth_type)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'signature_eth' to be of type SignatureETH, got %s"), mp_obj_get_type_str(signature_eth));
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_TYPE(Q, &point_type)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'Q' to be of type Point, got %s"), mp_obj_get_type_str(Q));
+    }
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'curve' to be of type Curve, got %s"), mp_obj_get_type_str(curve));
+    }
+
+    mp_ecdsa_signature_eth_t *s_eth = MP_OBJ_TO_PTR(signature_eth);
+    mp_point_t *q = MP_OBJ_TO_PTR(Q);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    ecdsa_signature_teth sig_eth = {fp_alloc(), fp_alloc(), s_eth->v, s_eth->chainId};
+    fp_compact_get(s_eth->r, sig_eth.r);
+    fp_compact_get(s_eth->s, sig_eth.s);
+    ecc_point_t Qp;
+    mp_point_view(&Qp, q);
+
+    bool is_valid = ecdsa_v_eth(&sig_eth, bufinfo.buf, bufinfo.len, &Qp, c->ecc_curve);
+
+    ec_point_view_done(&Qp);
+    fp_free(sig_eth.r);
+    fp_free(sig_eth.s);
+
+    return mp_obj_new_bool(is_valid);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_verify_eth_obj, 4, 4, ecdsa_verify_eth);
+
+static mp_obj_t ecdsa_recover(mp_obj_t signature_eth, mp_obj_t msg, mp_obj_t curve)
+{
+    /*
+        signature_eth (SignatureETH): signature made by ecdsa_sign_eth
+        msg (bytes): hex digest of the message, as given to ecdsa_sign_eth
+        returns the Point of the public key of the signer
+    */
+    UCRYPTO_STATS_API(RECOVER);
+    if (!MP_OBJ_IS_TYPE(signature_eth, &signature_eth_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_SIGNATURE_AT_BUT, 1, mp_obj_get_type_str(signature_eth));
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
+    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+    }
+
+    mp_ecdsa_signature_eth_t *sig_eth = MP_OBJ_TO_PTR(signature_eth);
+    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+
+    // v = 27 + rec_id before EIP-155, v = 35 + rec_id + 2 * chainId since
+    int rec_id = sig_eth->v - 35 - 2 * sig_eth->chainId;
+    if (sig_eth->v == 27 || sig_eth->v == 28)
+    {
+        rec_id = sig_eth->v - 27;
+    }
+    if (rec_id != 0 && rec_id != 1)
+    {
+        mp_raise_msg_varg(&mp_type_ValueError, ERROR_RECOVERY_ID, sig_eth->v);
+    }
+
+    ecdsa_signature_t sig;
+    ec_signature_view(&sig, sig_eth->r, sig_eth->s);
+
+    ecc_point_t Q = {fp_alloc(), fp_alloc()};
+    bool recovered = ecdsa_recover_q(&Q, &sig, rec_id, bufinfo.buf, bufinfo.len, false, c->ecc_curve);
+    ec_signature_view_done(&sig);
+    if (!recovered)
+    {
+        ec_point_view_done(&Q);
+        mp_raise_ValueError(ERROR_RECOVER_FAILED);
+    }
+
+    mp_point_t *pr = new_point_shared(c->ecc_curve);
+    mp_point_store(pr, &Q);
+    ec_point_view_done(&Q);
+    return MP_OBJ_FROM_PTR(pr);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(ecdsa_recover_obj, ecdsa_recover);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_recover_obj, MP_ROM_PTR(&ecdsa_recover_obj));
 
-    fp_copy(p2->ecc_point->y, p2_y_fp_int);
 
-    fp_neg(p2->ecc_point->y, p2->ecc_point->y);
-    fp_mod(p2->ecc_point->y, c->ecc_curve->p, p2->ecc_point->y);
 
-    mp_point_t *pr = new_point_init_copy(c);
-    ec_point_add(pr->ecc_point, p1->ecc_point, p2->ecc_point, c->ecc_curve);
+static void point_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_point_t *self = MP_OBJ_TO_PTR(self_in);
+    vstr_t vstr_oid;
+    vstr_hexlify(&vstr_oid, (const byte *)vstr_str(&self->ecc_curve->oid), vstr_len(&self->ecc_curve->oid));
+    mp_point_affine(self);
+    vstr_t *ecc_point_x = vstr_new_from_compact(self->x);
+    vstr_t *ecc_point_y = vstr_new_from_compact(self->y);
+    vstr_t *ecc_curve_p = vstr_new_from_fp(self->ecc_curve->p);
+    vstr_t *ecc_curve_a = vstr_new_from_fp(self->ecc_curve->a);
+    vstr_t *ecc_curve_b = vstr_new_from_fp(self->ecc_curve->b);
+    vstr_t *ecc_curve_q = vstr_new_from_fp(self->ecc_curve->q);
+    vstr_t *ecc_curve_g_x = vstr_new_from_fp(self->ecc_curve->g->x);
+    vstr_t *ecc_curve_g_y = vstr_new_from_fp(self->ecc_curve->g->y);
+    mp_printf(print, "<Point x=%s y=%s curve=<Curve name=%s oid=%s p=%s a=%s b=%s q=%s gx=%s gy=%s>>", vstr_str(ecc_point_x), vstr_str(ecc_point_y), vstr_str(&self->ecc_curve->name), vstr_str(&vstr_oid), vstr_str(ecc_curve_p), vstr_str(ecc_curve_a), vstr_str(ecc_curve_b), vstr_str(ecc_curve_q), vstr_str(ecc_curve_g_x), vstr_str(ecc_curve_g_y));
+    vstr_free(ecc_point_x);
+    vstr_free(ecc_point_y);
+    vstr_free(ecc_curve_p);
+    vstr_free(ecc_curve_a);
+    vstr_free(ecc_curve_b);
+    vstr_free(ecc_curve_q);
+    vstr_free(ecc_curve_g_x);
+    vstr_free(ecc_curve_g_y);
+}
 
-    // restore point.y
-    fp_copy(p2_y_fp_int, p2->ecc_point->y);
+static void point_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
+{
+    mp_point_t *self = MP_OBJ_TO_PTR(obj);
+    if (dest[0] == MP_OBJ_NULL)
+    {
+        const mp_obj_type_t *type = mp_obj_get_type(obj);
+        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
+        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL)
+        {
+            if (attr == MP_QSTR_x)
+            {
+                mp_point_affine(self);
+                dest[0] = mp_obj_new_int_from_compact(self->x);
+                return;
+            }
+            else if (attr == MP_QSTR_y)
+            {
+                mp_point_affine(self);
+                dest[0] = mp_obj_new_int_from_compact(self->y);
+                return;
+            }
+            else if (attr == MP_QSTR_curve)
+            {
+                dest[0] = new_curve_init_copy(self);
+                return;
+            }
+            mp_convert_member_lookup(obj, type, elem->value, dest);
+        }
+    }
+    else
+    {
+        if ((attr == MP_QSTR_x || attr == MP_QSTR_y) && !MP_OBJ_IS_INT(dest[1]))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT, mp_obj_get_type_str(dest[1]));
+        }
+        else if (attr == MP_QSTR_curve && !MP_OBJ_IS_TYPE(dest[1], &curve_type))
+        {
+            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_BUT, mp_obj_get_type_str(dest[1]));
+        }
 
-    fp_free(p2_y_fp_int);
+        // the pending coordinates belong to the old curve
+        mp_point_affine(self);
 
-    return MP_OBJ_FROM_PTR(pr);
+        if (attr == MP_QSTR_x)
+        {
+            self->x = fp_compact_for_int(dest[1]);
+        }
+        else if (attr == MP_QSTR_y)
+        {
+            self->y = fp_compact_for_int(dest[1]);
+        }
+        else if (attr == MP_QSTR_curve)
+        {
+            mp_curve_t *other = MP_OBJ_TO_PTR(dest[1]);
+            self->ecc_curve = other->ecc_curve;
+        }
+        else
+        {
+            return;
+        }
+        dest[0] = MP_OBJ_NULL; // indicate success
+    }
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_3(point_sub_obj, point_sub);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_sub_obj, MP_ROM_PTR(&point_sub_obj));
-
-static mp_obj_t point_mul(mp_obj_t point, mp_obj_t scalar, mp_obj_t curve)
+static mp_obj_t point_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs)
 {
-    if (!MP_OBJ_IS_TYPE(point, &point_type))
+    UCRYPTO_STATS_API(POINT);
+    switch (op)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 1, mp_obj_get_type_str(point));
+    case MP_BINARY_OP_ADD:
+    case MP_BINARY_OP_SUBTRACT:
+    {
+        if (!MP_OBJ_IS_TYPE(lhs, &point_type) || !MP_OBJ_IS_TYPE(rhs, &point_type))
+        {
+            mp_raise_TypeError(ERROR_EXPECTED_POINTS);
+        }
+        mp_point_t *l = MP_OBJ_TO_PTR(lhs);
+        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
+        if (!ec_curve_equal(l->ecc_curve, r->ecc_curve))
+        {
+            mp_raise_ValueError(ERROR_CURVE_OF_POINTS_NOT_EQUAL);
+        }
+        return point_lazy_add(l, r, op == MP_BINARY_OP_SUBTRACT);
     }
-    if (!MP_OBJ_IS_INT(scalar))
+    case MP_BINARY_OP_MULTIPLY:
+#if defined(MICROPY_PY_ALL_SPECIAL_METHODS) && defined(MICROPY_PY_REVERSE_SPECIAL_METHODS)
+    case MP_BINARY_OP_REVERSE_MULTIPLY:
+#endif
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 2, mp_obj_get_type_str(scalar));
+        if (!MP_OBJ_IS_TYPE(lhs, &point_type))
+        {
+            mp_raise_TypeError(ERROR_LEFT_EXPECTED_POINT);
+        }
+        if (!MP_OBJ_IS_INT(rhs))
+        {
+            mp_raise_TypeError(ERROR_RIGHT_EXPECTED_INT);
+        }
+        return point_lazy_mul(MP_OBJ_TO_PTR(lhs), rhs);
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    case MP_BINARY_OP_EQUAL:
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 3, mp_obj_get_type_str(curve));
+        if (!MP_OBJ_IS_TYPE(lhs, &point_type) || !MP_OBJ_IS_TYPE(rhs, &point_type))
+        {
+            mp_raise_TypeError(ERROR_EXPECTED_POINTS);
+        }
+        mp_point_t *l = MP_OBJ_TO_PTR(lhs);
+        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
+        if (!ec_curve_equal(l->ecc_curve, r->ecc_curve))
+        {
+            mp_raise_ValueError(ERROR_CURVE_OF_POINTS_NOT_EQUAL);
+        }
+        return point_equal(MP_OBJ_FROM_PTR(l), MP_OBJ_FROM_PTR(r));
+    }
+    default:
+        return MP_OBJ_NULL; // op not supported
     }
-
-    mp_point_t *p = MP_OBJ_TO_PTR(point);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
-
-    fp_int *s_fp_int = fp_alloc();
-
-    mp_fp_for_int(scalar, s_fp_int);
-
-    mp_point_t *pr = new_point_init_copy(c);
-    ec_point_mul(pr->ecc_point, p->ecc_point, *s_fp_int, c->ecc_curve);
-
-    fp_free(s_fp_int);
-
-    return MP_OBJ_FROM_PTR(pr);
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_3(point_mul_obj, point_mul);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_mul_obj, MP_ROM_PTR(&point_mul_obj));
+static mp_obj_t point_unary_op(mp_unary_op_t op, mp_obj_t self_in)
+{
+    UCRYPTO_STATS_API(POINT);
+    mp_point_t *point = MP_OBJ_TO_PTR(self_in);
+    switch (op)
+    {
+    case MP_UNARY_OP_NEGATIVE:
+        return point_lazy_negate(point);
+    default:
+        return MP_OBJ_NULL; // op not supported
+    }
+}
 
-static mp_obj_t signature(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+static mp_obj_t point_to_bytes(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 {
+    /*
+        compressed (bool): SEC1 compressed form, 0x02 / 0x03 || x
+        out (bytearray/memoryview): written in place, returns the number of bytes written
+    */
+    UCRYPTO_STATS_API(POINT);
     static const mp_arg_t allowed_args[] = {
-        {MP_QSTR_r, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_s, MP_ARG_OBJ, {.u_obj = mp_const_none}}};
+        {MP_QSTR_compressed, MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_out, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
 
     struct
     {
-        mp_arg_val_t r, s;
+        mp_arg_val_t compressed, out;
     } args;
-    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
 
-    mp_ecdsa_signature_t *signature = m_new_obj(mp_ecdsa_signature_t);
-    signature->base.type = &signature_type;
-    for (size_t i = 0; i < n_args; i++)
+    mp_point_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    ecc_point_t P;
+    ecc_point_t *point = &P;
+    mp_point_view(point, self);
+    bool compressed = args.compressed.u_bool;
+    size_t len = ec_point_encoded_size(point, self->ecc_curve, compressed);
+
+    if (args.out.u_obj != mp_const_none)
     {
-        if (!MP_OBJ_IS_INT(pos_args[i]))
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(args.out.u_obj, &bufinfo, MP_BUFFER_WRITE);
+        if (bufinfo.len < len)
         {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(pos_args[i]), i);
+            ec_point_view_done(point);
+            mp_raise_msg_varg(&mp_type_ValueError, ERROR_BUFFER_TOO_SMALL, (unsigned)len, (unsigned)bufinfo.len);
         }
+        ec_point_encode(point, self->ecc_curve, compressed, bufinfo.buf);
+        ec_point_view_done(point);
+        return mp_obj_new_int(len);
     }
 
-    signature->ecdsa_signature = m_new_obj(ecdsa_signature_t);
-    signature->ecdsa_signature->r = fp_alloc();
-    signature->ecdsa_signature->s = fp_alloc();
-
-    mp_fp_for_int(args.r.u_obj, signature->ecdsa_signature->r);
-    mp_fp_for_int(args.s.u_obj, signature->ecdsa_signature->s);
-
-    return MP_OBJ_FROM_PTR(signature);
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    ec_point_encode(point, self->ecc_curve, compressed, (unsigned char *)vstr.buf);
+    ec_point_view_done(point);
+    return mp_obj_new_bytes_from_vstr(&vstr);
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_KW(signature_obj, 2, signature);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_signature_obj, MP_ROM_PTR(&signature_obj));
+static MP_DEFINE_CONST_FUN_OBJ_KW(point_to_bytes_obj, 1, point_to_bytes);
 
-/**
- * Cria um novo objeto SignatureETH.
- *
- * @param r       Coordenada r da assinatura.
- * @param s       Coordenada s da assinatura.
- * @param v       Parâmetro de recuperação.
- * @param chainId Identificador da cadeia Ethereum.
- * @return        Objeto SignatureETH.
- */
-static mp_obj_t signature_eth_new(fp_int *r, fp_int *s, int v, int chainId) {
-    mp_ecdsa_signature_eth_t *sig_eth = m_new_obj(mp_ecdsa_signature_eth_t);
-    sig_eth->base.type = &signature_eth_type;
-    sig_eth->ecdsa_signature_eth = m_new_obj(ecdsa_signature_teth);
-    sig_eth->ecdsa_signature_eth->r = r;
-    sig_eth->ecdsa_signature_eth->s = s;
-    sig_eth->ecdsa_signature_eth->v = v;
-    sig_eth->ecdsa_signature_eth->chainId = chainId;
-    return MP_OBJ_FROM_PTR(sig_eth);
-}
+static const mp_rom_map_elem_t point_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_x), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_y), MP_ROM_INT(0)},
+    {MP_ROM_QSTR(MP_QSTR_curve), MP_ROM_PTR(mp_const_none)},
+    {MP_ROM_QSTR(MP_QSTR_to_bytes), MP_ROM_PTR(&point_to_bytes_obj)},
+};
 
+static MP_DEFINE_CONST_DICT(point_locals_dict, point_locals_dict_table);
 
-static mp_obj_t ecdsa_sign(size_t n_args, const mp_obj_t *args)
+MP_DEFINE_CONST_OBJ_TYPE(
+    point_type,
+    MP_QSTR_Point,
+    MP_TYPE_FLAG_NONE,
+    print, point_print,
+    binary_op, point_binary_op,
+    unary_op, point_unary_op,
+    attr, point_attr,
+    locals_dict, &point_locals_dict);
+
+static mp_obj_t point(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 {
-    (void)n_args;
-    mp_obj_t msg = args[0];
-    mp_obj_t d = args[1];
-    mp_obj_t k = args[2];
-    mp_obj_t curve = args[3];
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_x, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_y, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+        {MP_QSTR_curve, MP_ARG_OBJ, {.u_obj = mp_const_none}},
+    };
 
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
-    if (!MP_OBJ_IS_INT(d))
+    struct
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 2, mp_obj_get_type_str(d));
+        mp_arg_val_t x, y, curve;
+    } args;
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
+
+    if (!MP_OBJ_IS_INT(args.x.u_obj))
+    {
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(args.x.u_obj), 1);
     }
-    if (!MP_OBJ_IS_INT(k))
+    if (!MP_OBJ_IS_INT(args.y.u_obj))
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, 3, mp_obj_get_type_str(k));
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(args.y.u_obj), 2);
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    if (!MP_OBJ_IS_TYPE(args.curve.u_obj, &curve_type))
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 4, mp_obj_get_type_str(curve));
+        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_BUT, mp_obj_get_type_str(args.curve.u_obj));
     }
 
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
-
-    fp_int *d_fp_int = fp_alloc();
-    fp_int *k_fp_int = fp_alloc();
-
-    mp_fp_for_int(d, d_fp_int);
-    mp_fp_for_int(k, k_fp_int);
-
-    mp_ecdsa_signature_t *sr = m_new_obj(mp_ecdsa_signature_t);
-    sr->base.type = &signature_type;
-
-    sr->ecdsa_signature = m_new_obj(ecdsa_signature_t);
-    sr->ecdsa_signature->r = fp_alloc();
-    sr->ecdsa_signature->s = fp_alloc();
-
-    ecdsa_s(sr->ecdsa_signature, bufinfo.buf, bufinfo.len, *d_fp_int, *k_fp_int, c->ecc_curve);
+    mp_curve_t *curve = MP_OBJ_TO_PTR(args.curve.u_obj);
+    mp_point_t *point = new_point_shared(curve->ecc_curve);
+    point->x = fp_compact_for_int(args.x.u_obj);
+    point->y = fp_compact_for_int(args.y.u_obj);
+    return MP_OBJ_FROM_PTR(point);
+}
 
-    fp_free(d_fp_int);
-    fp_free(k_fp_int);
+static MP_DEFINE_CONST_FUN_OBJ_KW(point_obj, 3, point);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_obj, MP_ROM_PTR(&point_obj));
 
-    return MP_OBJ_FROM_PTR(sr);
+static void ecc_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    (void)kind;
+    mp_printf(print, mp_obj_get_type_str(self_in));
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_sign_obj, 4, 4, ecdsa_sign);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_sign_obj, MP_ROM_PTR(&ecdsa_sign_obj));
+/* static void signature_eth_deinit(mp_obj_t self_in) {
+    mp_ecdsa_signature_eth_t *self = MP_OBJ_TO_PTR(self_in);
+    m_del_obj(mp_ecdsa_signature_eth_t, self);
+} */
 
-/**
- * Assina uma mensagem usando ECDSA compatível com Ethereum.
- *
- * @param n_args Número de argumentos.
- * @param args    Vetor de argumentos: msg, d, k, curve, chainId.
- * @return        Objeto SignatureETH contendo r, s e v.
- */
-static mp_obj_t ecdsa_sign_eth(size_t n_args, const mp_obj_t *args) {
-    // Argumentos esperados: msg, d, k, curve, chainId
-    if (n_args < 5) {
-        mp_raise_TypeError(MP_ERROR_TEXT("ecdsa_sign_eth requires 5 arguments: msg, d, k, curve, chainId"));
-    }
+static const mp_rom_map_elem_t ecc_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_Point), MP_ROM_PTR(&static_point_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_equal), MP_ROM_PTR(&static_point_equal_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_double), MP_ROM_PTR(&static_point_double_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_add), MP_ROM_PTR(&static_point_add_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_sub), MP_ROM_PTR(&static_point_sub_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_mul), MP_ROM_PTR(&static_point_mul_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_mul_start), MP_ROM_PTR(&static_point_mul_start_obj)},
+    {MP_ROM_QSTR(MP_QSTR_multi_mul), MP_ROM_PTR(&static_multi_mul_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_from_bytes), MP_ROM_PTR(&static_point_from_bytes_obj)},
+    {MP_ROM_QSTR(MP_QSTR_public_key_from_der), MP_ROM_PTR(&static_public_key_from_der_obj)},
+    {MP_ROM_QSTR(MP_QSTR_private_key_from_der), MP_ROM_PTR(&static_private_key_from_der_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdh), MP_ROM_PTR(&static_ecdh_obj)},
+    {MP_ROM_QSTR(MP_QSTR_Curve), MP_ROM_PTR(&static_curve_obj)},
+    {MP_ROM_QSTR(MP_QSTR_named_curve), MP_ROM_PTR(&static_named_curve_obj)},
+    {MP_ROM_QSTR(MP_QSTR_curve_equal), MP_ROM_PTR(&static_curve_equal_obj)},
+    {MP_ROM_QSTR(MP_QSTR_point_in_curve), MP_ROM_PTR(&static_point_in_curve_obj)},
+    {MP_ROM_QSTR(MP_QSTR_Signature), MP_ROM_PTR(&static_signature_obj)},
+    {MP_ROM_QSTR(MP_QSTR_signature_from_der), MP_ROM_PTR(&static_signature_from_der_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdsa_sign), MP_ROM_PTR(&static_ecdsa_sign_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdsa_verify), MP_ROM_PTR(&static_ecdsa_verify_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdsa_sign_digest), MP_ROM_PTR(&static_ecdsa_sign_digest_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdsa_verify_digest), MP_ROM_PTR(&static_ecdsa_verify_digest_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdsa_verify_batch), MP_ROM_PTR(&static_ecdsa_verify_batch_obj)},
+    {MP_ROM_QSTR(MP_QSTR_prepare_public_key), MP_ROM_PTR(&static_prepare_public_key_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ecdsa_recover), MP_ROM_PTR(&static_ecdsa_recover_obj)},
+};
 
-    mp_obj_t msg = args[0];
-    mp_obj_t d = args[1];
-    mp_obj_t k = args[2];
-    mp_obj_t curve = args[3];
-    mp_obj_t chainId_obj = args[4];
+static MP_DEFINE_CONST_DICT(ecc_locals_dict, ecc_locals_dict_table);
 
-    // Obter o buffer da mensagem (já deve ser o hash Keccak-256)
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
+MP_DEFINE_CONST_OBJ_TYPE(
+    ecc_type,
+    MP_QSTR_ECC,
+    MP_TYPE_FLAG_NONE,
+    print, ecc_print,
+    locals_dict, &ecc_locals_dict);
 
-    // Validação dos tipos
-    if (!MP_OBJ_IS_INT(d)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'd' to be an int, got %s"), mp_obj_get_type_str(d));
-    }
-    if (!MP_OBJ_IS_INT(k)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'k' to be an int, got %s"), mp_obj_get_type_str(k));
-    }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'curve' to be of type Curve, got %s"), mp_obj_get_type_str(curve));
-    }
-    if (!MP_OBJ_IS_INT(chainId_obj)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'chainId' to be an int, got %s"), mp_obj_get_type_str(chainId_obj));
-    }
+/////////////////////////////////// Curve25519 //////////////////////////////////
 
-    int chainId = mp_obj_get_int(chainId_obj);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+/*
+    X25519 (RFC 7748) and Ed25519 (RFC 8032) on their own field code: an
+    element of GF(2^255 - 19) is ten signed limbs of alternately 26 and 25
+    bits (radix 2^25.5), so that the products fit 32x32 -> 64 multiplies.
+    Limb i weighs 2^ceil(25.5 * i), the product of two odd limbs carries an
+    extra factor 2 and anything from 2^255 up folds back times 19. The
+    scalars mod l go through tomsfastmath, a handful of operations per
+    signature.
+*/
+typedef int32_t fe25519[10];
+
+// extended coordinates x = X / Z, y = Y / Z, x * y = T / Z
+typedef struct _ge25519_t
+{
+    fe25519 X;
+    fe25519 Y;
+    fe25519 Z;
+    fe25519 T;
+} ge25519_t;
+
+#define CURVE25519_SIZE 32
+
+// -121665 / 121666, sqrt(-1), the base point and the group order l, little-endian
+static const byte ed25519_d[CURVE25519_SIZE] = {
+    0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+    0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52,
+};
+static const byte ed25519_sqrtm1[CURVE25519_SIZE] = {
+    0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad, 0x06, 0x18, 0x43, 0x2f,
+    0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b, 0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b,
+};
+static const byte ed25519_bx[CURVE25519_SIZE] = {
+    0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+    0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21,
+};
+static const byte ed25519_by[CURVE25519_SIZE] = {
+    0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+};
+static const byte ed25519_l[CURVE25519_SIZE] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+};
 
-    // Converter a chave privada para fp_int
-    fp_int *d_fp_int = fp_alloc();
-    mp_fp_for_int(d, d_fp_int);
+/*
+    h = t with every limb back in [-2^25, 2^25) or [-2^24, 2^24), the carry
+    out of limb 9 folds into limb 0 times 19 and moves on once more
+*/
+static void fe25519_carry(fe25519 h, int64_t *t)
+{
+    for (int i = 0; i < 10; i++)
+    {
+        int s = 26 - (i & 1);
+        int64_t c = (t[i] + ((int64_t)1 << (s - 1))) >> s;
+        t[i] -= c * ((int64_t)1 << s);
+        if (i < 9)
+        {
+            t[i + 1] += c;
+        }
+        else
+        {
+            t[0] += 19 * c;
+        }
+    }
+    int64_t c = (t[0] + ((int64_t)1 << 25)) >> 26;
+    t[0] -= c * ((int64_t)1 << 26);
+    t[1] += c;
 
-    // Converter k para fp_int
-    fp_int *k_fp_int = fp_alloc();
-    mp_fp_for_int(k, k_fp_int);
+    for (int i = 0; i < 10; i++)
+    {
+        h[i] = (int32_t)t[i];
+    }
+}
 
-    // Alocar a assinatura e o ponto R
-    ecdsa_signature_t *sig = m_new_obj(ecdsa_signature_t);
-    sig->r = fp_alloc();
-    sig->s = fp_alloc();
+static void fe25519_set(fe25519 h, int32_t v)
+{
+    memset(h, 0, sizeof(fe25519));
+    h[0] = v;
+}
 
-    ecc_point_t *R = m_new_obj(ecc_point_t);
-    R->x = fp_alloc();
-    R->y = fp_alloc();
+static void fe25519_copy(fe25519 h, const fe25519 f)
+{
+    memcpy(h, f, sizeof(fe25519));
+}
 
-    // Realizar a assinatura
-    ecdsa_s_eth(sig, bufinfo.buf, bufinfo.len, *d_fp_int, *k_fp_int, c->ecc_curve, R);
+static void fe25519_add(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    int64_t t[10];
+    for (int i = 0; i < 10; i++)
+    {
+        t[i] = (int64_t)f[i] + g[i];
+    }
+    fe25519_carry(h, t);
+}
 
-    // Normalizar s
-    fp_int *half_n = fp_alloc();
-    fp_div_2(c->ecc_curve->q, half_n);
-    int s_gt_half_n = fp_cmp(sig->s, half_n) == FP_GT;
-    if (s_gt_half_n) {
-        fp_sub(c->ecc_curve->q, sig->s, sig->s);
+static void fe25519_sub(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    int64_t t[10];
+    for (int i = 0; i < 10; i++)
+    {
+        t[i] = (int64_t)f[i] - g[i];
     }
-    fp_free(half_n);
+    fe25519_carry(h, t);
+}
 
-    // Calcular o parâmetro v
-    int v = calculate_recovery_id(R, c->ecc_curve, chainId);
-    if (v == -1) {
-        // Liberar memória antes de levantar exceção
-        fp_free(d_fp_int);
-        fp_free(k_fp_int);
-        fp_free(sig->r);
-        fp_free(sig->s);
-        fp_free(R->x);
-        fp_free(R->y);
-        m_del_obj(ecc_point_t, R);
-        m_del_obj(ecdsa_signature_t, sig);
-        mp_raise_ValueError(MP_ERROR_TEXT("Failed to calculate recovery id"));
+static void fe25519_neg(fe25519 h, const fe25519 f)
+{
+    for (int i = 0; i < 10; i++)
+    {
+        h[i] = -f[i];
     }
+}
 
-    // Criar e retornar o objeto SignatureETH
-    mp_obj_t signature_eth = signature_eth_new(sig->r, sig->s, v, chainId);
+// h = f * g, the inputs are carried so 19 * g[j] and 2 * f[i] fit 32 bits
+static void fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    int32_t g19[10];
+    int64_t t[10] = {0};
+    for (int j = 0; j < 10; j++)
+    {
+        g19[j] = 19 * g[j];
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        int32_t fi = f[i];
+        int32_t fi2 = (i & 1) ? 2 * fi : fi;
+        for (int j = 0; j < 10 - i; j++)
+        {
+            t[i + j] += (int64_t)((j & 1) ? fi2 : fi) * g[j];
+        }
+        for (int j = 10 - i; j < 10; j++)
+        {
+            t[i + j - 10] += (int64_t)((j & 1) ? fi2 : fi) * g19[j];
+        }
+    }
+    fe25519_carry(h, t);
+}
 
-    // Liberar memória
-    fp_free(d_fp_int);
-    fp_free(k_fp_int);
-    fp_free(sig->r);
-    fp_free(sig->s);
-    m_del_obj(ecdsa_signature_t, sig);
-    fp_free(R->x);
-    fp_free(R->y);
-    m_del_obj(ecc_point_t, R);
+static void fe25519_sq(fe25519 h, const fe25519 f)
+{
+    fe25519_mul(h, f, f);
+}
 
-    return signature_eth;
+// h = f^(2^n), n >= 1
+static void fe25519_sqn(fe25519 h, const fe25519 f, int n)
+{
+    fe25519_sq(h, f);
+    while (--n > 0)
+    {
+        fe25519_sq(h, h);
+    }
 }
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_sign_eth_obj, 5, 5, ecdsa_sign_eth);
-//static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_sign_eth_obj, MP_ROM_PTR(&ecdsa_sign_eth_obj));
 
+static void fe25519_mul_small(fe25519 h, const fe25519 f, int32_t n)
+{
+    int64_t t[10];
+    for (int i = 0; i < 10; i++)
+    {
+        t[i] = (int64_t)f[i] * n;
+    }
+    fe25519_carry(h, t);
+}
 
+// the low 255 bits of 32 little-endian bytes
+static void fe25519_frombytes(fe25519 h, const byte *s)
+{
+    int64_t t[10];
+    int bit = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        int n = 26 - (i & 1);
+        uint64_t w = 0;
+        for (int k = 0; k < 5 && bit / 8 + k < CURVE25519_SIZE; k++)
+        {
+            w |= (uint64_t)s[bit / 8 + k] << (8 * k);
+        }
+        t[i] = (int64_t)((w >> (bit % 8)) & (((uint64_t)1 << n) - 1));
+        bit += n;
+    }
+    fe25519_carry(h, t);
+}
 
-static mp_obj_t ecdsa_verify(size_t n_args, const mp_obj_t *args)
+// the canonical encoding, f mod p in [0, p)
+static void fe25519_tobytes(byte *s, const fe25519 f)
 {
-    (void)n_args;
-    mp_obj_t signature = args[0];
-    mp_obj_t msg = args[1];
-    mp_obj_t Q = args[2];
-    mp_obj_t curve = args[3];
+    int32_t h[10];
+    memcpy(h, f, sizeof(h));
 
-    if (!MP_OBJ_IS_TYPE(signature, &signature_type))
+    // q = floor(f / p), then f - q * p = f + 19 * q - q * 2^255
+    int32_t q = (19 * h[9] + ((int32_t)1 << 24)) >> 25;
+    for (int i = 0; i < 10; i++)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_SIGNATURE_AT_BUT, 1, mp_obj_get_type_str(signature));
+        q = (h[i] + q) >> (26 - (i & 1));
     }
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
-    if (!MP_OBJ_IS_TYPE(Q, &point_type))
+    h[0] += 19 * q;
+    for (int i = 0; i < 9; i++)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_POINT_AT_BUT, 3, mp_obj_get_type_str(Q));
+        int n = 26 - (i & 1);
+        int32_t c = h[i] >> n;
+        h[i + 1] += c;
+        h[i] -= c * ((int32_t)1 << n);
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type))
+    h[9] &= ((int32_t)1 << 25) - 1;
+
+    uint64_t acc = 0;
+    int bits = 0;
+    int n = 0;
+    for (int i = 0; i < 10; i++)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_AT_BUT, 4, mp_obj_get_type_str(curve));
+        acc |= (uint64_t)(uint32_t)h[i] << bits;
+        bits += 26 - (i & 1);
+        while (bits >= 8)
+        {
+            s[n++] = (byte)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
     }
-
-    mp_ecdsa_signature_t *s = MP_OBJ_TO_PTR(signature);
-    mp_point_t *q = MP_OBJ_TO_PTR(Q);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
-    return mp_obj_new_bool(ecdsa_v(s->ecdsa_signature, bufinfo.buf, bufinfo.len, q->ecc_point, c->ecc_curve));
+    s[n] = (byte)acc;
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_verify_obj, 4, 4, ecdsa_verify);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_ecdsa_verify_obj, MP_ROM_PTR(&ecdsa_verify_obj));
-
-/**
- * Verifica uma assinatura Ethereum ECDSA.
- *
- * @param n_args Número de argumentos.
- * @param args    Vetor de argumentos: signature_eth, msg, Q, curve.
- * @return        True se a assinatura for válida, False caso contrário.
- */
-static mp_obj_t ecdsa_verify_eth(size_t n_args, const mp_obj_t *args) {
-    // Argumentos esperados: signature_eth, msg, Q, curve
-    if (n_args < 4) {
-        mp_raise_TypeError(MP_ERROR_TEXT("ecdsa_verify_eth requires 4 arguments: signature_eth, msg, Q, curve"));
+static bool fe25519_iszero(const fe25519 f)
+{
+    byte s[CURVE25519_SIZE];
+    byte r = 0;
+    fe25519_tobytes(s, f);
+    for (int i = 0; i < CURVE25519_SIZE; i++)
+    {
+        r |= s[i];
     }
+    return r == 0;
+}
 
-    mp_obj_t signature_eth = args[0];
-    mp_obj_t msg = args[1];
-    mp_obj_t Q = args[2];
-    mp_obj_t curve = args[3];
+static int fe25519_isnegative(const fe25519 f)
+{
+    byte s[CURVE25519_SIZE];
+    fe25519_tobytes(s, f);
+    return s[0] & 1;
+}
 
-    // Validação dos tipos
-    if (!MP_OBJ_IS_TYPE(signature_eth, &signature_eth_type)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'signature_eth' to be of type SignatureETH, got %s"), mp_obj_get_type_str(signature_eth));
+// f, g = g, f when b is 1, in constant time
+static void fe25519_cswap(fe25519 f, fe25519 g, int32_t b)
+{
+    int32_t mask = -b;
+    for (int i = 0; i < 10; i++)
+    {
+        int32_t x = mask & (f[i] ^ g[i]);
+        f[i] ^= x;
+        g[i] ^= x;
     }
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(msg, &bufinfo, MP_BUFFER_READ);
-    if (!MP_OBJ_IS_TYPE(Q, &point_type)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'Q' to be of type Point, got %s"), mp_obj_get_type_str(Q));
+}
+
+// f = g when b is 1, in constant time
+static void fe25519_cmov(fe25519 f, const fe25519 g, int32_t b)
+{
+    int32_t mask = -b;
+    for (int i = 0; i < 10; i++)
+    {
+        f[i] ^= mask & (f[i] ^ g[i]);
     }
-    if (!MP_OBJ_IS_TYPE(curve, &curve_type)) {
-        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("Expected 'curve' to be of type Curve, got %s"), mp_obj_get_type_str(curve));
+}
+
+// t1 = z^(2^250 - 1), t0 = z^11, the common chain of the inversion and the square root
+static void fe25519_pow2250(fe25519 t1, fe25519 t0, const fe25519 z)
+{
+    fe25519 t2, t3;
+    fe25519_sq(t0, z);
+    fe25519_sqn(t1, t0, 2);
+    fe25519_mul(t1, z, t1);
+    fe25519_mul(t0, t0, t1);
+    fe25519_sq(t2, t0);
+    fe25519_mul(t1, t1, t2);
+    fe25519_sqn(t2, t1, 5);
+    fe25519_mul(t1, t2, t1);
+    fe25519_sqn(t2, t1, 10);
+    fe25519_mul(t2, t2, t1);
+    fe25519_sqn(t3, t2, 20);
+    fe25519_mul(t2, t3, t2);
+    fe25519_sqn(t2, t2, 10);
+    fe25519_mul(t1, t2, t1);
+    fe25519_sqn(t2, t1, 50);
+    fe25519_mul(t2, t2, t1);
+    fe25519_sqn(t3, t2, 100);
+    fe25519_mul(t2, t3, t2);
+    fe25519_sqn(t2, t2, 50);
+    fe25519_mul(t1, t2, t1);
+}
+
+// h = z^(p - 2) = 1 / z
+static void fe25519_invert(fe25519 h, const fe25519 z)
+{
+    fe25519 t0, t1;
+    fe25519_pow2250(t1, t0, z);
+    fe25519_sqn(t1, t1, 5);
+    fe25519_mul(h, t1, t0);
+}
+
+// h = z^((p - 5) / 8)
+static void fe25519_pow22523(fe25519 h, const fe25519 z)
+{
+    fe25519 t0, t1;
+    fe25519_pow2250(t1, t0, z);
+    fe25519_sqn(t1, t1, 2);
+    fe25519_mul(h, t1, z);
+}
+
+// out = k * u, the x-only Montgomery ladder of RFC 7748 over the clamped scalar
+static void x25519_scalarmult(byte *out, const byte *scalar, const byte *u)
+{
+    byte k[CURVE25519_SIZE];
+    memcpy(k, scalar, sizeof(k));
+    k[0] &= 248;
+    k[31] &= 127;
+    k[31] |= 64;
+
+    fe25519 x1, x2, z2, x3, z3, a, aa, b, bb, e, c, d, da, cb;
+    fe25519_frombytes(x1, u);
+    fe25519_set(x2, 1);
+    fe25519_set(z2, 0);
+    fe25519_copy(x3, x1);
+    fe25519_set(z3, 1);
+
+    int32_t swap = 0;
+    for (int t = 254; t >= 0; t--)
+    {
+        int32_t bit = (k[t / 8] >> (t & 7)) & 1;
+        swap ^= bit;
+        fe25519_cswap(x2, x3, swap);
+        fe25519_cswap(z2, z3, swap);
+        swap = bit;
+
+        fe25519_add(a, x2, z2);
+        fe25519_sq(aa, a);
+        fe25519_sub(b, x2, z2);
+        fe25519_sq(bb, b);
+        fe25519_sub(e, aa, bb);
+        fe25519_add(c, x3, z3);
+        fe25519_sub(d, x3, z3);
+        fe25519_mul(da, d, a);
+        fe25519_mul(cb, c, b);
+        fe25519_add(x3, da, cb);
+        fe25519_sq(x3, x3);
+        fe25519_sub(z3, da, cb);
+        fe25519_sq(z3, z3);
+        fe25519_mul(z3, z3, x1);
+        fe25519_mul(x2, aa, bb);
+        // a24 = (486662 - 2) / 4
+        fe25519_mul_small(z2, e, 121665);
+        fe25519_add(z2, z2, aa);
+        fe25519_mul(z2, z2, e);
     }
+    fe25519_cswap(x2, x3, swap);
+    fe25519_cswap(z2, z3, swap);
 
-    mp_ecdsa_signature_eth_t *s_eth = MP_OBJ_TO_PTR(signature_eth);
-    mp_point_t *q = MP_OBJ_TO_PTR(Q);
-    mp_curve_t *c = MP_OBJ_TO_PTR(curve);
+    fe25519_invert(z2, z2);
+    fe25519_mul(x2, x2, z2);
+    fe25519_tobytes(out, x2);
+}
 
-    bool is_valid = ecdsa_v_eth(s_eth->ecdsa_signature_eth, bufinfo.buf, bufinfo.len, q->ecc_point, c->ecc_curve);
+static void ge25519_identity(ge25519_t *P)
+{
+    fe25519_set(P->X, 0);
+    fe25519_set(P->Y, 1);
+    fe25519_set(P->Z, 1);
+    fe25519_set(P->T, 0);
+}
 
-    return mp_obj_new_bool(is_valid);
+static void ge25519_base(ge25519_t *P)
+{
+    fe25519_frombytes(P->X, ed25519_bx);
+    fe25519_frombytes(P->Y, ed25519_by);
+    fe25519_set(P->Z, 1);
+    fe25519_mul(P->T, P->X, P->Y);
 }
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ecdsa_verify_eth_obj, 4, 4, ecdsa_verify_eth);
 
+// R = P + Q, complete for a = -1 and a non-square d (RFC 8032 5.1.4), R may be P or Q
+static void ge25519_add(ge25519_t *R, const ge25519_t *P, const ge25519_t *Q)
+{
+    fe25519 a, b, c, d, e, f, g, h, t;
+    fe25519_sub(a, P->Y, P->X);
+    fe25519_sub(t, Q->Y, Q->X);
+    fe25519_mul(a, a, t);
+    fe25519_add(b, P->Y, P->X);
+    fe25519_add(t, Q->Y, Q->X);
+    fe25519_mul(b, b, t);
+    fe25519_frombytes(t, ed25519_d);
+    fe25519_add(t, t, t);
+    fe25519_mul(c, P->T, t);
+    fe25519_mul(c, c, Q->T);
+    fe25519_mul(d, P->Z, Q->Z);
+    fe25519_add(d, d, d);
+    fe25519_sub(e, b, a);
+    fe25519_sub(f, d, c);
+    fe25519_add(g, d, c);
+    fe25519_add(h, b, a);
+    fe25519_mul(R->X, e, f);
+    fe25519_mul(R->Y, g, h);
+    fe25519_mul(R->T, e, h);
+    fe25519_mul(R->Z, f, g);
+}
 
+// R = 2 * P (RFC 8032 5.1.4)
+static void ge25519_double(ge25519_t *R, const ge25519_t *P)
+{
+    fe25519 a, b, c, e, f, g, h;
+    fe25519_sq(a, P->X);
+    fe25519_sq(b, P->Y);
+    fe25519_sq(c, P->Z);
+    fe25519_add(c, c, c);
+    fe25519_add(h, a, b);
+    fe25519_add(e, P->X, P->Y);
+    fe25519_sq(e, e);
+    fe25519_sub(e, h, e);
+    fe25519_sub(g, a, b);
+    fe25519_add(f, c, g);
+    fe25519_mul(R->X, e, f);
+    fe25519_mul(R->Y, g, h);
+    fe25519_mul(R->T, e, h);
+    fe25519_mul(R->Z, f, g);
+}
 
-static void point_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+static void ge25519_neg(ge25519_t *R, const ge25519_t *P)
 {
-    (void)kind;
-    mp_point_t *self = MP_OBJ_TO_PTR(self_in);
-    vstr_t vstr_oid;
-    vstr_hexlify(&vstr_oid, (const byte *)vstr_str(&self->ecc_curve->oid), vstr_len(&self->ecc_curve->oid));
-    vstr_t *ecc_point_x = vstr_new_from_fp(self->ecc_point->x);
-    vstr_t *ecc_point_y = vstr_new_from_fp(self->ecc_point->y);
-    vstr_t *ecc_curve_p = vstr_new_from_fp(self->ecc_curve->p);
-    vstr_t *ecc_curve_a = vstr_new_from_fp(self->ecc_curve->a);
-    vstr_t *ecc_curve_b = vstr_new_from_fp(self->ecc_curve->b);
-    vstr_t *ecc_curve_q = vstr_new_from_fp(self->ecc_curve->q);
-    vstr_t *ecc_curve_g_x = vstr_new_from_fp(self->ecc_curve->g->x);
-    vstr_t *ecc_curve_g_y = vstr_new_from_fp(self->ecc_curve->g->y);
-    mp_printf(print, "<Point x=%s y=%s curve=<Curve name=%s oid=%s p=%s a=%s b=%s q=%s gx=%s gy=%s>>", vstr_str(ecc_point_x), vstr_str(ecc_point_y), vstr_str(&self->ecc_curve->name), vstr_str(&vstr_oid), vstr_str(ecc_curve_p), vstr_str(ecc_curve_a), vstr_str(ecc_curve_b), vstr_str(ecc_curve_q), vstr_str(ecc_curve_g_x), vstr_str(ecc_curve_g_y));
-    vstr_free(ecc_point_x);
-    vstr_free(ecc_point_y);
-    vstr_free(ecc_curve_p);
-    vstr_free(ecc_curve_a);
-    vstr_free(ecc_curve_b);
-    vstr_free(ecc_curve_q);
-    vstr_free(ecc_curve_g_x);
-    vstr_free(ecc_curve_g_y);
+    fe25519_neg(R->X, P->X);
+    fe25519_copy(R->Y, P->Y);
+    fe25519_copy(R->Z, P->Z);
+    fe25519_neg(R->T, P->T);
 }
 
-static void point_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest)
+static void ge25519_tobytes(byte *s, const ge25519_t *P)
 {
-    mp_point_t *self = MP_OBJ_TO_PTR(obj);
-    if (dest[0] == MP_OBJ_NULL)
+    fe25519 zi, x, y;
+    fe25519_invert(zi, P->Z);
+    fe25519_mul(x, P->X, zi);
+    fe25519_mul(y, P->Y, zi);
+    fe25519_tobytes(s, y);
+    s[31] ^= fe25519_isnegative(x) << 7;
+}
+
+// the point of a canonical encoding (RFC 8032 5.1.3), false if there is none
+static bool ge25519_frombytes(ge25519_t *P, const byte *s)
+{
+    byte check[CURVE25519_SIZE];
+    fe25519 u, v, v3, vxx, t;
+
+    fe25519_frombytes(P->Y, s);
+    fe25519_tobytes(check, P->Y);
+    if (memcmp(check, s, CURVE25519_SIZE - 1) != 0 || check[31] != (s[31] & 0x7f))
     {
-        const mp_obj_type_t *type = mp_obj_get_type(obj);
-        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
-        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
-        if (elem != NULL)
-        {
-            if (attr == MP_QSTR_x)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_point->x);
-                return;
-            }
-            else if (attr == MP_QSTR_y)
-            {
-                dest[0] = mp_obj_new_int_from_fp(self->ecc_point->y);
-                return;
-            }
-            else if (attr == MP_QSTR_curve)
-            {
-                dest[0] = new_curve_init_copy(self);
-                return;
-            }
-            mp_convert_member_lookup(obj, type, elem->value, dest);
-        }
+        return false;
     }
-    else
+    fe25519_set(P->Z, 1);
+
+    // x = u * v^3 * (u * v^7)^((p - 5) / 8), u = y^2 - 1, v = d * y^2 + 1
+    fe25519_sq(u, P->Y);
+    fe25519_frombytes(t, ed25519_d);
+    fe25519_mul(v, u, t);
+    fe25519_sub(u, u, P->Z);
+    fe25519_add(v, v, P->Z);
+    fe25519_sq(v3, v);
+    fe25519_mul(v3, v3, v);
+    fe25519_sq(P->X, v3);
+    fe25519_mul(P->X, P->X, v);
+    fe25519_mul(P->X, P->X, u);
+    fe25519_pow22523(P->X, P->X);
+    fe25519_mul(P->X, P->X, v3);
+    fe25519_mul(P->X, P->X, u);
+
+    fe25519_sq(vxx, P->X);
+    fe25519_mul(vxx, vxx, v);
+    fe25519_sub(t, vxx, u);
+    if (!fe25519_iszero(t))
     {
-        if ((attr == MP_QSTR_x || attr == MP_QSTR_y) && !MP_OBJ_IS_INT(dest[1]))
-        {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT, mp_obj_get_type_str(dest[1]));
-        }
-        else if (attr == MP_QSTR_curve && !MP_OBJ_IS_TYPE(dest[1], &curve_type))
+        fe25519_add(t, vxx, u);
+        if (!fe25519_iszero(t))
         {
-            mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_BUT, mp_obj_get_type_str(dest[1]));
+            return false;
         }
+        fe25519_frombytes(t, ed25519_sqrtm1);
+        fe25519_mul(P->X, P->X, t);
+    }
 
-        if (attr == MP_QSTR_x)
+    int sign = s[31] >> 7;
+    if (fe25519_iszero(P->X) && sign)
+    {
+        return false;
+    }
+    if (fe25519_isnegative(P->X) != sign)
+    {
+        fe25519_neg(P->X, P->X);
+    }
+    fe25519_mul(P->T, P->X, P->Y);
+    return true;
+}
+
+// table[i] = i * P for i in 0..15
+static void ge25519_window_table(ge25519_t *table, const ge25519_t *P)
+{
+    ge25519_identity(&table[0]);
+    table[1] = *P;
+    for (int i = 2; i < 16; i++)
+    {
+        if (i & 1)
         {
-            mp_fp_for_int(dest[1], self->ecc_point->x);
+            ge25519_add(&table[i], &table[i - 1], P);
         }
-        else if (attr == MP_QSTR_y)
+        else
         {
-            mp_fp_for_int(dest[1], self->ecc_point->y);
+            ge25519_double(&table[i], &table[i / 2]);
         }
-        else if (attr == MP_QSTR_curve)
-        {
-            mp_curve_t *other = MP_OBJ_TO_PTR(dest[1]);
-
-            self->ecc_curve = m_new_obj(ecc_curve_t);
-            self->ecc_curve->p = fp_alloc();
-            self->ecc_curve->a = fp_alloc();
-            self->ecc_curve->b = fp_alloc();
-            self->ecc_curve->q = fp_alloc();
-            self->ecc_curve->g = m_new_obj(ecc_point_t);
-            self->ecc_curve->g->x = fp_alloc();
-            self->ecc_curve->g->y = fp_alloc();
+    }
+}
 
-            vstr_init(&self->ecc_curve->name, vstr_len(&other->ecc_curve->oid));
-            vstr_add_strn(&self->ecc_curve->name, vstr_str(&other->ecc_curve->name), vstr_len(&other->ecc_curve->name));
-            vstr_init(&self->ecc_curve->oid, vstr_len(&other->ecc_curve->oid));
-            vstr_add_strn(&self->ecc_curve->oid, vstr_str(&other->ecc_curve->oid), vstr_len(&other->ecc_curve->oid));
+/*
+    R = k * P for a 32 byte little-endian scalar, four bits per addition
+    and every entry of the table read for each, in constant time
+*/
+static void ge25519_scalarmult(ge25519_t *R, const byte *k, const ge25519_t *P)
+{
+    ge25519_t table[16];
+    ge25519_t T;
+    ge25519_window_table(table, P);
 
-            fp_copy(other->ecc_curve->p, self->ecc_curve->p);
-            fp_copy(other->ecc_curve->a, self->ecc_curve->a);
-            fp_copy(other->ecc_curve->b, self->ecc_curve->b);
-            fp_copy(other->ecc_curve->q, self->ecc_curve->q);
-            fp_copy(other->ecc_curve->g->x, self->ecc_curve->g->x);
-            fp_copy(other->ecc_curve->g->y, self->ecc_curve->g->y);
+    ge25519_identity(R);
+    for (int i = 2 * CURVE25519_SIZE - 1; i >= 0; i--)
+    {
+        int32_t nibble = (k[i / 2] >> (4 * (i & 1))) & 15;
+        for (int j = 0; j < 4; j++)
+        {
+            ge25519_double(R, R);
         }
-        else
+        ge25519_identity(&T);
+        for (int32_t j = 1; j < 16; j++)
         {
-            return;
+            int32_t eq = ((uint32_t)(j ^ nibble) - 1) >> 31;
+            fe25519_cmov(T.X, table[j].X, eq);
+            fe25519_cmov(T.Y, table[j].Y, eq);
+            fe25519_cmov(T.Z, table[j].Z, eq);
+            fe25519_cmov(T.T, table[j].T, eq);
         }
-        dest[0] = MP_OBJ_NULL; // indicate success
+        ge25519_add(R, R, &T);
     }
 }
 
-static mp_obj_t point_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs)
+// R = a * A + b * B for public scalars, one doubling chain for both (Straus)
+static void ge25519_double_scalarmult_vartime(ge25519_t *R, const byte *a, const ge25519_t *A, const byte *b, const ge25519_t *B)
 {
-    switch (op)
-    {
-    case MP_BINARY_OP_ADD:
+    ge25519_t ta[16];
+    ge25519_t tb[16];
+    ge25519_window_table(ta, A);
+    ge25519_window_table(tb, B);
+
+    ge25519_identity(R);
+    for (int i = 2 * CURVE25519_SIZE - 1; i >= 0; i--)
     {
-        if (!MP_OBJ_IS_TYPE(lhs, &point_type) && !MP_OBJ_IS_TYPE(rhs, &point_type))
+        for (int j = 0; j < 4; j++)
         {
-            mp_raise_TypeError(ERROR_EXPECTED_POINTS);
+            ge25519_double(R, R);
         }
-        mp_point_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
-        if (!ec_curve_equal(l->ecc_curve, r->ecc_curve))
+        int na = (a[i / 2] >> (4 * (i & 1))) & 15;
+        int nb = (b[i / 2] >> (4 * (i & 1))) & 15;
+        if (na)
         {
-            mp_raise_ValueError(ERROR_CURVE_OF_POINTS_NOT_EQUAL);
+            ge25519_add(R, R, &ta[na]);
         }
-
-        mp_curve_t *c = new_curve_init_copy(l);
-        return point_add(MP_OBJ_FROM_PTR(l), MP_OBJ_FROM_PTR(r), MP_OBJ_FROM_PTR(c));
-    }
-    case MP_BINARY_OP_SUBTRACT:
-    {
-        if (!MP_OBJ_IS_TYPE(lhs, &point_type) && !MP_OBJ_IS_TYPE(rhs, &point_type))
+        if (nb)
         {
-            mp_raise_TypeError(ERROR_EXPECTED_POINTS);
+            ge25519_add(R, R, &tb[nb]);
         }
-        mp_point_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
-        if (!ec_curve_equal(l->ecc_curve, r->ecc_curve))
+    }
+}
+
+// SHA-512 (FIPS 180-4), the hash of Ed25519
+typedef struct _sha512_ctx_t
+{
+    uint64_t state[8];
+    uint64_t length;
+    unsigned char block[128];
+    size_t used;
+} sha512_ctx_t;
+
+#define SHA512_DIGEST_SIZE 64
+#define SHA512_ROR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+static const uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
+    0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242, 0x12835b0145706fbe,
+    0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+    0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5, 0x983e5152ee66dfab,
+    0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed,
+    0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+    0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, 0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
+    0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373,
+    0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b, 0xca273eceea26619c,
+    0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba, 0x0a637dc5a2c898a6,
+    0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+};
+
+static void sha512_init(sha512_ctx_t *ctx)
+{
+    static const uint64_t iv[8] = {
+        0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+        0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
+    };
+    memcpy(ctx->state, iv, sizeof(iv));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+static void sha512_compress(sha512_ctx_t *ctx, const unsigned char *block)
+{
+    uint64_t w[80];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = 0;
+        for (int j = 0; j < 8; j++)
         {
-            mp_raise_ValueError(ERROR_CURVE_OF_POINTS_NOT_EQUAL);
+            w[i] = (w[i] << 8) | block[8 * i + j];
         }
+    }
+    for (int i = 16; i < 80; i++)
+    {
+        uint64_t s0 = SHA512_ROR(w[i - 15], 1) ^ SHA512_ROR(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        uint64_t s1 = SHA512_ROR(w[i - 2], 19) ^ SHA512_ROR(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
 
-        mp_curve_t *c = new_curve_init_copy(l);
-        return point_sub(MP_OBJ_FROM_PTR(l), MP_OBJ_FROM_PTR(r), MP_OBJ_FROM_PTR(c));
+    uint64_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint64_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 80; i++)
+    {
+        uint64_t t1 = h + (SHA512_ROR(e, 14) ^ SHA512_ROR(e, 18) ^ SHA512_ROR(e, 41)) + ((e & f) ^ (~e & g)) + sha512_k[i] + w[i];
+        uint64_t t2 = (SHA512_ROR(a, 28) ^ SHA512_ROR(a, 34) ^ SHA512_ROR(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
     }
-    case MP_BINARY_OP_MULTIPLY:
-#if defined(MICROPY_PY_ALL_SPECIAL_METHODS) && defined(MICROPY_PY_REVERSE_SPECIAL_METHODS)
-    case MP_BINARY_OP_REVERSE_MULTIPLY:
-#endif
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+static void sha512_update(sha512_ctx_t *ctx, const unsigned char *data, size_t len)
+{
+    ctx->length += len;
+    while (len > 0)
     {
-        if (!MP_OBJ_IS_TYPE(lhs, &point_type))
-        {
-            mp_raise_TypeError(ERROR_LEFT_EXPECTED_POINT);
-        }
-        if (!MP_OBJ_IS_INT(rhs))
+        size_t n = MIN(len, 128 - ctx->used);
+        memcpy(ctx->block + ctx->used, data, n);
+        ctx->used += n;
+        data += n;
+        len -= n;
+        if (ctx->used == 128)
         {
-            mp_raise_TypeError(ERROR_RIGHT_EXPECTED_INT);
+            sha512_compress(ctx, ctx->block);
+            ctx->used = 0;
         }
-        mp_point_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_curve_t *c = new_curve_init_copy(l);
-        return point_mul(MP_OBJ_FROM_PTR(l), rhs, MP_OBJ_FROM_PTR(c));
     }
-    case MP_BINARY_OP_EQUAL:
+}
+
+// messages below 2^61 bytes, the high half of the 128-bit length is 0
+static void sha512_final(sha512_ctx_t *ctx, unsigned char *digest)
+{
+    uint64_t bits = ctx->length * 8;
+    unsigned char pad = 0x80;
+    sha512_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->used != 112)
     {
-        if (!MP_OBJ_IS_TYPE(lhs, &point_type) && !MP_OBJ_IS_TYPE(rhs, &point_type))
-        {
-            mp_raise_TypeError(ERROR_EXPECTED_POINTS);
-        }
-        mp_point_t *l = MP_OBJ_TO_PTR(lhs);
-        mp_point_t *r = MP_OBJ_TO_PTR(rhs);
-        if (!ec_curve_equal(l->ecc_curve, r->ecc_curve))
+        sha512_update(ctx, &pad, 1);
+    }
+    unsigned char length[16] = {0};
+    for (int i = 0; i < 8; i++)
+    {
+        length[8 + i] = (unsigned char)(bits >> (56 - 8 * i));
+    }
+    sha512_update(ctx, length, 16);
+
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
         {
-            mp_raise_ValueError(ERROR_CURVE_OF_POINTS_NOT_EQUAL);
+            digest[8 * i + j] = (unsigned char)(ctx->state[i] >> (56 - 8 * j));
         }
-        return point_equal(MP_OBJ_FROM_PTR(l), MP_OBJ_FROM_PTR(r));
-    }
-    default:
-        return MP_OBJ_NULL; // op not supported
     }
 }
 
-static mp_obj_t point_unary_op(mp_unary_op_t op, mp_obj_t self_in)
+// a = len little-endian bytes, at most 64
+static void ed25519_fp_from_le(fp_int *a, const byte *s, size_t len)
 {
-    mp_point_t *point = MP_OBJ_TO_PTR(self_in);
-    switch (op)
-    {
-    case MP_UNARY_OP_NEGATIVE:
+    byte be[SHA512_DIGEST_SIZE];
+    for (size_t i = 0; i < len; i++)
     {
-        // copy point.y
-        fp_int *point_y_fp_int = fp_alloc();
-
-        fp_copy(point->ecc_point->y, point_y_fp_int);
+        be[i] = s[len - 1 - i];
+    }
+    fp_read_unsigned_bin(a, be, (int)len);
+    memset(be, 0, sizeof(be));
+}
 
-        // -point.y % curve.p
-        fp_neg(point->ecc_point->y, point->ecc_point->y);
-        fp_mod(point->ecc_point->y, point->ecc_curve->p, point->ecc_point->y);
+// s = a as 32 little-endian bytes, 0 <= a < 2^256
+static void ed25519_fp_to_le(byte *s, fp_int *a)
+{
+    byte be[CURVE25519_SIZE];
+    int len = fp_unsigned_bin_size(a);
+    memset(be, 0, sizeof(be));
+    fp_to_unsigned_bin(a, be + CURVE25519_SIZE - len);
+    for (int i = 0; i < CURVE25519_SIZE; i++)
+    {
+        s[i] = be[CURVE25519_SIZE - 1 - i];
+    }
+    memset(be, 0, sizeof(be));
+}
 
-        mp_point_t *pr = new_point_init_copy((mp_curve_t *)point);
+// s = the 64 byte hash h mod l, little-endian
+static void ed25519_reduce(byte *s, const byte *h, fp_int *l)
+{
+    fp_int *t = fp_alloc();
+    ed25519_fp_from_le(t, h, SHA512_DIGEST_SIZE);
+    fp_mod(t, l, t);
+    ed25519_fp_to_le(s, t);
+    fp_zero(t);
+    fp_free(t);
+}
 
-        // restore point.y
-        fp_copy(point_y_fp_int, point->ecc_point->y);
+// SHA-512(R || A || M) mod l, the challenge of a signature
+static void ed25519_challenge(byte *k, const byte *R, const byte *A, const byte *msg, size_t msg_len, fp_int *l)
+{
+    byte h[SHA512_DIGEST_SIZE];
+    sha512_ctx_t ctx;
+    sha512_init(&ctx);
+    sha512_update(&ctx, R, CURVE25519_SIZE);
+    sha512_update(&ctx, A, CURVE25519_SIZE);
+    sha512_update(&ctx, msg, msg_len);
+    sha512_final(&ctx, h);
+    ed25519_reduce(k, h, l);
+}
 
-        return MP_OBJ_FROM_PTR(pr);
-    }
-    default:
-        return MP_OBJ_NULL; // op not supported
+// a = the clamped low half of SHA-512(seed), prefix = the high half
+static void ed25519_expand(byte *a, byte *prefix, const byte *seed)
+{
+    byte h[SHA512_DIGEST_SIZE];
+    sha512_ctx_t ctx;
+    sha512_init(&ctx);
+    sha512_update(&ctx, seed, CURVE25519_SIZE);
+    sha512_final(&ctx, h);
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+    memcpy(a, h, CURVE25519_SIZE);
+    if (prefix != NULL)
+    {
+        memcpy(prefix, h + CURVE25519_SIZE, CURVE25519_SIZE);
     }
+    memset(h, 0, sizeof(h));
+    memset(&ctx, 0, sizeof(ctx));
 }
 
-static const mp_rom_map_elem_t point_locals_dict_table[] = {
-    {MP_ROM_QSTR(MP_QSTR_x), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_y), MP_ROM_INT(0)},
-    {MP_ROM_QSTR(MP_QSTR_curve), MP_ROM_PTR(mp_const_none)},
-};
-
-static MP_DEFINE_CONST_DICT(point_locals_dict, point_locals_dict_table);
-
-MP_DEFINE_CONST_OBJ_TYPE(
-    point_type,
-    MP_QSTR_Point,
-    MP_TYPE_FLAG_NONE,
-    print, point_print,
-    binary_op, point_binary_op,
-    unary_op, point_unary_op,
-    attr, point_attr,
-    locals_dict, &point_locals_dict);
+static void ed25519_public_key(byte *pk, const byte *seed)
+{
+    byte a[CURVE25519_SIZE];
+    ge25519_t A, B;
+    ed25519_expand(a, NULL, seed);
+    ge25519_base(&B);
+    UCRYPTO_GIL_EXIT();
+    ge25519_scalarmult(&A, a, &B);
+    ge25519_tobytes(pk, &A);
+    UCRYPTO_GIL_ENTER();
+    memset(a, 0, sizeof(a));
+}
 
-static mp_obj_t point(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+/*
+    sig = R || S of msg (RFC 8032 5.1.6). A is derived from the seed here and
+    never taken from the caller: the same r under two different A would give
+    two different challenges, and S - S' reveals a.
+*/
+static void ed25519_sign(byte *sig, const byte *msg, size_t msg_len, const byte *seed)
 {
-    static const mp_arg_t allowed_args[] = {
-        {MP_QSTR_x, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_y, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-        {MP_QSTR_curve, MP_ARG_OBJ, {.u_obj = mp_const_none}},
-    };
+    byte a[CURVE25519_SIZE], prefix[CURVE25519_SIZE], r[CURVE25519_SIZE], k[CURVE25519_SIZE], pk[CURVE25519_SIZE];
+    byte h[SHA512_DIGEST_SIZE];
+    ge25519_t A, R, B;
+    fp_int *l = fp_alloc();
+    ed25519_fp_from_le(l, ed25519_l, CURVE25519_SIZE);
+
+    ed25519_expand(a, prefix, seed);
+    sha512_ctx_t ctx;
+    sha512_init(&ctx);
+    sha512_update(&ctx, prefix, CURVE25519_SIZE);
+    sha512_update(&ctx, msg, msg_len);
+    sha512_final(&ctx, h);
+    ed25519_reduce(r, h, l);
+
+    UCRYPTO_GIL_ROOTS(l);
+    ge25519_base(&B);
+    UCRYPTO_GIL_EXIT();
+    ge25519_scalarmult(&A, a, &B);
+    ge25519_tobytes(pk, &A);
+    ge25519_scalarmult(&R, r, &B);
+    ge25519_tobytes(sig, &R);
+    UCRYPTO_GIL_ENTER();
+
+    ed25519_challenge(k, sig, pk, msg, msg_len, l);
+
+    // S = r + k * a mod l
+    fp_int *s = fp_alloc();
+    fp_int *t = fp_alloc();
+    ed25519_fp_from_le(s, k, CURVE25519_SIZE);
+    ed25519_fp_from_le(t, a, CURVE25519_SIZE);
+    fp_mul(s, t, s);
+    ed25519_fp_from_le(t, r, CURVE25519_SIZE);
+    fp_add(s, t, s);
+    fp_mod(s, l, s);
+    ed25519_fp_to_le(sig + CURVE25519_SIZE, s);
+
+    fp_zero(t);
+    fp_zero(s);
+    fp_free(t);
+    fp_free(s);
+    fp_free(l);
+    memset(a, 0, sizeof(a));
+    memset(prefix, 0, sizeof(prefix));
+    memset(r, 0, sizeof(r));
+    memset(k, 0, sizeof(k));
+    memset(h, 0, sizeof(h));
+    memset(&ctx, 0, sizeof(ctx));
+}
 
-    struct
+// the cofactorless check [S]B == R + [k]A (RFC 8032 5.1.7)
+static bool ed25519_verify(const byte *sig, const byte *msg, size_t msg_len, const byte *pk)
+{
+    ge25519_t A, B, R;
+    if (!ge25519_frombytes(&A, pk))
     {
-        mp_arg_val_t x, y, curve;
-    } args;
-    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t *)&args);
-
-    mp_point_t *point = m_new_obj(mp_point_t);
-    point->base.type = &point_type;
+        return false;
+    }
 
-    point->ecc_point = m_new_obj(ecc_point_t);
-    point->ecc_point->x = fp_alloc();
-    point->ecc_point->y = fp_alloc();
+    fp_int *l = fp_alloc();
+    fp_int *s = fp_alloc();
+    ed25519_fp_from_le(l, ed25519_l, CURVE25519_SIZE);
+    ed25519_fp_from_le(s, sig + CURVE25519_SIZE, CURVE25519_SIZE);
+    bool ok = fp_cmp(s, l) == FP_LT;
+    fp_free(s);
 
-    if (!MP_OBJ_IS_INT(args.x.u_obj))
+    if (ok)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(args.x.u_obj), 1);
+        byte k[CURVE25519_SIZE], check[CURVE25519_SIZE];
+        ed25519_challenge(k, sig, pk, msg, msg_len, l);
+
+        // [S]B - [k]A
+        UCRYPTO_GIL_ROOTS(l);
+        ge25519_neg(&A, &A);
+        ge25519_base(&B);
+        UCRYPTO_GIL_EXIT();
+        ge25519_double_scalarmult_vartime(&R, k, &A, sig + CURVE25519_SIZE, &B);
+        ge25519_tobytes(check, &R);
+        UCRYPTO_GIL_ENTER();
+        ok = memcmp(check, sig, CURVE25519_SIZE) == 0;
     }
-    else
+
+    fp_free(l);
+    return ok;
+}
+
+// a buffer of exactly 32 bytes
+static const byte *curve25519_get_buffer(mp_obj_t obj, const char *name)
+{
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(obj, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len != CURVE25519_SIZE)
     {
-        mp_fp_for_int(args.x.u_obj, point->ecc_point->x);
+        mp_raise_msg_varg(&mp_type_ValueError, ERROR_25519_LEN, name, (unsigned long)bufinfo.len);
     }
+    return bufinfo.buf;
+}
 
-    if (!MP_OBJ_IS_INT(args.y.u_obj))
+static mp_obj_t curve25519_x25519(size_t n_args, const mp_obj_t *args)
+{
+    /*
+        k (buffer): 32 byte scalar, clamped as RFC 7748 says
+        u (buffer/None): 32 byte u-coordinate, None is the base point 9
+        returns the 32 byte u-coordinate of k * u, all zero for a point of small order
+    */
+    UCRYPTO_STATS_API(POINT);
+    static const byte base[CURVE25519_SIZE] = {9};
+    byte k[CURVE25519_SIZE], u[CURVE25519_SIZE];
+    memcpy(k, curve25519_get_buffer(args[0], "k"), CURVE25519_SIZE);
+    if (n_args > 1 && args[1] != mp_const_none)
     {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_INT_AT_BUT, mp_obj_get_type_str(args.y.u_obj), 2);
+        memcpy(u, curve25519_get_buffer(args[1], "u"), CURVE25519_SIZE);
     }
     else
     {
-        mp_fp_for_int(args.y.u_obj, point->ecc_point->y);
+        memcpy(u, base, CURVE25519_SIZE);
     }
 
-    if (!MP_OBJ_IS_TYPE(args.curve.u_obj, &curve_type))
-    {
-        mp_raise_msg_varg(&mp_type_TypeError, ERROR_EXPECTED_CURVE_BUT, mp_obj_get_type_str(args.curve.u_obj));
-    }
-    else
+    vstr_t vstr_out;
+    vstr_init_len(&vstr_out, CURVE25519_SIZE);
+    byte out[CURVE25519_SIZE];
+    UCRYPTO_GIL_EXIT();
+    x25519_scalarmult(out, k, u);
+    UCRYPTO_GIL_ENTER();
+    memcpy(vstr_out.buf, out, CURVE25519_SIZE);
+    return mp_obj_new_bytes_from_vstr(&vstr_out);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(curve25519_x25519_obj, 1, 2, curve25519_x25519);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve25519_x25519_obj, MP_ROM_PTR(&curve25519_x25519_obj));
+
+static mp_obj_t curve25519_ed25519_public_key(mp_obj_t seed)
+{
+    /*
+        seed (buffer): 32 byte private key
+        returns the 32 byte encoded public key
+    */
+    UCRYPTO_STATS_API(POINT);
+    byte s[CURVE25519_SIZE];
+    memcpy(s, curve25519_get_buffer(seed, "seed"), CURVE25519_SIZE);
+
+    vstr_t vstr_out;
+    vstr_init_len(&vstr_out, CURVE25519_SIZE);
+    ed25519_public_key((byte *)vstr_out.buf, s);
+    memset(s, 0, sizeof(s));
+    return mp_obj_new_bytes_from_vstr(&vstr_out);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(curve25519_ed25519_public_key_obj, curve25519_ed25519_public_key);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve25519_ed25519_public_key_obj, MP_ROM_PTR(&curve25519_ed25519_public_key_obj));
+
+static mp_obj_t curve25519_ed25519_sign(mp_obj_t msg_in, mp_obj_t seed_in)
+{
+    /*
+        msg (buffer): message, signed as is (PureEdDSA)
+        seed (buffer): 32 byte private key
+        returns the 64 byte signature R || S
+    */
+    UCRYPTO_STATS_API(SIGN);
+    mp_buffer_info_t msg;
+    mp_get_buffer_raise(msg_in, &msg, MP_BUFFER_READ);
+    byte seed[CURVE25519_SIZE];
+    memcpy(seed, curve25519_get_buffer(seed_in, "seed"), CURVE25519_SIZE);
+
+    vstr_t vstr_out;
+    vstr_init_len(&vstr_out, 2 * CURVE25519_SIZE);
+    ed25519_sign((byte *)vstr_out.buf, msg.buf, msg.len, seed);
+    memset(seed, 0, sizeof(seed));
+    return mp_obj_new_bytes_from_vstr(&vstr_out);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(curve25519_ed25519_sign_obj, curve25519_ed25519_sign);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve25519_ed25519_sign_obj, MP_ROM_PTR(&curve25519_ed25519_sign_obj));
+
+static mp_obj_t curve25519_ed25519_verify(mp_obj_t signature, mp_obj_t msg, mp_obj_t public_key)
+{
+    /*
+        signature (buffer): 64 byte signature R || S
+        msg (buffer): message
+        public_key (buffer): 32 byte public key
+        returns True for a valid signature
+    */
+    UCRYPTO_STATS_API(VERIFY);
+    mp_buffer_info_t sig, m;
+    mp_get_buffer_raise(signature, &sig, MP_BUFFER_READ);
+    mp_get_buffer_raise(msg, &m, MP_BUFFER_READ);
+    byte pk[CURVE25519_SIZE];
+    memcpy(pk, curve25519_get_buffer(public_key, "public_key"), CURVE25519_SIZE);
+    if (sig.len != 2 * CURVE25519_SIZE)
     {
-        mp_curve_t *curve = MP_OBJ_TO_PTR(args.curve.u_obj);
-
-        point->ecc_curve = m_new_obj(ecc_curve_t);
-        point->ecc_curve->p = fp_alloc();
-        point->ecc_curve->a = fp_alloc();
-        point->ecc_curve->b = fp_alloc();
-        point->ecc_curve->q = fp_alloc();
-        point->ecc_curve->g = m_new_obj(ecc_point_t);
-        point->ecc_curve->g->x = fp_alloc();
-        point->ecc_curve->g->y = fp_alloc();
-
-        vstr_init(&point->ecc_curve->name, vstr_len(&curve->ecc_curve->oid));
-        vstr_add_strn(&point->ecc_curve->name, vstr_str(&curve->ecc_curve->name), vstr_len(&curve->ecc_curve->name));
-        vstr_init(&point->ecc_curve->oid, vstr_len(&curve->ecc_curve->oid));
-        vstr_add_strn(&point->ecc_curve->oid, vstr_str(&curve->ecc_curve->oid), vstr_len(&curve->ecc_curve->oid));
-
-        fp_copy(curve->ecc_curve->p, point->ecc_curve->p);
-        fp_copy(curve->ecc_curve->a, point->ecc_curve->a);
-        fp_copy(curve->ecc_curve->b, point->ecc_curve->b);
-        fp_copy(curve->ecc_curve->q, point->ecc_curve->q);
-        fp_copy(curve->ecc_curve->g->x, point->ecc_curve->g->x);
-        fp_copy(curve->ecc_curve->g->y, point->ecc_curve->g->y);
+        return mp_const_false;
     }
-    return MP_OBJ_FROM_PTR(point);
+
+    byte s[2 * CURVE25519_SIZE];
+    memcpy(s, sig.buf, sizeof(s));
+    return mp_obj_new_bool(ed25519_verify(s, m.buf, m.len, pk));
 }
 
-static MP_DEFINE_CONST_FUN_OBJ_KW(point_obj, 3, point);
-static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_point_obj, MP_ROM_PTR(&point_obj));
+static MP_DEFINE_CONST_FUN_OBJ_3(curve25519_ed25519_verify_obj, curve25519_ed25519_verify);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(static_curve25519_ed25519_verify_obj, MP_ROM_PTR(&curve25519_ed25519_verify_obj));
 
-static void ecc_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+static void curve25519_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
 {
     (void)kind;
     mp_printf(print, mp_obj_get_type_str(self_in));
 }
 
-/* static void signature_eth_deinit(mp_obj_t self_in) {
-    mp_ecdsa_signature_eth_t *self = MP_OBJ_TO_PTR(self_in);
-    fp_free(self->ecdsa_signature_eth->r);
-    fp_free(self->ecdsa_signature_eth->s);
-    m_del_obj(ecdsa_signature_teth, self->ecdsa_signature_eth);
-    m_del_obj(mp_ecdsa_signature_eth_t, self);
-} */
-
-static const mp_rom_map_elem_t ecc_locals_dict_table[] = {
-    {MP_ROM_QSTR(MP_QSTR_Point), MP_ROM_PTR(&static_point_obj)},
-    {MP_ROM_QSTR(MP_QSTR_point_equal), MP_ROM_PTR(&static_point_equal_obj)},
-    {MP_ROM_QSTR(MP_QSTR_point_double), MP_ROM_PTR(&static_point_double_obj)},
-    {MP_ROM_QSTR(MP_QSTR_point_add), MP_ROM_PTR(&static_point_add_obj)},
-    {MP_ROM_QSTR(MP_QSTR_point_sub), MP_ROM_PTR(&static_point_sub_obj)},
-    {MP_ROM_QSTR(MP_QSTR_point_mul), MP_ROM_PTR(&static_point_mul_obj)},
-    {MP_ROM_QSTR(MP_QSTR_Curve), MP_ROM_PTR(&static_curve_obj)},
-    {MP_ROM_QSTR(MP_QSTR_curve_equal), MP_ROM_PTR(&static_curve_equal_obj)},
-    {MP_ROM_QSTR(MP_QSTR_point_in_curve), MP_ROM_PTR(&static_point_in_curve_obj)},
-    {MP_ROM_QSTR(MP_QSTR_Signature), MP_ROM_PTR(&static_signature_obj)},
-    {MP_ROM_QSTR(MP_QSTR_ecdsa_sign), MP_ROM_PTR(&static_ecdsa_sign_obj)},
-    {MP_ROM_QSTR(MP_QSTR_ecdsa_verify), MP_ROM_PTR(&static_ecdsa_verify_obj)},
+static const mp_rom_map_elem_t curve25519_locals_dict_table[] = {
+    {MP_ROM_QSTR(MP_QSTR_x25519), MP_ROM_PTR(&static_curve25519_x25519_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ed25519_public_key), MP_ROM_PTR(&static_curve25519_ed25519_public_key_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ed25519_sign), MP_ROM_PTR(&static_curve25519_ed25519_sign_obj)},
+    {MP_ROM_QSTR(MP_QSTR_ed25519_verify), MP_ROM_PTR(&static_curve25519_ed25519_verify_obj)},
 };
 
-static MP_DEFINE_CONST_DICT(ecc_locals_dict, ecc_locals_dict_table);
+static MP_DEFINE_CONST_DICT(curve25519_locals_dict, curve25519_locals_dict_table);
 
 MP_DEFINE_CONST_OBJ_TYPE(
-    ecc_type,
-    MP_QSTR_ECC,
+    curve25519_type,
+    MP_QSTR_CURVE25519,
     MP_TYPE_FLAG_NONE,
-    print, ecc_print,
-    locals_dict, &ecc_locals_dict);
+    print, curve25519_print,
+    locals_dict, &curve25519_locals_dict);
+
+
+#if MICROPY_PY_UCRYPTO_STATS
+static mp_obj_t mod_stats(void)
+{
+    /*
+        returns {api: {counter: value}}, cycles is absent when the port has no cycle counter
+    */
+    mp_obj_t stats = mp_obj_new_dict(UCRYPTO_API_COUNT);
+    for (int api = 0; api < UCRYPTO_API_COUNT; api++)
+    {
+        mp_obj_t counters = mp_obj_new_dict(UCRYPTO_STAT_COUNT);
+        for (int stat = 0; stat < UCRYPTO_STAT_COUNT; stat++)
+        {
+            if (stat == UCRYPTO_STAT_CYCLES && !UCRYPTO_STATS_HAS_CYCLES)
+            {
+                continue;
+            }
+            mp_obj_dict_store(counters, MP_OBJ_NEW_QSTR(ucrypto_stat_names[stat]), mp_obj_new_int_from_ull(ucrypto_stats[api][stat]));
+        }
+        mp_obj_dict_store(stats, MP_OBJ_NEW_QSTR(ucrypto_api_names[api]), counters);
+    }
+    return stats;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_0(mod_stats_obj, mod_stats);
+
+static mp_obj_t mod_stats_reset(void)
+{
+    memset(ucrypto_stats, 0, sizeof(ucrypto_stats));
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_0(mod_stats_reset_obj, mod_stats_reset);
+#endif
 
 
 static const mp_rom_map_elem_t mp_module_ucrypto_globals_table[] = {
     {MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR__crypto)},
     {MP_ROM_QSTR(MP_QSTR_ECC), MP_ROM_PTR(&ecc_type)},
     {MP_ROM_QSTR(MP_QSTR_NUMBER), MP_ROM_PTR(&number_type)},
+    {MP_ROM_QSTR(MP_QSTR_RSAKey), MP_ROM_PTR(&rsa_key_type)},
+    {MP_ROM_QSTR(MP_QSTR_Job), MP_ROM_PTR(&job_type)},
+    {MP_ROM_QSTR(MP_QSTR_CURVE25519), MP_ROM_PTR(&curve25519_type)},
     {MP_ROM_QSTR(MP_QSTR_SignatureETH), MP_ROM_PTR(&signature_eth_type)},
     {MP_ROM_QSTR(MP_QSTR_ecdsa_sign_eth), MP_ROM_PTR(&ecdsa_sign_eth_obj)},
     {MP_ROM_QSTR(MP_QSTR_ecdsa_verify_eth), MP_ROM_PTR(&ecdsa_verify_eth_obj)},
+#if MICROPY_PY_UCRYPTO_STATS
+    {MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&mod_stats_obj)},
+    {MP_ROM_QSTR(MP_QSTR_stats_reset), MP_ROM_PTR(&mod_stats_reset_obj)},
+#endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_ucrypto_globals, mp_module_ucrypto_globals_table);
@@ -2575,19 +8825,19 @@ static mp_obj_t signature_eth_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest) {
     mp_ecdsa_signature_eth_t *self = MP_OBJ_TO_PTR(obj);
     if (dest[0] == MP_OBJ_NULL) { // Load operation
         if (attr == MP_QSTR_r) {
-            dest[0] = mp_obj_new_int_from_fp(self->ecdsa_signature_eth->r);
+            dest[0] = mp_obj_new_int_from_compact(self->r);
             return MP_OBJ_FROM_PTR(dest);
         }
         else if (attr == MP_QSTR_s) {
-            dest[0] = mp_obj_new_int_from_fp(self->ecdsa_signature_eth->s);
+            dest[0] = mp_obj_new_int_from_compact(self->s);
             return MP_OBJ_FROM_PTR(dest);
         }
         else if (attr == MP_QSTR_v_eth) {
-            dest[0] = mp_obj_new_int(self->ecdsa_signature_eth->v);
+            dest[0] = mp_obj_new_int(self->v);
             return MP_OBJ_FROM_PTR(dest);
         }
         else if (attr == MP_QSTR_chainId) {
-            dest[0] = mp_obj_new_int(self->ecdsa_signature_eth->chainId);
+            dest[0] = mp_obj_new_int(self->chainId);
             return MP_OBJ_FROM_PTR(dest);
         }
     }
@@ -2599,11 +8849,11 @@ static mp_obj_t signature_eth_attr(mp_obj_t obj, qstr attr, mp_obj_t *dest) {
 /**
  * Operações binárias para SignatureETH.
  */
-static bool signature_eth_equal(ecdsa_signature_teth *s1, ecdsa_signature_teth *s2) {
-    if (fp_cmp(s1->r, s2->r) != FP_EQ) {
+static bool signature_eth_equal(mp_ecdsa_signature_eth_t *s1, mp_ecdsa_signature_eth_t *s2) {
+    if (!fp_compact_equal(s1->r, s2->r)) {
         return false;
     }
-    if (fp_cmp(s1->s, s2->s) != FP_EQ) {
+    if (!fp_compact_equal(s1->s, s2->s)) {
         return false;
     }
     if (s1->v != s2->v) {
@@ -2623,7 +8873,7 @@ static mp_obj_t signature_eth_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_
             }
             mp_ecdsa_signature_eth_t *l = MP_OBJ_TO_PTR(lhs);
             mp_ecdsa_signature_eth_t *r = MP_OBJ_TO_PTR(rhs);
-            return mp_obj_new_bool(signature_eth_equal(l->ecdsa_signature_eth, r->ecdsa_signature_eth));
+            return mp_obj_new_bool(signature_eth_equal(l, r));
         }
         default:
             return MP_OBJ_NULL; // Operação não suportada
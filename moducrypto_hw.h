@@ -0,0 +1,60 @@
+/*
+ * This file is part of the Micro Python project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Damiano Mazzella
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+    Hardware backend of moducrypto.c, built with MICROPY_PY_UCRYPTO_HW=1 and
+    exactly one source implementing these functions (UCRYPTO_HW in
+    micropython.cmake / micropython.mk).
+
+    Every function returns FP_OKAY when the hardware computed the result.
+    For any other return value the outputs are left untouched, and
+    moducrypto.c computes the result with tomsfastmath. A backend therefore
+    rejects the sizes and curves its peripheral does not take, and any
+    driver error, by returning UCRYPTO_HW_UNSUPPORTED.
+
+    The functions run with the GIL released. They must not allocate on the
+    MicroPython heap or raise.
+*/
+#ifndef MODUCRYPTO_HW_H
+#define MODUCRYPTO_HW_H
+
+#include "tomsfastmath/tfm_mpi.h"
+
+#define UCRYPTO_HW_UNSUPPORTED (-1)
+
+// Y = G**X (mod P), 0 <= G < P, X >= 0, P odd
+int ucrypto_hw_exptmod(fp_int *G, fp_int *X, fp_int *P, fp_int *Y);
+
+// d = a * b (mod c), 0 <= a, b < c
+int ucrypto_hw_mulmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d);
+
+/*
+    (rx, ry) = k * (x, y) on y^2 = x^3 + a * x + b (mod p) of order q,
+    0 < k < q, (x, y) is not the identity
+*/
+int ucrypto_hw_point_mul(fp_int *rx, fp_int *ry, fp_int *x, fp_int *y, fp_int *k, fp_int *p, fp_int *a, fp_int *b, fp_int *q);
+
+#endif // MODUCRYPTO_HW_H
@@ -0,0 +1,284 @@
+/*
+ * This file is part of the Micro Python project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Damiano Mazzella
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+    Hardware backend for the ESP32 family through the mbedtls of ESP-IDF,
+    selected with UCRYPTO_HW=mbedtls. With CONFIG_MBEDTLS_HARDWARE_MPI,
+    mbedtls_mpi_exp_mod runs on the RSA peripheral. With
+    CONFIG_MBEDTLS_HARDWARE_ECC (the SoCs with SOC_ECC_SUPPORTED),
+    mbedtls_ecp_mul runs P-192 and P-256 on the ECC peripheral. Everything
+    else stays on tomsfastmath, as the software paths of mbedtls are not
+    faster than ours.
+*/
+#include <string.h>
+
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+#include "esp_random.h"
+#include "mbedtls/bignum.h"
+#include "mbedtls/ecp.h"
+
+#include "moducrypto_hw.h"
+
+// below this the copies in and out of mbedtls cost more than the peripheral saves
+#ifndef UCRYPTO_HW_EXPTMOD_MIN_BITS
+#define UCRYPTO_HW_EXPTMOD_MIN_BITS (512)
+#endif
+
+#if defined(SOC_RSA_MAX_BIT_LEN)
+#define UCRYPTO_HW_EXPTMOD_MAX_BITS (SOC_RSA_MAX_BIT_LEN)
+#else
+#define UCRYPTO_HW_EXPTMOD_MAX_BITS (4096)
+#endif
+
+static int hw_mpi_from_fp(mbedtls_mpi *X, fp_int *a)
+{
+    unsigned char buf[FP_MAX_SIZE / 8];
+    int len = fp_unsigned_bin_size(a);
+    if (len > (int)sizeof(buf))
+    {
+        return UCRYPTO_HW_UNSUPPORTED;
+    }
+    fp_to_unsigned_bin(a, buf);
+    return mbedtls_mpi_read_binary(X, buf, len);
+}
+
+static int hw_fp_from_mpi(fp_int *a, const mbedtls_mpi *X)
+{
+    unsigned char buf[FP_MAX_SIZE / 8];
+    size_t len = mbedtls_mpi_size(X);
+    if (len > sizeof(buf) || mbedtls_mpi_write_binary(X, buf, len) != 0)
+    {
+        return UCRYPTO_HW_UNSUPPORTED;
+    }
+    fp_read_unsigned_bin(a, buf, (int)len);
+    return FP_OKAY;
+}
+
+int ucrypto_hw_exptmod(fp_int *G, fp_int *X, fp_int *P, fp_int *Y)
+{
+#if CONFIG_MBEDTLS_HARDWARE_MPI
+    int bits = fp_count_bits(P);
+    if (bits < UCRYPTO_HW_EXPTMOD_MIN_BITS || bits > UCRYPTO_HW_EXPTMOD_MAX_BITS || fp_count_bits(X) > UCRYPTO_HW_EXPTMOD_MAX_BITS)
+    {
+        return UCRYPTO_HW_UNSUPPORTED;
+    }
+
+    mbedtls_mpi g, x, p, y;
+    mbedtls_mpi_init(&g);
+    mbedtls_mpi_init(&x);
+    mbedtls_mpi_init(&p);
+    mbedtls_mpi_init(&y);
+
+    int ret = hw_mpi_from_fp(&g, G);
+    if (ret == 0)
+    {
+        ret = hw_mpi_from_fp(&x, X);
+    }
+    if (ret == 0)
+    {
+        ret = hw_mpi_from_fp(&p, P);
+    }
+    if (ret == 0)
+    {
+        ret = mbedtls_mpi_exp_mod(&y, &g, &x, &p, NULL);
+    }
+    if (ret == 0)
+    {
+        ret = hw_fp_from_mpi(Y, &y);
+    }
+
+    mbedtls_mpi_free(&g);
+    mbedtls_mpi_free(&x);
+    mbedtls_mpi_free(&p);
+    mbedtls_mpi_free(&y);
+
+    return ret == 0 ? FP_OKAY : UCRYPTO_HW_UNSUPPORTED;
+#else
+    (void)G;
+    (void)X;
+    (void)P;
+    (void)Y;
+    return UCRYPTO_HW_UNSUPPORTED;
+#endif
+}
+
+int ucrypto_hw_mulmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d)
+{
+    // mbedtls_mpi_mul_mpi runs on the peripheral but the reduction after it does not, fp_mulmod is faster
+    (void)a;
+    (void)b;
+    (void)c;
+    (void)d;
+    return UCRYPTO_HW_UNSUPPORTED;
+}
+
+#if CONFIG_MBEDTLS_HARDWARE_ECC
+
+// the curves of the ECC peripheral
+static const mbedtls_ecp_group_id hw_group_ids[] = {MBEDTLS_ECP_DP_SECP192R1, MBEDTLS_ECP_DP_SECP256R1};
+
+static int hw_rng(void *ctx, unsigned char *buf, size_t len)
+{
+    (void)ctx;
+    esp_fill_random(buf, len);
+    return 0;
+}
+
+/*
+    Loads into grp the NIST curve with these parameters, a = -3 (mod p).
+    A group of these curves points to constant tables, so it is loaded per
+    call instead of cached, which two cores could race for.
+*/
+static int hw_group_load(mbedtls_ecp_group *grp, mbedtls_mpi *p, fp_int *a, mbedtls_mpi *b, mbedtls_mpi *q)
+{
+    for (size_t i = 0; i < sizeof(hw_group_ids) / sizeof(hw_group_ids[0]); i++)
+    {
+        if (mbedtls_ecp_group_load(grp, hw_group_ids[i]) != 0)
+        {
+            continue;
+        }
+        if (mbedtls_mpi_cmp_mpi(&grp->P, p) == 0 && mbedtls_mpi_cmp_mpi(&grp->B, b) == 0 && mbedtls_mpi_cmp_mpi(&grp->N, q) == 0)
+        {
+            fp_int t;
+            fp_init(&t);
+            fp_add_d(a, 3, &t);
+            mbedtls_mpi a3;
+            mbedtls_mpi_init(&a3);
+            int ret = hw_mpi_from_fp(&a3, &t);
+            if (ret == 0 && mbedtls_mpi_cmp_mpi(&a3, p) != 0)
+            {
+                ret = UCRYPTO_HW_UNSUPPORTED;
+            }
+            mbedtls_mpi_free(&a3);
+            return ret;
+        }
+    }
+    return UCRYPTO_HW_UNSUPPORTED;
+}
+
+#endif
+
+int ucrypto_hw_point_mul(fp_int *rx, fp_int *ry, fp_int *x, fp_int *y, fp_int *k, fp_int *p, fp_int *a, fp_int *b, fp_int *q)
+{
+#if CONFIG_MBEDTLS_HARDWARE_ECC
+    int bits = fp_count_bits(p);
+    if (bits != 192 && bits != 256)
+    {
+        return UCRYPTO_HW_UNSUPPORTED;
+    }
+
+    mbedtls_mpi mp, mb, mq, mk;
+    mbedtls_ecp_group group;
+    mbedtls_ecp_point P, R;
+    mbedtls_ecp_group_init(&group);
+    mbedtls_mpi_init(&mp);
+    mbedtls_mpi_init(&mb);
+    mbedtls_mpi_init(&mq);
+    mbedtls_mpi_init(&mk);
+    mbedtls_ecp_point_init(&P);
+    mbedtls_ecp_point_init(&R);
+
+    mbedtls_ecp_group *grp = &group;
+    int ret = hw_mpi_from_fp(&mp, p);
+    if (ret == 0)
+    {
+        ret = hw_mpi_from_fp(&mb, b);
+    }
+    if (ret == 0)
+    {
+        ret = hw_mpi_from_fp(&mq, q);
+    }
+    if (ret == 0)
+    {
+        ret = hw_group_load(grp, &mp, a, &mb, &mq);
+    }
+    if (ret == 0)
+    {
+        // 04 || x || y, mbedtls_ecp_mul checks that the point is on the curve
+        unsigned char buf[1 + 2 * 32];
+        size_t plen = mbedtls_mpi_size(&grp->P);
+        memset(buf, 0, sizeof(buf));
+        buf[0] = 0x04;
+        if (fp_unsigned_bin_size(x) > (int)plen || fp_unsigned_bin_size(y) > (int)plen)
+        {
+            ret = UCRYPTO_HW_UNSUPPORTED;
+        }
+        else
+        {
+            fp_to_unsigned_bin(x, buf + 1 + plen - fp_unsigned_bin_size(x));
+            fp_to_unsigned_bin(y, buf + 1 + 2 * plen - fp_unsigned_bin_size(y));
+            ret = mbedtls_ecp_point_read_binary(grp, &P, buf, 1 + 2 * plen);
+        }
+    }
+    if (ret == 0)
+    {
+        ret = hw_mpi_from_fp(&mk, k);
+    }
+    if (ret == 0)
+    {
+        ret = mbedtls_ecp_mul(grp, &R, &mk, &P, hw_rng, NULL);
+    }
+    if (ret == 0)
+    {
+        // the result is not the identity for 0 < k < q
+        unsigned char buf[1 + 2 * 32];
+        size_t olen;
+        size_t plen = mbedtls_mpi_size(&grp->P);
+        ret = mbedtls_ecp_point_write_binary(grp, &R, MBEDTLS_ECP_PF_UNCOMPRESSED, &olen, buf, sizeof(buf));
+        if (ret == 0 && olen == 1 + 2 * plen)
+        {
+            fp_read_unsigned_bin(rx, buf + 1, (int)plen);
+            fp_read_unsigned_bin(ry, buf + 1 + plen, (int)plen);
+        }
+        else
+        {
+            ret = UCRYPTO_HW_UNSUPPORTED;
+        }
+    }
+
+    mbedtls_ecp_point_free(&P);
+    mbedtls_ecp_point_free(&R);
+    mbedtls_ecp_group_free(&group);
+    mbedtls_mpi_free(&mp);
+    mbedtls_mpi_free(&mb);
+    mbedtls_mpi_free(&mq);
+    mbedtls_mpi_free(&mk);
+
+    return ret == 0 ? FP_OKAY : UCRYPTO_HW_UNSUPPORTED;
+#else
+    (void)rx;
+    (void)ry;
+    (void)x;
+    (void)y;
+    (void)k;
+    (void)p;
+    (void)a;
+    (void)b;
+    (void)q;
+    return UCRYPTO_HW_UNSUPPORTED;
+#endif
+}
@@ -8,6 +8,9 @@ freeze(
         "ufastecdsa/point.py",
         "ufastecdsa/signature.py",
         "ufastecdsa/util.py",
+        "ufast25519/__init__.py",
+        "ufast25519/ed25519.py",
+        "ufast25519/x25519.py",
         "ufastrsa/__init__.py",
         "ufastrsa/genprime.py",
         "ufastrsa/rsa.py",
@@ -0,0 +1,31 @@
+# coding=utf-8
+# pylint: disable=E0401
+import os
+
+import _crypto
+
+
+def gen_private_key():
+    return os.urandom(32)
+
+
+def get_public_key(seed):
+    return _crypto.CURVE25519.ed25519_public_key(seed)
+
+
+def gen_keypair():
+    seed = gen_private_key()
+    return seed, get_public_key(seed)
+
+
+def sign(msg, seed):
+    # the public key is derived from seed inside, a mismatched one would leak the key
+    if isinstance(msg, str):
+        msg = msg.encode()
+    return _crypto.CURVE25519.ed25519_sign(msg, seed)
+
+
+def verify(signature, msg, public_key):
+    if isinstance(msg, str):
+        msg = msg.encode()
+    return _crypto.CURVE25519.ed25519_verify(signature, msg, public_key)
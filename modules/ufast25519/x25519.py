@@ -0,0 +1,27 @@
+# coding=utf-8
+# pylint: disable=E0401
+import os
+
+import _crypto
+
+
+def gen_private_key():
+    # any 32 bytes, x25519 clamps the scalar
+    return os.urandom(32)
+
+
+def get_public_key(k):
+    return _crypto.CURVE25519.x25519(k)
+
+
+def gen_keypair():
+    k = gen_private_key()
+    return k, get_public_key(k)
+
+
+def shared_secret(k, peer_public_key):
+    secret = _crypto.CURVE25519.x25519(k, peer_public_key)
+    if secret == bytes(32):
+        # RFC 7748 6.1, a peer key of small order
+        raise ValueError("invalid peer public key")
+    return secret
@@ -11,16 +11,39 @@ class CurveNotFoundError(Exception):
 
 
 class Curve(object):
-    def __init__(self, name, p, a, b, q, gx, gy, oid=None):
-        self._curve = _crypto.ECC.Curve(p, a, b, q, gx, gy, name=name, oid=oid)
+    def __init__(self, name, p=None, a=None, b=None, q=None, gx=None, gy=None, oid=None):
+        if p is None:
+            # built-in curve, the parameters come from ROM
+            self._curve = _crypto.ECC.named_curve(name)
+        else:
+            self._curve = _crypto.ECC.Curve(p, a, b, q, gx, gy, name=name, oid=oid)
 
     @classmethod
     def from_oid(cls, oid):
         if not oid in _CURVE_OIDS:
-            raise CurveNotFoundError(oid)
+            try:
+                _CURVE_OIDS[oid] = cls(oid)
+            except ValueError:
+                raise CurveNotFoundError(oid)
 
         return _CURVE_OIDS[oid]
 
+    @classmethod
+    def from_name(cls, name):
+        # one object per curve, so the generator table is built once
+        for curve in _CURVE_OIDS.values():
+            if curve.name == name:
+                return curve
+        try:
+            curve = cls(name)
+        except ValueError:
+            raise CurveNotFoundError(name)
+        return _CURVE_OIDS.setdefault(curve.oid, curve)
+
+    def precompute(self):
+        # builds the generator tables used by signing, key generation and the prepared public keys
+        self._curve.precompute()
+
     def __getattr__(self, name):
         if name in ("p", "a", "b", "q", "gx", "gy", "name", "oid", "G"):
             return getattr(self._curve, name)
@@ -57,17 +80,8 @@ class Curve(object):
         ):
             yield item
 
-P256 = Curve(
-    "P256",
-    0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF,
-    0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFC,
-    0x5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604B,
-    0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551,
-    0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296,
-    0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5,
-    oid=b'\x2A\x86\x48\xCE\x3D\x03\x01\x07',
-)
+P256 = Curve("P256")
 
 _CURVE_OIDS = {
-    b'\x2A\x86\x48\xCE\x3D\x03\x01\x07': P256
+    P256.oid: P256
 }
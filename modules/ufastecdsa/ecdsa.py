@@ -1,11 +1,10 @@
 # coding=utf-8
 # pylint: disable=E0401
-import binascii
 import hashlib
 
 import _crypto
 from ufastecdsa.curve import P256
-from ufastecdsa.util import RFC6979, get_bit_length
+from ufastecdsa.util import RFC6979, get_bit_length, split_batch
 from ufastecdsa.point import Point
 from ufastecdsa.signature import Signature
 
@@ -20,7 +19,25 @@ class InvalidSignature(EcdsaError):
         self.msg = msg
 
 
+def _native_public_key(Q, curve):
+    # a key of keys.prepare_public_key was checked once when prepared
+    if type(Q).__name__ == "PublicKey":
+        return Q
+    if not isinstance(Q, Point):
+        raise EcdsaError("Invalid public key: point must be of type Point")
+    if not Q._point in curve._curve:
+        raise EcdsaError(
+            "Invalid public key: point is not on curve {0}".format(curve.name)
+        )
+    return Q._point
+
+
 def sign(msg, d, curve=P256, hashfunc=hashlib.sha256, nonce=None):
+    digest = hashfunc(msg).digest()
+    if nonce is None and hashfunc is hashlib.sha256:
+        # RFC 6979 nonce generated natively
+        signature = _crypto.ECC.ecdsa_sign_digest(digest, d, None, curve._curve)
+        return signature.r, signature.s
     k = nonce or RFC6979(msg, d, curve.q, hashfunc=hashfunc).gen_nonce()
     ks = k + curve.q
     kt = ks + curve.q
@@ -28,9 +45,7 @@ def sign(msg, d, curve=P256, hashfunc=hashlib.sha256, nonce=None):
         k = kt
     else:
         k = ks
-    digest = hashfunc(msg).digest()
-    hex_digest = binascii.hexlify(digest)
-    signature = _crypto.ECC.ecdsa_sign(hex_digest, d, k, curve._curve)
+    signature = _crypto.ECC.ecdsa_sign_digest(digest, d, k, curve._curve)
     return signature.r, signature.s
 
 
@@ -40,18 +55,32 @@ def verify(signature, message, Q, curve=P256, hashfunc=hashlib.sha256):
     if isinstance(signature, Signature):
         signature = _crypto.ECC.Signature(signature.r, signature.s)
 
-    if not isinstance(Q, Point):
-        raise EcdsaError("Invalid public key: point must be of type Point")
-
-    if not Q._point in curve._curve:
-        raise EcdsaError(
-            "Invalid public key: point is not on curve {0}".format(curve.name)
-        )
-    elif signature.r > curve.q or signature.r < 1:
+    Q = _native_public_key(Q, curve)
+    if signature.r > curve.q or signature.r < 1:
         raise InvalidSignature("r is not a positive int smaller than the curve order")
     elif signature.s > curve.q or signature.s < 1:
         raise InvalidSignature("s is not a positive int smaller than the curve order")
 
     digest = hashfunc(message).digest()
-    hex_digest = binascii.hexlify(digest)
-    return _crypto.ECC.ecdsa_verify(signature, hex_digest, Q._point, curve._curve)
+    return _crypto.ECC.ecdsa_verify_digest(signature, digest, Q, curve._curve)
+
+
+def verify_batch(signatures, messages, keys, curve=P256, hashfunc=hashlib.sha256, dual_core=False):
+    sigs = []
+    for signature in signatures:
+        if isinstance(signature, (tuple, list)):
+            signature = Signature(signature[0], signature[1])
+        sigs.append(_crypto.ECC.Signature(signature.r, signature.s))
+
+    points = [_native_public_key(Q, curve) for Q in keys]
+
+    digests = [hashfunc(message).digest() for message in messages]
+    if not dual_core:
+        return _crypto.ECC.ecdsa_verify_batch(sigs, digests, points, curve._curve)
+
+    # the tables built once here, not by both threads at the same time
+    curve._curve.precompute()
+    return split_batch(
+        lambda lo, hi: _crypto.ECC.ecdsa_verify_batch(sigs[lo:hi], digests[lo:hi], points[lo:hi], curve._curve),
+        len(sigs),
+    )
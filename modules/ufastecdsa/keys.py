@@ -3,7 +3,7 @@
 import os
 
 import _crypto
-from ufastecdsa.curve import P256
+from ufastecdsa.curve import Curve, P256
 from ufastecdsa.point import Point
 
 
@@ -33,7 +33,35 @@ def get_public_key(d, curve=P256):
     return Point(Q.x, Q.y, curve=curve)
 
 
+def prepare_public_key(Q, curve=P256, window=None):
+    # for a key that verifies many signatures, ecdsa.verify and verify_batch take it in place of Q
+    return _crypto.ECC.prepare_public_key(Q._point, curve._curve, window)
+
+
+def import_public_key(data):
+    # DER of a SubjectPublicKeyInfo on a named curve
+    Q = _crypto.ECC.public_key_from_der(data)
+    return Point(Q, curve=Curve.from_oid(Q.curve.oid))
+
+
+def import_private_key(data, curve=None):
+    # DER of an ECPrivateKey or PKCS#8 PrivateKeyInfo, curve for a key that names none
+    d, Q, c = _crypto.ECC.private_key_from_der(data, curve._curve if curve is not None else None)
+    if curve is None:
+        curve = Curve.from_oid(c.oid)
+    if Q is None:
+        return d, get_public_key(d, curve)
+    return d, Point(Q, curve=curve)
+
+
 def gen_keypair(curve=P256):
     d = gen_private_key(curve)
     Q = get_public_key(d, curve)
     return d, Q
+
+
+def ecdh(d, peer_public_key, curve=P256, out=None):
+    # peer_public_key is a Point or its SEC1 encoding, the result the x-coordinate in bytes
+    if isinstance(peer_public_key, Point):
+        peer_public_key = peer_public_key.dumps()
+    return _crypto.ECC.ecdh(d, peer_public_key, curve._curve, out)
@@ -12,7 +12,13 @@ class CurveMismatchError(Exception):
 
 
 class Point(object):
-    def __init__(self, x, y, curve=P256):
+    def __init__(self, x, y=None, curve=P256):
+        if y is None:
+            # result of the native operators, kept as is so its coordinates stay pending
+            self._point = x
+            self._curve = curve
+            return
+
         if curve != None:
              x = x % curve.p
              y = y % curve.p
@@ -50,25 +56,22 @@ class Point(object):
     def __add__(self, other):
         if self._point.curve != other._point.curve:
             raise CurveMismatchError(self._point.curve, other._point.curve)
-        a = self._point + other._point
-        return Point(a.x, a.y, curve=self._curve)
+        return Point(self._point + other._point, curve=self._curve)
 
     def __radd__(self, other):
         return self.__add__(other)
 
     def __sub__(self, other):
-        s = self._point - other._point
-        return Point(s.x, s.y, curve=self._curve)
+        return Point(self._point - other._point, curve=self._curve)
 
     def __mul__(self, scalar):
-        m = self._point * scalar
-        return Point(m.x, m.y, curve=self._curve)
+        return Point(self._point * scalar, curve=self._curve)
 
     def __rmul__(self, scalar):
         return self.__mul__(scalar)
 
     def __neg__(self):
-        return -self._point
+        return Point(-self._point, curve=self._curve)
 
     @property
     def x(self):
@@ -82,14 +85,12 @@ class Point(object):
     def curve(self):
         return self._curve
 
-    def dumps(self, use_compression=False):
-        if not use_compression:
-            return (
-                b"\x04"
-                + self._point.x.to_bytes(32, "big")
-                + self._point.y.to_bytes(32, "big")
-            )
-        elif self._point.y % 2 == 0:
-            return b"\x02" + self._point.x.to_bytes(32, "big")
-        else:
-            return b"\x03" + self._point.x.to_bytes(32, "big")
+    def dumps(self, use_compression=False, out=None):
+        return self._point.to_bytes(use_compression, out=out)
+
+    @staticmethod
+    def loads(data, curve=P256):
+        p = _crypto.ECC.point_from_bytes(data, curve._curve)
+        return Point(p.x, p.y, curve=curve)
+
+    from_bytes = loads
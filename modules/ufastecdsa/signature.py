@@ -4,7 +4,12 @@ import _crypto
 
 
 class Signature(object):
-    def __init__(self, r, s):
+    def __init__(self, r, s=None):
+        if s is None:
+            # a native signature, from from_der
+            self._signature = r
+            return
+
         self._r = 0
         self._s = 0
         if isinstance(r, int):
@@ -31,6 +36,13 @@ class Signature(object):
     def s(self):
         return self._signature.s
 
+    def to_der(self, out=None):
+        return self._signature.to_der(out=out)
+
+    @staticmethod
+    def from_der(data):
+        return Signature(_crypto.ECC.signature_from_der(data))
+
     def __str__(self):
         return "<Signature r=0x{:x} s=0x{:x}>".format(
             self._signature.r, self._signature.s
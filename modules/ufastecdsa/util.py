@@ -2,6 +2,9 @@ import hashlib
 import hmac
 import struct
 
+# shared with ufastrsa, re-exported for ufastecdsa.ecdsa
+from ufastrsa.util import split_batch
+
 try:
     int.bit_length(0)
     def get_bit_length(n):
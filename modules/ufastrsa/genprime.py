@@ -4,16 +4,22 @@ try:
     from _crypto import NUMBER as tomsfastmath
 
     pow3_ = tomsfastmath.exptmod
+    pow3_crt_ = tomsfastmath.exptmod_crt
     invmod_ = tomsfastmath.invmod
     generate_prime_ = tomsfastmath.generate_prime
     gcd_ = tomsfastmath.gcd
 
-    def genprime(num=1024, test=25, safe=False):
+    def genprime(num=1024, test=0, safe=False):
         return generate_prime_(num, test, safe)
 
 except ImportError:
     pow3_ = pow
 
+    def pow3_crt_(x, p, q, dp, dq, qinv):
+        m1 = pow(x, dp, p)
+        m2 = pow(x, dq, q)
+        return m2 + q * (qinv * (m1 - m2) % p)
+
     def invmod_(a, b):
         c, d, e, f, g = 1, 0, 0, 1, b
         while b:
@@ -77,6 +83,10 @@ def pow3(x, y, z):
     return pow3_(x, y, z)
 
 
+def pow3_crt(x, p, q, dp, dq, qinv):
+    return pow3_crt_(x, p, q, dp, dq, qinv)
+
+
 def invmod(a, b):
     return invmod_(a, b)
 
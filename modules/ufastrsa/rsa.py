@@ -1,25 +1,49 @@
 from ufastrsa.srandom import rndsrcnz
-from ufastrsa.genprime import genrsa, pow3
+from ufastrsa.genprime import genrsa, pow3, pow3_crt
+from ufastrsa.util import split_batch
+
+try:
+    from _crypto import RSAKey
+except ImportError:
+    RSAKey = None
 
 
 class RSA:
-    def __init__(self, bits, n=None, e=None, d=None):
+    def __init__(self, bits, n=None, e=None, d=None, p=None, q=None, dp=None, dq=None, qinv=None):
         self.bits = bits
         self.bytes = (bits + 7) >> 3
         self.n = n
         self.e = e
         self.d = d
+        self.p = p
+        self.q = q
+        self.dp = dp
+        self.dq = dq
+        self.qinv = qinv
         self.rndsrcnz = rndsrcnz
+        self._key = None
+        if RSAKey is not None and n is not None:
+            # padding and exponentiation done natively, Montgomery constants cached
+            self._key = RSAKey(n, e, d, p, q, dp, dq, qinv)
+
+    def _private(self, x):
+        if self.qinv is not None:
+            return pow3_crt(x, self.p, self.q, self.dp, self.dq, self.qinv)
+        return pow3(x, self.d, self.n)
 
     def pkcs_sign(self, value):
+        if self._key is not None:
+            return self._key.sign(value)
         len_padding = self.bytes - 3 - len(value)
         assert len_padding >= 0, len_padding
         base = int.from_bytes(
             b"\x00\x01" + len_padding * b"\xff" + b"\x00" + value, "big"
         )
-        return int.to_bytes(pow3(base, self.d, self.n), self.bytes, "big")
+        return int.to_bytes(self._private(base), self.bytes, "big")
 
     def pkcs_verify(self, value):
+        if self._key is not None:
+            return self._key.verify(value)
         assert len(value) == self.bytes
         signed = int.to_bytes(
             pow3(int.from_bytes(value, "big"), self.e, self.n), self.bytes, "big"
@@ -29,6 +53,8 @@ class RSA:
         return signed[idx + 1 :]
 
     def pkcs_encrypt(self, value):
+        if self._key is not None:
+            return self._key.encrypt(value)
         len_padding = self.bytes - 3 - len(value)
         assert len_padding >= 0
         base = int.from_bytes(
@@ -37,10 +63,22 @@ class RSA:
         return int.to_bytes(pow3(base, self.e, self.n), self.bytes, "big")
 
     def pkcs_decrypt(self, value):
+        if self._key is not None:
+            return self._key.decrypt(value)
         assert len(value) == self.bytes
         decrypted = int.to_bytes(
-            pow3(int.from_bytes(value, "big"), self.d, self.n), self.bytes, "big"
+            self._private(int.from_bytes(value, "big")), self.bytes, "big"
         )
         idx = decrypted.find(b"\0", 2)
         assert idx != -1 and decrypted[:2] == b"\x00\x02"
         return decrypted[idx + 1 :]
+
+    def pkcs_sign_batch(self, values, dual_core=False):
+        if not dual_core:
+            return [self.pkcs_sign(value) for value in values]
+        return split_batch(lambda lo, hi: [self.pkcs_sign(value) for value in values[lo:hi]], len(values))
+
+    def pkcs_decrypt_batch(self, values, dual_core=False):
+        if not dual_core:
+            return [self.pkcs_decrypt(value) for value in values]
+        return split_batch(lambda lo, hi: [self.pkcs_decrypt(value) for value in values[lo:hi]], len(values))
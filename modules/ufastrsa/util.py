@@ -12,3 +12,34 @@ except:
             n >>= 1
             i += 1
         return i
+
+
+try:
+    import _thread
+except ImportError:
+    _thread = None
+
+
+def split_batch(fn, n):
+    # fn(lo, hi) returns a list for items lo..hi-1, the second half runs on
+    # a _thread worker while this thread does the first one
+    if _thread is None or n < 2:
+        return fn(0, n)
+    half = n // 2
+    done = _thread.allocate_lock()
+    done.acquire()
+    tail = []
+
+    def worker():
+        try:
+            tail.append(fn(half, n))
+        except Exception as e:
+            tail.append(e)
+        done.release()
+
+    _thread.start_new_thread(worker, ())
+    head = fn(0, half)
+    done.acquire()
+    if isinstance(tail[0], Exception):
+        raise tail[0]
+    return head + tail[0]
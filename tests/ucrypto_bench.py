@@ -0,0 +1,110 @@
+import gc
+import json
+import sys
+
+from os import urandom
+from time import ticks_diff, ticks_us
+
+try:
+    from _crypto import ECC, NUMBER as tomsfastmath, RSAKey, ecdsa_sign_eth, ecdsa_verify_eth
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+from ufastrsa.genprime import genrsa
+
+# One JSON object per line, the first describes the build:
+#   {"platform": ..., "ident": ...}
+#   {"name": ..., "ops": ..., "us_per_op": ..., "ops_per_sec": ..., "heap_per_op": ...}
+# heap_per_op is the gc.mem_alloc() growth of a single call with the collector off.
+# Trim the tuples below on slow ports, 4096-bit key generation takes minutes there.
+
+BUDGET_US = 1000000
+RSA_BITS = (1024, 2048, 4096)
+CURVES = ("P192", "P224", "P256", "P384", "P521", "secp256k1", "brainpoolP256r1")
+
+
+def randint(nbytes):
+    return int.from_bytes(urandom(nbytes), "big")
+
+
+def bench(name, fn, min_ops=3):
+    # the first call builds the cached tables and scratch
+    fn()
+
+    gc.collect()
+    gc.disable()
+    mem = gc.mem_alloc()
+    fn()
+    heap = gc.mem_alloc() - mem
+    gc.enable()
+
+    gc.collect()
+    ops = 0
+    start = ticks_us()
+    while True:
+        fn()
+        ops += 1
+        elapsed = ticks_diff(ticks_us(), start)
+        if ops >= min_ops and elapsed >= BUDGET_US:
+            break
+
+    us = elapsed / ops
+    print(
+        json.dumps(
+            {
+                "name": name,
+                "ops": ops,
+                "us_per_op": round(us, 1),
+                "ops_per_sec": round(1000000 / us, 2),
+                "heap_per_op": heap,
+            }
+        )
+    )
+
+
+print(json.dumps({"platform": sys.platform, "ident": tomsfastmath.ident()}))
+
+################################################################################
+
+for bits in (1024, 2048):
+    m = randint(bits // 8) | 1 | (1 << (bits - 1))
+    x = randint(bits // 8) % m
+    e = randint(bits // 8)
+    bench("exptmod_%d" % bits, lambda: tomsfastmath.exptmod(x, e, m))
+    bench("fast_pow_even_%d" % bits, lambda: tomsfastmath.fast_pow(x, e, m - 1))
+    bench("invmod_%d" % bits, lambda: tomsfastmath.invmod(x, m))
+
+for bits in (256, 512, 1024):
+    bench("generate_prime_%d" % bits, lambda: tomsfastmath.generate_prime(bits), min_ops=1)
+
+################################################################################
+
+for name in CURVES:
+    curve = ECC.named_curve(name)
+    nbytes = (curve.q.bit_length() + 7) // 8
+    d = randint(nbytes) % curve.q
+    k = randint(nbytes) % curve.q
+    digest = urandom(min(nbytes, 32))
+    G = curve.G
+    Q = ECC.point_mul(G, d, curve)
+    bench("point_mul_base_%s" % name, lambda: ECC.point_mul(G, k, curve))
+    bench("point_mul_%s" % name, lambda: ECC.point_mul(Q, k, curve))
+    bench("ecdsa_sign_%s" % name, lambda: ECC.ecdsa_sign_digest(digest, d, None, curve))
+    signature = ECC.ecdsa_sign_digest(digest, d, None, curve)
+    bench("ecdsa_verify_%s" % name, lambda: ECC.ecdsa_verify_digest(signature, digest, Q, curve))
+
+    if name == "secp256k1":
+        msg = "".join("%02x" % b for b in digest)
+        bench("ecdsa_sign_eth_%s" % name, lambda: ecdsa_sign_eth(msg, d, k, curve, 1))
+        signature_eth = ecdsa_sign_eth(msg, d, k, curve, 1)
+        bench("ecdsa_verify_eth_%s" % name, lambda: ecdsa_verify_eth(signature_eth, msg, Q, curve))
+
+################################################################################
+
+data = b"a message to sign and encrypt via RSA"
+for bits in RSA_BITS:
+    key = RSAKey(*genrsa(bits, e=65537, with_crt=True)[1:])
+    ciphertext = key.encrypt(data)
+    bench("rsa_sign_%d" % bits, lambda: key.sign(data))
+    bench("rsa_decrypt_%d" % bits, lambda: key.decrypt(ciphertext))
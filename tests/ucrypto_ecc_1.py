@@ -75,3 +75,80 @@ def sig_2():
     return ECC.ecdsa_sign(MSG2, d2, k2, P256)
 signature2 = sig_2()
 print("signature =", hex(signature2.r), hex(signature2.s))
+
+from ubinascii import unhexlify
+
+def sig_3():
+    d2 = 91225253027397101270059260515990221874496108017261222445699397644687913215777
+    k2 = 43266746841974544773532444486781911654986416052841296107072964405748691319461
+    return ECC.ecdsa_sign_digest(unhexlify(MSG2), d2, k2, P256)
+signature3 = sig_3()
+print("signature digest =", signature3.r == signature2.r, signature3.s == signature2.s)
+print("verify digest =", ECC.ecdsa_verify_digest(signature, memoryview(unhexlify(MSG1)), Q, P256))
+bad = ECC.Signature(signature.r, signature.s + 1)
+digests = [unhexlify(MSG1), unhexlify(MSG1), unhexlify(MSG1)]
+print("verify batch =", ECC.ecdsa_verify_batch([signature, bad, signature], digests, [Q, Q, Q], P256))
+print("verify batch all =", ECC.ecdsa_verify_batch([signature, signature], digests[:2], [Q, Q], P256, all=True))
+K = ECC.prepare_public_key(Q, P256, window=6)
+print("prepared =", K.window, K.Q.x == Q.x, ECC.ecdsa_verify_digest(signature, unhexlify(MSG1), K, P256), ECC.ecdsa_verify_digest(bad, unhexlify(MSG1), K, P256))
+print("prepared batch =", ECC.ecdsa_verify_batch([signature, bad, signature], digests, [K, K, Q], P256))
+zero = ECC.Signature(0, 0)
+print("verify zero =", ECC.ecdsa_verify_digest(zero, unhexlify(MSG1), Q, P256), ECC.ecdsa_verify_digest(zero, unhexlify(MSG1), K, P256), ECC.ecdsa_verify_digest(ECC.Signature(signature.r, P256.q), unhexlify(MSG1), Q, P256))
+der = signature.to_der()
+print("der =", der[0] == 0x30, ECC.signature_from_der(der).r == signature.r, ECC.signature_from_der(memoryview(der)).s == signature.s)
+spki = b"\x30\x59\x30\x13\x06\x07\x2a\x86\x48\xce\x3d\x02\x01\x06\x08\x2a\x86\x48\xce\x3d\x03\x01\x07\x03\x42\x00" + Q.to_bytes()
+print("public_key_from_der =", ECC.public_key_from_der(spki) == Q, ECC.curve_equal(ECC.public_key_from_der(spki).curve, P256))
+
+import hashlib
+d_rfc = 0xC9AFA9D845BA75166B5C215767B1D6934E50C3DB36E89B127B8A622B120F6721
+signature_rfc = ECC.ecdsa_sign_digest(hashlib.sha256(b"sample").digest(), d_rfc, None, P256)
+# RFC 6979 A.2.5, P-256 with SHA-256, message "sample"
+assert signature_rfc.r == 0xEFD48B2AACB6A8FD1140DD9CD45E81D69D2C877B56AAF991C34D0EA84EAF3716
+assert signature_rfc.s == 0xF7CB1C942D657C41D436C7A1B6E29F65F3E900DBB9AFF4064DC4AB2F843ACDA8
+print("rfc6979 =", hex(signature_rfc.r), hex(signature_rfc.s))
+
+from _crypto import ecdsa_sign_eth, ecdsa_verify_eth
+SECP256K1 = ECC.Curve(
+    0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f,
+    0x0,
+    0x7,
+    0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141,
+    0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798,
+    0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8,
+    name='secp256k1',
+    oid="2b8104000a"
+)
+d_eth = 0x4c0883a69102937d6231471b5dbb6204fe5129617082792ae468d01a3f362318
+k_eth = 0x2e0d9c3f0a1b0d8a6f3cc1a9a1f0b2b6c6c9b5e0d1e2f3a4b5c6d7e8f9a0b1c2
+signature_eth = ecdsa_sign_eth(MSG1, d_eth, k_eth, SECP256K1, 1)
+Q_eth = ECC.ecdsa_recover(signature_eth, MSG1, SECP256K1)
+Q_eth_ref = ECC.point_mul(SECP256K1.G, d_eth, SECP256K1)
+print("recover =", ECC.point_equal(Q_eth, Q_eth_ref), ecdsa_verify_eth(signature_eth, MSG1, Q_eth, SECP256K1))
+
+Q_bytes = Q.to_bytes()
+Q_compressed = Q.to_bytes(True)
+from ubinascii import hexlify
+print("to_bytes =", hexlify(Q_bytes), hexlify(Q_compressed))
+out = bytearray(len(Q_compressed))
+print("to_bytes out =", Q.to_bytes(True, out=out), out == Q_compressed)
+print("from_bytes =", ECC.point_equal(ECC.point_from_bytes(Q_bytes, P256), Q), ECC.point_equal(ECC.point_from_bytes(memoryview(out), P256), Q))
+Q_peer = ECC.point_mul(P256.G, d_eth, P256)
+shared = ECC.ecdh(d_rfc, Q_peer.to_bytes(), P256)
+secret = bytearray(32)
+print("ecdh =", shared == ECC.point_mul(Q_peer, d_rfc, P256).x.to_bytes(32, "big"), ECC.ecdh(d_rfc, Q_peer.to_bytes(True), P256, secret), secret == shared)
+print("named_curve =", ECC.named_curve("P256").q == P256.q, ECC.curve_equal(ECC.named_curve(b"\x2B\x81\x04\x00\x0A"), SECP256K1), ECC.named_curve("secp256r1").name)
+lazy = p3 * 5 + p4 - p4 * 2
+print("lazy =", lazy == ECC.point_add(ECC.point_mul(p3, 5, P256), ECC.point_mul(p4, -1, P256), P256), -(-p3) == p3, (lazy - lazy).x)
+job = ECC.point_mul_start(p3, 0xC0FFEE, P256)
+steps = 1
+while not job.step(8):
+    steps += 1
+print("point_mul_start =", job.result() == ECC.point_mul(p3, 0xC0FFEE, P256), steps, job.step())
+c = p3.curve
+c.b = 7
+print("shared curve =", p3.curve.b == P256.b, c.b, ECC.point_in_curve(p3, P256), ECC.point_in_curve(p3, c))
+c.p = 65
+try:
+    ECC.point_from_bytes(b"\x02\x03", c)
+except ValueError as exc:
+    print("sqrt composite p =", exc)
@@ -30,6 +30,17 @@ P256 = ECC.Curve(
     oid="2a8648ce3d030107" # b'\x2A\x86\x48\xCE\x3D\x03\x01\x07'
 )
 
+BP256 = ECC.Curve(
+    0xa9fb57dba1eea9bc3e660a909d838d726e3bf623d52620282013481d1f6e5377,
+    0x7d5a0975fc2c3057eef67530417affe7fb8055c126dc5c6ce94a4b44f330b5d9,
+    0x26dc5c6ce94a4b44f330b5d9bbd77cbf958416295cf7e1ce6bccdc18ff8c07b6,
+    0xa9fb57dba1eea9bc3e660a909d838d718c397aa3b561a6f7901e0e82974856a7,
+    0x8bd2aeb9cb7e57cb2c4b482ffc81b7afb9de27e1e3bd23c23a4453bd9ace3262,
+    0x547ef835c3dac4fd97f8461a14611dc9c27745132ded8e545c1d54c72f046997,
+    name='brainpoolP256r1',
+    oid="2b2403030208010107"
+)
+
 def gen_keypair(curve):
     private_key = gen_private_key(curve)
     public_key = get_public_key(private_key, curve)
@@ -77,6 +88,8 @@ def test():
     public_key = get_public_key(private_key, P256)
     print("PRV KEY: {:x}".format(private_key))
     print("PUB KEY: 04{:x}{:x}".format(public_key.x, public_key.y))
+    public_key = get_public_key(private_key, BP256)
+    print("BP256 PUB KEY: 04{:x}{:x}".format(public_key.x, public_key.y))
 
 
 if __name__ == "__main__":
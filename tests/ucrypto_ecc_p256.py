@@ -48,3 +48,14 @@ print(f"S+S   = ({R.x:x}, {R.y:x})")
 
 R = S - S
 print(f"S-S   = ({R.x:x}, {R.y:x})")
+
+P256.precompute()
+R = d * P256.G
+print(f"dG    = ({R.x:x}, {R.y:x})")
+
+R = ECC.point_mul(S, d, P256)
+print(f"dS    = ({R.x:x}, {R.y:x})")
+print("dS ct =", ECC.point_mul(S, d, P256, ct=True) == R)
+
+R = ECC.multi_mul([(S, d), (T, e)], P256)
+print(f"dS+eT = ({R.x:x}, {R.y:x})")
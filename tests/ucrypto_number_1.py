@@ -108,3 +108,22 @@ end = ticks_ms()
 print("gcd", ticks_diff(end, start))
 
 ################################################################################
+
+print(gcd(12, -18), gcd(-(1 << 100), 1 << 70) == 1 << 70)
+print(invmod(3, 7), invmod(-3, 7), invmod(1 << 200, (1 << 127) - 1) * (1 << 200) % ((1 << 127) - 1) == 1)
+print("exptmod_crt =", tomsfastmath.exptmod_crt(1234567, 61, 53, 2753 % 60, 2753 % 52, 38) == pow(1234567, 2753, 3233))
+print("fast_pow even =", tomsfastmath.fast_pow(3, 1 << 100, 10 ** 30) == pow(3, 1 << 100, 10 ** 30), tomsfastmath.exptmod(7, 65537, 1 << 64, True) == pow(7, 65537, 1 << 64))
+print("prime_search =", tomsfastmath.prime_search(1 << 64, 1000) == (1 << 64) + 13, tomsfastmath.prime_search((1 << 64) + 14, 40), tomsfastmath.prime_search(5000, 100, safe=True))
+
+job = tomsfastmath.exptmod_start(3, 1 << 100, (1 << 127) - 1)
+while not job.step(16):
+    pass
+print("exptmod_start =", job.result() == pow(3, 1 << 100, (1 << 127) - 1))
+
+import _crypto
+
+if hasattr(_crypto, "stats"):
+    _crypto.stats_reset()
+    tomsfastmath.exptmod(3, 65537, (1 << 127) - 1)
+    stats = _crypto.stats()["number"]
+    print("stats =", stats["calls"], stats["fp_exptmod"], stats["alloc_bytes"] > 0)
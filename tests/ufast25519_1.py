@@ -0,0 +1,36 @@
+from binascii import hexlify, unhexlify
+
+try:
+    from ufast25519 import ed25519, x25519
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+def main():
+    # RFC 7748 5.2
+    k = unhexlify("a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4")
+    u = unhexlify("e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c")
+    print(hexlify(x25519.shared_secret(k, u)))
+
+    a, A = x25519.gen_keypair()
+    b, B = x25519.gen_keypair()
+    print(x25519.shared_secret(a, B) == x25519.shared_secret(b, A))
+
+    # RFC 8032 7.1 TEST 1
+    seed = unhexlify("9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60")
+    public_key = ed25519.get_public_key(seed)
+    print(hexlify(public_key))
+    signature = ed25519.sign(b"", seed)
+    print(hexlify(signature))
+    print(ed25519.verify(signature, b"", public_key))
+
+    seed, public_key = ed25519.gen_keypair()
+    m = "a message to sign via Ed25519"
+    signature = ed25519.sign(m, seed)
+    print(ed25519.verify(signature, m, public_key))
+    print(ed25519.verify(signature, m + "!", public_key))
+
+
+if __name__ == "__main__":
+    main()
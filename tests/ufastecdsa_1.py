@@ -45,6 +45,15 @@ def main():
     print(ticks_diff(end, start))
     print(verified)
 
+    if hasattr(ecdsa, "verify_batch"):
+        messages = [m, m + "!", m]
+        signatures = [(r, s), (r, s), (r, s)]
+        start = ticks_ms()
+        verified = ecdsa.verify_batch(signatures, messages, [public_key] * 3, curve=c, dual_core=True)
+        end = ticks_ms()
+        print(ticks_diff(end, start))
+        print(verified)
+
 
 if __name__ == "__main__":
     main()
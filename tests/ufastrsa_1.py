@@ -26,6 +26,36 @@ def main():
         print(ticks_diff(end, start))
         print("pkcs_decrypt OK")
 
+    start = ticks_ms()
+    r = RSA(*genrsa(bits, e=65537, with_crt=True))
+    end = ticks_ms()
+    print(ticks_diff(end, start))
+    print("RSA CRT OK")
+    start = ticks_ms()
+    assert r.pkcs_verify(r.pkcs_sign(data)) == data
+    end = ticks_ms()
+    print(ticks_diff(end, start))
+    print("pkcs_verify CRT OK")
+    assert r.pkcs_decrypt(r.pkcs_encrypt(data)) == data
+    print("pkcs_decrypt CRT OK")
+
+    from _crypto import RSAKey
+    k = RSAKey(r.n, r.e, d=r.d)
+    print(k)
+    assert k.verify(r.pkcs_sign(data)) == data
+    assert r.pkcs_decrypt(k.encrypt(data)) == data
+    try:
+        RSAKey(None, None)
+    except TypeError:
+        pass
+    else:
+        raise AssertionError("RSAKey(None, None)")
+    print("RSAKey OK")
+
+    signatures = r.pkcs_sign_batch([data, data[::-1]], dual_core=True)
+    assert [r.pkcs_verify(signature) for signature in signatures] == [data, data[::-1]]
+    print("pkcs_sign_batch OK")
+
 
 if __name__ == "__main__":
     main()
@@ -1558,6 +1558,9 @@ const char *fp_ident(void)
 #ifdef TFM_ARM
            " TFM_ARM "
 #endif
+#ifdef TFM_ARM_UMAAL
+           " TFM_ARM_UMAAL "
+#endif
 #ifdef TFM_PPC32
            " TFM_PPC32 "
 #endif
@@ -2129,7 +2132,48 @@ void fp_montgomery_calc_normalization(fp_int *a, fp_int *b)
 #define LOOP_START \
   mu = c[x] * mp
 
-#ifdef __thumb__
+#if defined(TFM_ARM_UMAAL)
+
+/* UMAAL gives hi:lo = mu * m[i] + c[i] + cy in one instruction, lo is c[i] and hi the next cy */
+#define UMAALMUL(i)                            \
+  do                                           \
+  {                                            \
+    fp_digit _t = _c[i];                       \
+    __asm__(                                   \
+        " UMAAL  %0,%1,%2,%3      \n\t"        \
+        : "+r"(_t), "+r"(cy)                   \
+        : "r"(mu), "r"(tmpm[i]));              \
+    _c[i] = _t;                                \
+  } while (0)
+
+#define INNERMUL \
+  do             \
+  {              \
+    UMAALMUL(0); \
+    ++tmpm;      \
+  } while (0)
+
+#define INNERMUL8 \
+  do              \
+  {               \
+    UMAALMUL(0);  \
+    UMAALMUL(1);  \
+    UMAALMUL(2);  \
+    UMAALMUL(3);  \
+    UMAALMUL(4);  \
+    UMAALMUL(5);  \
+    UMAALMUL(6);  \
+    UMAALMUL(7);  \
+  } while (0)
+
+#define PROPCARRY             \
+  do                          \
+  {                           \
+    fp_digit t = _c[0] += cy; \
+    cy = (t < cy);            \
+  } while (0)
+
+#elif defined(__thumb__)
 
 #define INNERMUL                                   \
   __asm__(                                         \
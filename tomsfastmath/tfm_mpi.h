@@ -102,19 +102,24 @@
 
 #define USE_MEMSET
 
-#define TFM_NO_ASM
-
 // #define TFM_ECC192
 // #define TFM_ECC224
-// #define TFM_ECC256
+#define TFM_ECC256
 // #define TFM_ECC384
 // #define TFM_ECC512
 // #define TFM_RSA512
 // #define TFM_RSA1024
 // #define TFM_RSA2048
 
-#if defined(__thumb2__) || defined(__thumb__) || defined(__arm__)
+/* The ARM kernels need the long multiplies UMULL / UMLAL, ARM state or Thumb-2
+ * (Cortex-M3 and up, not ARMv6-M / ARMv8-M Baseline). Everything else (Xtensa,
+ * RISC-V, Cortex-M0+, the unix hosts) builds the ISO C code, define TFM_NO_ASM
+ * to build it on ARM too.
+ */
+#if !defined(TFM_NO_ASM) && ((defined(__arm__) && !defined(__thumb__)) || defined(__thumb2__))
 #define TFM_ARM
+#elif !defined(TFM_NO_ASM)
+#define TFM_NO_ASM
 #endif
 
 #endif
@@ -224,6 +229,17 @@
 #undef TFM_ASM
 #endif
 
+/* UMAAL in the Montgomery reduction, ARMv6 and up in ARM state, the DSP extension (ARMv7E-M,
+ * ARMv8-M Mainline) in Thumb-2. Opt-in with -DTFM_ARM_UMAAL: the kernel has not been assembled
+ * and checked against the C path on a target yet.
+ */
+#if defined(TFM_ARM_UMAAL) && !defined(TFM_ARM)
+#undef TFM_ARM_UMAAL
+#endif
+#if defined(TFM_ARM_UMAAL) && !(defined(__ARM_ARCH) && __ARM_ARCH >= 6 && (defined(__ARM_FEATURE_DSP) || !defined(__thumb__)))
+#error TFM_ARM_UMAAL needs UMAAL, ARMv6 ARM state or Thumb-2 with the DSP extension
+#endif
+
 /* ECC helpers */
 #ifdef TFM_ECC192
 #ifdef FP_64BIT